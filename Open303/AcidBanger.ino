@@ -55,21 +55,22 @@
 #define MEM4_BUTTON             23
 #define MEM5_BUTTON             23
 
-#define send_midi_start() {}
-#define send_midi_stop()  {}
-#define send_midi_tick() {}
  
 
 #define NUM_RAMPS 6           // simultaneous knob rotatings
 #ifndef NO_PSRAM
   #define NUM_SYNTH_CCS 12    // how many synth CC params do we have to play
-  #define VOL_SYNTH1     100
 #else
   #define NUM_SYNTH_CCS 11    // how many synth CC params do we have to play
-  #define VOL_SYNTH1     100
-
 #endif
 
+// the controller values the jukebox starts with and the ramps return to - they give the defaults
+// of the Open303 (see the curves in rosic_Open303CCMap.ino), such that it sounds as without them:
+#define VOL_SYNTH1     102    // ~ -12 dB (0 mutes)
+#define PAN_SYNTH1     64     // center
+#define DECAY_SYNTH1   89     // ~ 1 s
+#define ATTACK_SYNTH1  64     // ~ 3 ms
+
 
 struct sSynthCCs {
   uint8_t cc_number;
@@ -85,12 +86,12 @@ sSynthCCs synth1_ramps[NUM_SYNTH_CCS] = {
 #ifndef NO_PSRAM
   {CC_303_REVERB_SEND, 0,              5,    2,  127,  true},
 #endif
-  {CC_303_PAN,        0,              47,   0,  127,  true},
+  {CC_303_PAN,        0,     PAN_SYNTH1,   0,  127,  true},
   {CC_303_WAVEFORM,   0,              0,    0,  64,   true}, // SQUARE
   {CC_303_RESO,       CC_303_CUTOFF,  64,   40, 125,  true},
   {CC_303_CUTOFF,     CC_303_RESO,    30,   0,  127,  true},
-  {CC_303_DECAY,      0,              20,   15, 64,  true},
-  {CC_303_ATTACK,     0,              1,    3,  20,   true},
+  {CC_303_DECAY,      0,   DECAY_SYNTH1,   30, 110,  true}, // ~ 340...1470 ms
+  {CC_303_ATTACK,     0,  ATTACK_SYNTH1,   20, 90,   true}, // ~ 0.6...7.6 ms
   {CC_303_ENVMOD_LVL, 0,              100,  0,  127,  false},
   {CC_303_ACCENT_LVL, 0,              64,   25, 70,  false},
   {CC_303_DELAY_SEND, 0,              0,    64, 127,  false},
@@ -182,14 +183,31 @@ struct Memory {
 static Memory memories[NumMemories];
 static byte cur_memory;
 
+// All the randomness of the jukebox comes from this generator. Define JUKEBOX_SEED to get the same
+// endless tune on every run, otherwise it is seeded from the hardware RNG and fed with entropy.
+static rosic::AcidGenerator generator;
+
 
 #define is_pressed(x) (buttons[x].history == 0)
 #define just_pressed(x) (buttons[x].history == 0x80)
 
 static struct Button buttons[ButLast];
 static byte button_divider;
-static unsigned long now;
-static unsigned long last_midi_tick;
+
+enum { JukeboxNoRequest = 0, JukeboxStart, JukeboxStop };
+static volatile byte jukebox_request = JukeboxNoRequest; // play button, executed by the jukebox task
+
+// The memories and the generator belong to the jukebox task, so the other buttons don't touch them
+// from loop() either - they queue their action, which the jukebox task runs before its next step
+enum { UiSwitchMemory, UiCopyMemory, UiGenerateMelody, UiGenerateNoteSet, UiPrintMemory };
+struct UiRequest {
+  byte action;
+  byte arg1; // the memory (to switch to, to copy from) or the voice
+  byte arg2; // the memory to copy to
+};
+#define UI_REQUEST_QUEUE_LEN 8
+static QueueHandle_t ui_request_queue = NULL;
+static volatile uint16_t jukebox_entropy = 0; // collected in loop(), mixed in by the jukebox task
 
 static const byte button_pins[ButLast] = {
   GEN_SYNTH1_BUTTON_PIN,
@@ -203,24 +221,49 @@ static const byte button_pins[ButLast] = {
 };
 
 
-static void send_midi_noteon(byte chan, byte note, byte vol) {
-#ifdef MIDI_VIA_SERIAL  
-  MIDI.sendNoteOn(note, vol, chan);
-#endif
-#ifdef MIDI_VIA_SERIAL2  
-  MIDI2.sendNoteOn(note, vol, chan);
+static uint32_t jukebox_frame; // audio frame at which the events being generated are due
+
+#if defined MIDI_VIA_SERIAL || defined MIDI_VIA_SERIAL2
+// The notes and clock ticks are generated a step ahead, so the copies for MIDI out wait here until
+// they are due, then they go into the output buffer (see midi_out.ino)
+#define MIDI_OUT_DELAY_LEN 128
+static SynthEvent midi_out_delay[MIDI_OUT_DELAY_LEN];
+static byte midi_out_head = 0, midi_out_tail = 0;
+
+static void delay_midi_out(byte status, byte data1, byte data2) {
+  byte next = (midi_out_head + 1) % MIDI_OUT_DELAY_LEN;
+  if (next == midi_out_tail) return; // full, drop it
+  midi_out_delay[midi_out_head] = { jukebox_frame, status, data1, data2 };
+  midi_out_head = next;
+}
+
+static void flush_midi_out(uint32_t frame) {
+  bool sent = false;
+  while (midi_out_tail != midi_out_head && (int32_t)(midi_out_delay[midi_out_tail].frame - frame) <= 0) {
+    SynthEvent *ev = &midi_out_delay[midi_out_tail];
+    midi_out_send(ev->status, ev->data1, ev->data2);
+    midi_out_tail = (midi_out_tail + 1) % MIDI_OUT_DELAY_LEN;
+    sent = true;
+  }
+  if (sent) midi_out_kick();
+}
+#else
+#define delay_midi_out(...) {}
+#define flush_midi_out(...) {}
 #endif
-  handleNoteOn( chan, note, vol) ;
+
+#define send_midi_start() delay_midi_out(0xFA, 0, 0)
+#define send_midi_stop()  delay_midi_out(0xFC, 0, 0)
+#define send_midi_tick()  delay_midi_out(0xF8, 0, 0)
+
+static void send_midi_noteon(byte chan, byte note, byte vol) {
+  delay_midi_out(0x90 | (chan - 1), note, vol);
+  push_synth_event(JUKEBOX_EVENTS, jukebox_frame, 0x90 | (chan - 1), note, vol);
 }
 
 static void send_midi_noteoff(byte chan, byte note) {
-#ifdef MIDI_VIA_SERIAL  
-  MIDI.sendNoteOn(note, 0, chan);
-#endif
-#ifdef MIDI_VIA_SERIAL2  
-  MIDI2.sendNoteOn(note, 0, chan);
-#endif
-  handleNoteOff( chan, note, 0) ;
+  delay_midi_out(0x90 | (chan - 1), note, 0);
+  push_synth_event(JUKEBOX_EVENTS, jukebox_frame, 0x80 | (chan - 1), note, 0);
 }
 
 static void init_midi() {
@@ -230,53 +273,41 @@ static void init_midi() {
   for (int i = 0; i < ButLast; i++) {
     init_button(&buttons[i], button_pins[i], i + 1 );
   }
+#ifdef JUKEBOX_SEED
+  generator.setState(JUKEBOX_SEED);
+#else
+  generator.setState(random(1, 0xffff));
+#endif
   init_instruments();
   init_patterns();
+  ui_request_queue = xQueueCreate(UI_REQUEST_QUEUE_LEN, sizeof(UiRequest));
 #ifdef JUKEBOX_PLAY_ON_START
-  do_midi_start();
+  jukebox_request = JukeboxStart;
 #endif
+  xTaskCreatePinnedToCore( jukebox_task, "JukeboxTask", 8000, NULL, 2, &JukeboxTask, 1 );
 }
 static void send_midi_control(byte chan, byte cc_number, byte cc_value) {
   //MIDI.sendControlChange (  cc_number,  cc_value,  chan);
-  handleCC( chan,  cc_number,  cc_value);
+  push_synth_event(JUKEBOX_EVENTS, jukebox_frame, 0xB0 | (chan - 1), cc_number, cc_value);
 }
 
 /*
    Pseudo-random generator with restorable state
 */
 
-static inline uint16_t lfsr16_next(uint16_t x)
-{
-  uint16_t y = x >> 1;
-  if (x & 1)
-    y ^= 0xb400;
-  return y;
-}
-
-union seeder_t {
-  double dseed= 0.9876543021203450678091203456/random(3,0xffff);
-  struct{
-    uint8_t x;
-    uint16_t useed ;
-
-  };
-} seeder ;
-//static uint16_t myRandomState = 0x1234; 
-static uint16_t myRandomState = seeder.useed ;
-
-static uint16_t myRandomAddEntropy(uint16_t data) {
-  myRandomState = lfsr16_next((myRandomState << 1) ^ data);
-  return myRandomState;
+// collects entropy from loop(), the jukebox task mixes it into the generator before its next step
+static void myRandomAddEntropy(uint16_t data) {
+#ifndef JUKEBOX_SEED
+  __atomic_fetch_xor(&jukebox_entropy, data, __ATOMIC_RELAXED);
+#endif
 }
 
 static uint16_t myRandomRaw() {
-  myRandomState = lfsr16_next(myRandomState);
-  return myRandomState;
+  return generator.getRaw();
 }
 
 static inline uint16_t myRandom(uint16_t max) {
-  if (max==0) return 0;
-  return myRandomRaw() % max;
+  return generator.getInt(max);
 }
 
 /*
@@ -421,68 +452,14 @@ void sequencer_step(byte step) {
    created by Vitling (David Whiting) i.am@thewit.ch
 */
 
-#define NOTE_LIST(x...) (int8_t[]) { x, -1 }
-#define ARRAY_SIZE(x) (sizeof(x) / sizeof((x)[0]))
-
-static const int8_t *const offset_choices[] = {
-  NOTE_LIST(0, 0, 12, 24, 27),
-  NOTE_LIST(0, 0, 0, 12, 10, 19, 26, 27),
-  NOTE_LIST(0, 0, 0, 1, 7, 10, 12, 13),
-  NOTE_LIST(0),
-  NOTE_LIST(0, 0, 0, 0, 0, 0, 1, 13, 25),
-  NOTE_LIST(0, 0, 0, 12, 24),
-  NOTE_LIST(0, 0, 12, 12, 18, 24, 24),
-  NOTE_LIST(0, 0, 7, 14, 24, 24),
-  NOTE_LIST(0, 0, 12, 14, 15, 19),
-  NOTE_LIST(0, 0, 0, 12, 12, 13, 16, 19, 22, 24, 25),
-  NOTE_LIST(0, 0, 0, 7, 12, 15, 17, 20, 24),
-};
-
+// The note sets and melodies come from rosic::AcidGenerator
 static byte generate_note_set(uint8_t *note_set) {
-  // Random root note
-  byte root = myRandom(15) + 28;
-
-  // Random note set
-  byte set = myRandom(ARRAY_SIZE(offset_choices));
-
-  // Copy notes from note set and offset them by "root note"
-  int i;
-  for (i = 0; i < MaxNoteSet; i++) {
-    int8_t note = offset_choices[set][i];
-    if (note < 0)
-      break;
-    *note_set++ = root + note;
-  }
-
-  return i;
+  return generator.generateNoteSet(note_set);
 }
 
 // Flip a coin
 static byte flip(byte percent_chance) {
-  return myRandom(100) < percent_chance;
-}
-
-static void generate_melody(uint8_t *note_set, byte note_set_len,
-                            uint8_t *pattern, byte pattern_len,
-                            uint16_t *accent, uint16_t *glide) {
-
-  uint8_t density = 255;
-
-  *accent = 0;
-  *glide = 0;
-  for (int i = 0; i < pattern_len; i++) {
-//    uint8_t chance = ((uint16_t) density * (i % 4 == 0 ?  60 : (i % 3 == 0 ?  50 : (i % 2 == 0 ?  30 : 10)))) >> 8;
-    uint8_t chance = ((uint16_t) density * (i % 4 == 0 ?  90 : (i % 3 == 0 ?  80 : (i % 2 == 0 ?  50 : 10)))) >> 8;
-    if (flip(chance)) {
-      pattern[i] = note_set[myRandom(note_set_len)];
-      if (flip(30))
-        *accent |= 1u << i;
-      if (flip(70))
-        *glide |= 1u << i;
-    } else {
-      pattern[i] = 0;
-    }
-  }
+  return generator.flip(percent_chance);
 }
 
 /*
@@ -727,18 +704,16 @@ static void generate_drums(byte *kick, byte *snare, byte *oh, byte *ch, byte *pe
 void mem_generate_melody(byte mem, byte voice) {
   Memory *m = &memories[mem];
   Pattern *p = &m->patterns[voice];
-  // Temporarily change random seed to a pre-defined state so that we can generate
+  // The melody only depends on the seed stored in the memory, so that we can generate
   // identical melody.
-  uint16_t random_state = myRandomState;
-  myRandomState = (m->random_seed << 1) ^ voice;
+  rosic::AcidLine line;
 #ifdef DEBUG_JUKEBOX_
-  DEBF("generating %d/%d with seed %u \r\n", mem, voice, myRandomState);
+  DEBF("generating %d/%d with seed %u \r\n", mem, voice, m->random_seed);
 #endif
-  generate_melody(
-    m->note_set, m->num_notes_in_set,
-    p->notes, sizeof(p->notes),
-    &p->accent, &p->glide);
-  myRandomState = random_state;
+  generator.generateMelody(m->note_set, m->num_notes_in_set, m->random_seed, voice, &line);
+  memcpy(p->notes, line.notes, sizeof(p->notes));
+  p->accent = line.accent;
+  p->glide = line.glide;
 }
 
 void mem_generate_melody_and_seed(byte mem, byte voice) {
@@ -775,14 +750,28 @@ void mem_generate_all(byte mem) {
     mem_generate_melody_and_seed(mem, i);
 }
 
+// The debug log takes at most 8 arguments per message and holds 64 messages until the log task
+// prints them, so a memory is printed 8 values per message: 3 messages per drum pattern, 6 per
+// synth pattern and at most 4 for the header and the note set - 34 messages in all.
+static char step_flags(struct Pattern *p, int i) {
+  bool accent = p->accent & (1u << i), glide = p->glide & (1u << i);
+  return accent ? (glide ? '*' : 'A') : (glide ? '~' : ' ');
+}
+
 void print_pattern(struct Pattern *p, byte is_drum) {
 #ifdef DEBUG_JUKEBOX
-  for (int i = 0; i < PatternLength; i++)
-    DEBF("%3d ", p->notes[i]);
-
+  for (int i = 0; i < PatternLength; i += 8) {
+    const byte *n = &p->notes[i];
+    DEBF("%3d %3d %3d %3d %3d %3d %3d %3d ", n[0], n[1], n[2], n[3], n[4], n[5], n[6], n[7]);
+  }
+  DEBF("\r\n");
   if (!is_drum) {
-    for (int i = 0; i < PatternLength; i++)
-      DEBF(" %c%c \r\n", (p->accent & (1u << i)) ? 'A' : ' ', (p->glide & (1u << i)) ? '~' : ' ');
+    // A accent, ~ glide, * both
+    for (int i = 0; i < PatternLength; i += 8)
+      DEBF("  %c   %c   %c   %c   %c   %c   %c   %c ", step_flags(p, i), step_flags(p, i + 1),
+           step_flags(p, i + 2), step_flags(p, i + 3), step_flags(p, i + 4), step_flags(p, i + 5),
+           step_flags(p, i + 6), step_flags(p, i + 7));
+    DEBF("\r\n");
   }
 #endif
 }
@@ -790,12 +779,18 @@ void print_pattern(struct Pattern *p, byte is_drum) {
 void print_memory(byte mem) {
   Memory *m = &memories[mem];
 #ifdef DEBUG_JUKEBOX
-  DEBF("--- memory %d ---", mem);
-  DEBF("noteset[%d]:", m->num_notes_in_set);
-#endif
-  for (int i = 0; i < m->num_notes_in_set; i++)
-#ifdef DEBUG_JUKEBOX
-    DEBF(" %d", m->note_set[i]);
+  // the formats for 1..8 notes of the note set
+  static const char *const note_formats[8] = {
+    " %d", " %d %d", " %d %d %d", " %d %d %d %d", " %d %d %d %d %d", " %d %d %d %d %d %d",
+    " %d %d %d %d %d %d %d", " %d %d %d %d %d %d %d %d"
+  };
+  DEBF("--- memory %d ---\r\nnoteset[%d]:", mem, m->num_notes_in_set);
+  for (int i = 0; i < m->num_notes_in_set; i += 8) {
+    const byte *n = &m->note_set[i];
+    int count = m->num_notes_in_set - i;
+    DEBF(note_formats[(count < 8 ? count : 8) - 1], n[0], n[1], n[2], n[3], n[4], n[5], n[6], n[7]);
+  }
+  DEBF("\r\n");
 #endif
   for (int i = 0; i < NumInstruments; i++)
     print_pattern(&m->patterns[i], instruments[i].is_drum);
@@ -810,15 +805,17 @@ void init_patterns() {
    MIDI clock
 */
 
-#define MIDI_TICKS_PER_16TH 1
+#define MIDI_TICKS_PER_16TH 6 // 24 PPQN, sent as MIDI clock
 
 static byte midi_playing, midi_tick, midi_step;
-const float tick_coef = 1000ul * 15 / MIDI_TICKS_PER_16TH;
-static unsigned long midi_tick_ms = tick_coef / bpm;
+const float tick_coef = (float)SAMPLE_RATE * 15.0f / MIDI_TICKS_PER_16TH;
+static float midi_tick_frames = tick_coef / bpm; // length of a tick in audio frames
+static uint32_t next_tick_frame;                  // audio frame of the next tick, integer part
+static float next_tick_frac;                      // ...and fractional part, so the tempo is exact
 
 inline void set_bpm(float newBpm) {
   bpm = newBpm;
-  midi_tick_ms = tick_coef / newBpm;
+  midi_tick_frames = tick_coef / newBpm;
 }
 
 static void decide_on_break() {
@@ -908,12 +905,12 @@ static void do_midi_start() {
   midi_playing = 1;
   midi_tick = MIDI_TICKS_PER_16TH - 1;
   midi_step = -1;
-  send_midi_control(SYNTH1_MIDI_CHAN, 10, 10);
+  send_midi_control(SYNTH1_MIDI_CHAN, 10, PAN_SYNTH1);
   send_midi_control(SYNTH1_MIDI_CHAN, 74, 64);
   send_midi_control(SYNTH1_MIDI_CHAN, 70, 127); // saw
   send_midi_control(SYNTH1_MIDI_CHAN, 71, 100);
-  send_midi_control(SYNTH1_MIDI_CHAN, 72, 30);
-  send_midi_control(SYNTH1_MIDI_CHAN, 73, 3);
+  send_midi_control(SYNTH1_MIDI_CHAN, 72, DECAY_SYNTH1);
+  send_midi_control(SYNTH1_MIDI_CHAN, 73, ATTACK_SYNTH1);
   send_midi_control(SYNTH1_MIDI_CHAN, 91, 5);  // reverb send
   send_midi_control(SYNTH1_MIDI_CHAN, 7, VOL_SYNTH1);
   send_midi_control(SYNTH1_MIDI_CHAN, 94, 3);  // post-overdrive
@@ -955,11 +952,11 @@ static void check_midi_ramps(boolean force_restart) {
         if (midiRamps[i].need_reset) {
           send_midi_control(midiRamps[i].chan, midiRamps[i].cc_number, midiRamps[i].def_val);
         }
-        uint8_t chanSeed = random(0, 100); // probability
+        uint8_t chanSeed = generator.getInt(0, 100); // probability
         uint8_t ccSeed;
         if (chanSeed < 45) {
           do {
-            ccSeed = random(0, NUM_SYNTH_CCS);
+            ccSeed = generator.getInt(0, NUM_SYNTH_CCS);
           } while (ramp_cc_repeated(synth1_ramps[ccSeed].cc_number, SYNTH1_MIDI_CHAN));
           midiRamps[i].chan = SYNTH1_MIDI_CHAN;
           midiRamps[i].cc_number = synth1_ramps[ccSeed].cc_number;
@@ -968,11 +965,11 @@ static void check_midi_ramps(boolean force_restart) {
           midiRamps[i].def_val = synth1_ramps[ccSeed].cc_default_value;
           midiRamps[i].need_reset = synth1_ramps[ccSeed].reset_after_use;
           midiRamps[i].value = synth1_ramps[ccSeed].cc_default_value;
-          midiRamps[i].stepPer16th = (float)(random(-100, 100)) * 0.05f ;
+          midiRamps[i].stepPer16th = (float)(generator.getInt(-100, 100)) * 0.05f ;
           if (abs(midiRamps[i].stepPer16th) < 0.5 ) {
             midiRamps[i].stepPer16th = 0.5;
           }
-          midiRamps[i].leftBars = random(1, 3) * 2;
+          midiRamps[i].leftBars = generator.getInt(1, 3) * 2;
         } 
       }
     }
@@ -1041,6 +1038,12 @@ static void init_instruments() {
 void start_midi_clock() {
 }
 
+// queues an action of the buttons for the jukebox task (dropped if the queue is full)
+static void push_ui_request(byte action, byte arg1, byte arg2) {
+  UiRequest r = { action, arg1, arg2 };
+  xQueueSend(ui_request_queue, &r, 0);
+}
+
 void run_ui() {
   int8_t source_memory = -1;
 
@@ -1056,35 +1059,26 @@ void run_ui() {
   for (int i = 0; i < NumMemories; i++) {
     if (just_pressed(ButMem1 + i)) {
       if (source_memory >= 0) {
-#ifdef DEBUG_JUKEBOX
-        DEBF("copy %d to %d\r\n", source_memory, i);
-#endif
-        memcpy(&memories[i], &memories[source_memory], sizeof(memories[0]));
+        push_ui_request(UiCopyMemory, source_memory, i);
       } else {
-#ifdef DEBUG_JUKEBOX
-        DEBF("switching to memory %d", i);
-#endif
-        cur_memory = i;
+        push_ui_request(UiSwitchMemory, i, 0);
       }
     }
   }
 
   // Handle pattern generation
   if (just_pressed(ButPat1)) {
-    mem_generate_melody_and_seed(cur_memory, 0);
-    print_memory(cur_memory);
+    push_ui_request(UiGenerateMelody, 0, 0);
   }
   if (just_pressed(ButPat1 + 1)) {
-    mem_generate_melody_and_seed(cur_memory, 1);
-    print_memory(cur_memory);
+    push_ui_request(UiGenerateMelody, 1, 0);
   }
   if (just_pressed(ButNotes)) {
-    mem_generate_note_set(cur_memory);
-    print_memory(cur_memory);
+    push_ui_request(UiGenerateNoteSet, 0, 0);
   }
   if (just_pressed(ButDrums)) {
 //    mem_generate_drums(cur_memory, DrumStraight);
-    print_memory(cur_memory);
+    push_ui_request(UiPrintMemory, 0, 0);
   }
 
   // Handle play
@@ -1093,21 +1087,95 @@ void run_ui() {
 #ifdef DEBUG_JUKEBOX
       DEBUG("stopping midi");
 #endif
-      do_midi_stop();
+      __atomic_store_n(&jukebox_request, (byte)JukeboxStop, __ATOMIC_RELEASE);
     } else {
 #ifdef DEBUG_JUKEBOX
-      DEBF("starting midi clock, dt=%lu", midi_tick_ms);
+      DEBF("starting midi clock, dt=%f frames", midi_tick_frames);
+#endif
+      __atomic_store_n(&jukebox_request, (byte)JukeboxStart, __ATOMIC_RELEASE);
+    }
+  }
+}
+
+// runs an action of the buttons (in the jukebox task)
+static void run_ui_request(byte action, byte arg1, byte arg2) {
+  switch (action) {
+    case UiCopyMemory:
+#ifdef DEBUG_JUKEBOX
+      DEBF("copy %d to %d\r\n", arg1, arg2);
 #endif
-      last_midi_tick = now;
+      memcpy(&memories[arg2], &memories[arg1], sizeof(memories[0]));
+      break;
+    case UiSwitchMemory:
+#ifdef DEBUG_JUKEBOX
+      DEBF("switching to memory %d", arg1);
+#endif
+      cur_memory = arg1;
+      break;
+    case UiGenerateMelody:
+      mem_generate_melody_and_seed(cur_memory, arg1);
+      print_memory(cur_memory);
+      break;
+    case UiGenerateNoteSet:
+      mem_generate_note_set(cur_memory);
+      print_memory(cur_memory);
+      break;
+    case UiPrintMemory:
+      print_memory(cur_memory);
+      break;
+  }
+}
+
+// The step engine runs in its own task, which the audio task wakes after each block. The ticks are
+// scheduled on the audio frame counter a step ahead, so the synth gets its events time-stamped and
+// plays them at the exact sample, no matter how busy loop() is.
+static void jukebox_task(void *userData) {
+  while (true) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    uint32_t frame = audio_frames;
+
+    /* Follow the tempo of an external MIDI clock */
+    if (ClockSync.isLocked()) {
+      set_bpm(ClockSync.getTempo());
+    }
+
+    /* The buttons and the entropy from loop() */
+    uint16_t entropy = __atomic_exchange_n(&jukebox_entropy, (uint16_t)0, __ATOMIC_RELAXED);
+    if (entropy != 0) generator.addEntropy(entropy);
+    UiRequest ui_request;
+    while (xQueueReceive(ui_request_queue, &ui_request, 0) == pdTRUE) {
+      run_ui_request(ui_request.action, ui_request.arg1, ui_request.arg2);
+    }
+
+    byte request = __atomic_exchange_n(&jukebox_request, (byte)JukeboxNoRequest, __ATOMIC_ACQ_REL);
+    if (request == JukeboxStart && !midi_playing) {
+      jukebox_frame = next_tick_frame = frame + audio_block_len; // the next block to be rendered
+      next_tick_frac = 0.0f;
+      audio_set_latency_mode(JUKEBOX_LATENCY_MODE);
       do_midi_start();
+    } else if (request == JukeboxStop && midi_playing) {
+      jukebox_frame = next_tick_frame; // after the notes that are already queued
+      do_midi_stop();
+      audio_set_latency_mode(LATENCY_MODE);
+    }
+
+    /* Schedule all the ticks that are due within the next step */
+    float lookahead = midi_tick_frames * MIDI_TICKS_PER_16TH;
+    while (midi_playing && (int32_t)(next_tick_frame - frame) <= (int32_t)lookahead) {
+      jukebox_frame = next_tick_frame;
       do_midi_tick();
+      next_tick_frac += midi_tick_frames;
+      uint32_t whole = (uint32_t)next_tick_frac;
+      next_tick_frame += whole;
+      next_tick_frac -= whole;
     }
+
+    flush_midi_out(frame);
   }
 }
 
 void run_tick() {
   /* Run button scan at 250 Hz */
-  now = millis();
   button_divider++;
   if (button_divider >= 4) {
     for (int i = 0; i < ButLast; i++) {
@@ -1117,16 +1185,6 @@ void run_tick() {
     button_divider = 0;
     
   }
-
-  /* If MIDI is playing, then check for tick */
-  if (midi_playing && (now - last_midi_tick) >= midi_tick_ms) {
-    do_midi_tick();
-    last_midi_tick += midi_tick_ms;
-    if (last_midi_tick < now) {
-      /* we are at least one tick late, give up */
-      last_midi_tick = now;
-    }
-  }
 }
 
 /*
@@ -2,6 +2,8 @@
 #define GlobalDefinitions_h
 
 #include <float.h>
+#include <stdint.h>
+#include <string.h>
 
 /** This file contains a bunch of useful macros which are not wrapped into the
 rosic namespace to facilitate their global use. */
@@ -12,6 +14,29 @@ rosic namespace to facilitate their global use. */
 #define INLINE inline  // something better to do here ?
 #endif
 
+/** Placement of the render path on the ESP32: when RENDER_IN_IRAM is defined (in the sketch), the
+functions that run per sample or per block go into IRAM (RENDER_CODE) and constant data that they
+read into internal DRAM (RENDER_DATA), so the audio doesn't depend on the flash cache, where a miss
+stalls the CPU. RENDER_INLINE is for the inlined functions of the render path, which the compiler
+may still emit out of line. Elsewhere, the macros are empty. */
+#if defined(RENDER_IN_IRAM) && defined(ESP_PLATFORM)
+#include "esp_attr.h"
+#define RENDER_CODE IRAM_ATTR
+#define RENDER_DATA DRAM_ATTR
+#else
+#define RENDER_CODE
+#define RENDER_DATA
+#endif
+#define RENDER_INLINE INLINE RENDER_CODE
+
+/** Size of a line of the data cache - the audio-rate state of the synth is aligned to it (32 bytes
+on the ESP32 and ESP32-S3 in their default configuration). */
+#ifdef ESP_PLATFORM
+#define CACHE_LINE_SIZE 32
+#else
+#define CACHE_LINE_SIZE 64
+#endif
+
 const float MIDI_NORM = 1.0f/127.0f;
 const float MIDI_NORM_100 = 100.0f/127.0f;
 
@@ -36,6 +61,20 @@ const float MIDI_NORM_100 = 100.0f/127.0f;
 #define CC_303_OVERDRIVE    95
 #define CC_303_SATURATOR    128
 
+// parameters which were not available to the user in the 303 (undefined controllers 102...119):
+#define CC_303_TUNING        102
+#define CC_303_AMP_SUSTAIN   103
+#define CC_303_TANH_DRIVE    104
+#define CC_303_TANH_OFFSET   105
+#define CC_303_PRE_HPF       106
+#define CC_303_FEEDBACK_HPF  107
+#define CC_303_POST_HPF      108
+#define CC_303_SQUARE_PHASE  109
+#define CC_303_ACCENT_ATTACK 110
+#define CC_303_ACCENT_DECAY  111
+#define CC_303_AMP_DECAY     112
+#define CC_303_AMP_RELEASE   113
+
 #define CC_ANY_COMPRESSOR   93
 #define CC_ANY_DELAY_TIME   84
 #define CC_ANY_DELAY_FB     85
@@ -106,11 +145,11 @@ typedef signed __int64 INT64;
 typedef signed long long INT64;
 #endif
 
-// unsigned 32 bit integers:
+// unsigned 32 bit integers (unsigned long has 64 bits on 64 bit Linux and macOS hosts):
 #ifdef _MSC_VER
 typedef unsigned __int32 UINT32;
 #else
-typedef unsigned long UINT32;
+typedef uint32_t UINT32;
 #endif
 
 // ...constants for numerical precision issues, denorm, etc.:
@@ -150,9 +189,14 @@ inline float dummyFunction(float x) { return x; }
 //-------------------------------------------------------------------------------------------------
 // bit twiddling:
 
+// the bits of a IEEE 754 floating point number - copied, as reading them through a cast pointer
+// breaks the strict aliasing rules (the compiler turns the memcpy into a plain move):
+INLINE UINT32 floatBits(float value)   { UINT32 bits; memcpy(&bits, &value, sizeof(bits)); return bits; }
+INLINE UINT64 doubleBits(double value) { UINT64 bits; memcpy(&bits, &value, sizeof(bits)); return bits; }
+
 //extract the exponent from a IEEE 754 floating point number (single and dbl precision):
-#define EXPOFFLT(value) (((*((reinterpret_cast<UINT32 *>(&value)))&0x7FFFFFFF)>>23)-127)
-#define EXPOFDBL(value) (((*((reinterpret_cast<UINT64 *>(&value)))&0x7FFFFFFFFFFFFFFFULL)>>52)-1023)
+#define EXPOFFLT(value) (((floatBits(value)&0x7FFFFFFF)>>23)-127)
+#define EXPOFDBL(value) (((doubleBits(value)&0x7FFFFFFFFFFFFFFFULL)>>52)-1023)
   // ULL indicates an unsigned long long literal constant
 
 #endif
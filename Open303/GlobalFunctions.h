@@ -155,7 +155,7 @@ INLINE float wholeNotesToSeconds(float noteValue, float bpm);
 
 INLINE float amp2dB(float amp)
 {
-  return 8.6858896380650365530225783783321 * log(amp);
+  return 8.6858896380650365530225783783321f * logf(amp);
   //return 20*log10(amp); // naive version
 }
 
@@ -201,7 +201,7 @@ INLINE int arrayMinIndex(T* theArray, int numValues)
 
 INLINE float beatsToSeconds(float beat, float bpm)
 {
-  return (60.0/bpm)*beat;
+  return (60.0f/bpm)*beat;
 }
 
 INLINE float dB2amp(float dB)
@@ -398,11 +398,11 @@ INLINE float radiantToDegree(float radiant)
 
 INLINE float randomUniform(float min, float max, int seed)
 {
-  static unsigned long state = 0;
+  static uint32_t state = 0;                             // 32 bits, also on 64 bit hosts
   if( seed >= 0 )
     state = seed;                                        // initialization, if desired
   state = 1664525*state + 1013904223;                    // mod implicitely by integer overflow
-  return min + (max-min) * ((1.0/4294967296.0) * state); // transform to desired range
+  return min + (max-min) * ((1.0f/4294967296.0f) * state); // transform to desired range
 }
 /*
 INLINE float round(float x)
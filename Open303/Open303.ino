@@ -9,18 +9,30 @@
 
 #define SYNTH1_MIDI_CHAN        1
 #define DEBUG_ON
+//#define DEBUG_AUDIO_LOAD                // print the render statistics (load, xruns, histogram) every few seconds
+//#define PROFILE_SYNTH                   // measure the time per stage of the synth, send 'p' via USBSerial for a breakdown, 'r' to reset
 //#define MIDI_VIA_SERIAL
 #define MIDI_VIA_SERIAL2
 #define MIDIRX_PIN      4       // this pin is used for input when MIDI_VIA_SERIAL2 defined (note that default pin 17 won't work with PSRAM)
-#define MIDITX_PIN      0      // this pin will be used for output (not implemented yet) when MIDI_VIA_SERIAL2 defined
+#define MIDITX_PIN      0      // this pin is used for output (sequencer notes, clock, thru) when MIDI_VIA_SERIAL2 defined
+//#define MIDI_SOFT_THRU          // echo the MIDI input (without sysex) to the output, MIDI_VIA_SERIAL2 only
 
 //#define NO_PSRAM
+#define RENDER_IN_IRAM                  // run the render path from IRAM, so flash cache misses can't stall it (see GlobalDefinitions.h)
+//#define CACHE_STRESS                    // benchmark for RENDER_IN_IRAM: a task on the other core keeps evicting the flash cache
+//#define LAYOUT_BENCH                    // benchmark at startup: render time with the synth and its tables in internal RAM or PSRAM
+//#define STORM_BENCH                     // benchmark at startup: percentiles of the block render time under worst-case event storms
 //#define USE_INTERNAL_DAC
 
 #define SAMPLE_RATE     44100   // 44100 seems to be the right value, 48000 is also OK. Other values are not tested.
 
-#define DMA_BUF_LEN     32          // there should be no problems with low values, down to 32 samples, 64 seems to be OK with some extra
+#define DMA_BUF_LEN     32          // frames per DMA buffer (= per block) in the tight latency mode, powers of 2 from 32 to 512
+#define DMA_BUF_LEN_SAFE 256        // frames per DMA buffer in the safe latency mode
 #define DMA_NUM_BUF     2           // I see no reasom to set more than 2 DMA buffers, but...
+#define LATENCY_MODE    0           // 0: tight (DMA_BUF_LEN), 1: safe (DMA_BUF_LEN_SAFE), 2: auto (grows the buffers when the render time gets close to the deadline)
+#define JUKEBOX_LATENCY_MODE 1      // the latency mode while the jukebox plays, LATENCY_MODE is restored when it stops
+#define I2S_BITS        16          // 16, 24 or 32 bits per sample (24 bits are sent in 32 bit slots)
+#define I2S_DITHER      0           // 0: none, 1: TPDF dither, 2: TPDF dither with noise shaping (not for 32 bits)
 
 #define I2S_BCLK_PIN    5
 #define I2S_DOUT_PIN    6
@@ -30,9 +42,12 @@
 #ifndef MIDI_VIA_SERIAL
   #ifndef DEB
     #ifdef DEBUG_ON
-      #define DEB(...) USBSerial.print(__VA_ARGS__) 
-      #define DEBF(...) USBSerial.printf(__VA_ARGS__) 
-      #define DEBUG(...) USBSerial.println(__VA_ARGS__) 
+      // the messages go into a lock-free ring, which a low priority task prints (see debug_log.ino),
+      // so they never block the caller - printf arguments are stored as they are, strings must be literals
+      #define DEBUG_LOG_RING
+      #define DEB(...) DebugLog.print(__VA_ARGS__) 
+      #define DEBF(...) DebugLog.printf(__VA_ARGS__) 
+      #define DEBUG(...) DebugLog.println(__VA_ARGS__) 
     #else
       #define DEB(...)
       #define DEBF(...)
@@ -70,29 +85,84 @@ MIDI_NAMESPACE::MidiInterface<MIDI_NAMESPACE::SerialMIDI<HardwareSerial, Serial2
 #endif
 
 
-#include "driver/i2s.h"
+#if ESP_IDF_VERSION_MAJOR >= 5
+  #define I2S_ZERO_COPY         // the audio task renders straight into the DMA buffers of the driver
+  #include "driver/i2s_std.h"
+#else
+  #include "driver/i2s.h"       // the legacy driver has no access to its DMA buffers, so we copy
+#endif
 #include "rosic_Open303.h"
+#include "rosic_MidiClockSync.h"
+#include "rosic_AcidGenerator.h"
+#include "rosic_MidiParser.h"
+#include "rosic_Open303CCMap.h"
+#include "rosic_MidiOutBuffer.h"
+#include "rosic_OutputConverter.h"
+#include "rosic_LatencyController.h"
+#include "rosic_AudioTelemetry.h"
+#include "rosic_LogRing.h"
+
+#if I2S_BITS == 16
+typedef int16_t i2s_sample_t;
+#else
+typedef int32_t i2s_sample_t;
+#endif
 
 
 // tasks for Core0 and Core1
 TaskHandle_t SynthTask1;
+TaskHandle_t JukeboxTask = NULL;
 //TaskHandle_t SynthTask2;
+#ifdef I2S_ZERO_COPY
+i2s_chan_handle_t i2s_tx_chan = NULL; // i2s output channel
+#else
 const i2s_port_t i2s_num = I2S_NUM_0; // i2s port number
+#endif
 float bpm = 130.0f;
 
-rosic::Open303 Synth;
-rosic::AcidSequencer Sequencer;
+rosic::Open303ColdData SynthColdData;  // wavetables and patterns of the synth, in internal RAM like the synth
+rosic::Open303 Synth(&SynthColdData);
+rosic::AcidSequencerData SequencerData;
+rosic::AcidSequencer Sequencer(&SequencerData);
+rosic::MidiClockSync ClockSync; // follows an external MIDI clock
+rosic::Open303CCMap CCMap;      // maps MIDI controllers to the parameters of the synth
+rosic::OutputConverter OutConverter; // float to I2S samples
+rosic::LatencyController Latency;    // chooses the length of the DMA buffers
+rosic::AudioTelemetry Telemetry;     // render time statistics in CPU cycles, readable from any task
+float cpu_hz = 240000000.0f;         // CPU clock, to convert cycles to time
+#ifdef DEBUG_LOG_RING
+rosic::LogRing DebugLog;             // the debug messages on their way to USBSerial
+#endif
 
+#define MAX_BUF_LEN rosic::LatencyController::maxBlockSize
+volatile int audio_block_len = DMA_BUF_LEN;  // frames per block (and per DMA buffer), only changed by the audio task
+volatile int latency_mode_request = -1;      // a new latency mode from another task, applied by the audio task
+
+volatile uint32_t audio_frames = 0;     // number of frames handed to the I2S driver so far
+volatile uint32_t audio_frames_us = 0;  // micros() at the moment audio_frames was last updated
+
+// MIDI events for the synth, time-stamped with the audio frame at which they are due. They are
+// applied by the audio task at the exact sample within the block. Each producer has a queue of its
+// own, in which the frames only go up, and the audio task merges the queues by frame - in a shared
+// queue, an event that the jukebox schedules a step ahead would hold back the live input behind it.
+#define SYNTH_EVENT_QUEUE_LEN 128
+typedef struct {
+  uint32_t frame;
+  uint8_t status, data1, data2;
+} SynthEvent;
+enum {
+  LIVE_EVENTS = 0,   // MIDI input, stamped with the time of arrival
+  JUKEBOX_EVENTS,    // the jukebox, scheduled up to a step ahead
+  NUM_EVENT_QUEUES
+};
+QueueHandle_t synth_event_queues[NUM_EVENT_QUEUES];
+
+#ifndef I2S_ZERO_COPY
 size_t bytes_written; // i2s
-volatile uint32_t s1t, s2t, drt, fxt, s1T, s2T, drT, fxT, art, arT; // debug timing: if we use less vars, compiler optimizes them
-
-// Audio buffers of all kinds
-static float mix_buf_l[DMA_BUF_LEN];    // mix L channel
-static float mix_buf_r[DMA_BUF_LEN];    // mix R channel
-static union { // a dirty trick, instead of true converting
-  int16_t _signed[DMA_BUF_LEN * 2];
-  uint16_t _unsigned[DMA_BUF_LEN * 2];
-} out_buf; // i2s L+R output buffer
+static i2s_sample_t out_buf[MAX_BUF_LEN * 2]; // i2s L+R output buffer, copied into the DMA buffers by i2s_write
+#endif
+static float synth_buf[MAX_BUF_LEN];   // the synth renders a block in float (mono), which is then panned in place (left)
+static float synth_buf_r[MAX_BUF_LEN]; // right channel of the panned block
 /*
 hw_timer_t * timer1 = NULL;            // Timer variables
 portMUX_TYPE timer1Mux = portMUX_INITIALIZER_UNLOCKED; 
@@ -115,6 +185,7 @@ void setup() {
 #ifdef DEBUG_ON
 #ifndef MIDI_VIA_SERIAL
   USBSerial.begin(115200);
+  log_init();
   DEBUG("DEBUG Started");
   delay(1000);
 #endif
@@ -122,11 +193,31 @@ void setup() {
 
 	btStop();
   DEBUG("BT Stopped");
+
+#ifdef LAYOUT_BENCH
+  layout_bench(); // before the audio starts, so nothing else runs on this core
+#endif
+#ifdef STORM_BENCH
+  storm_bench();
+#endif
   
+  OutConverter.setNumBits(I2S_BITS);
+  OutConverter.setDitherMode(I2S_DITHER);
+  Latency.setBlockSizes(DMA_BUF_LEN, DMA_BUF_LEN_SAFE);
+  Latency.setMode(LATENCY_MODE);
+  cpu_hz = getCpuFrequencyMhz() * 1000000.0f;
+  Telemetry.setLoadWindow((uint32_t)cpu_hz); // load averaged over a second
+  audio_block_len = Latency.getBlockSize();
 	i2sInit();
   DEBUG("I2S Started");
 
+  for (int q = 0; q < NUM_EVENT_QUEUES; q++) {
+    synth_event_queues[q] = xQueueCreate(SYNTH_EVENT_QUEUE_LEN, sizeof(SynthEvent));
+  }
+
   MidiInit();
+  midi_out_init();
+  Synth.setSequencerNoteOutput(midi_out_sequencer_note);
   DEBUG("MIDI Started");
 
 #ifdef JUKEBOX
@@ -138,9 +229,11 @@ void setup() {
   xTaskCreatePinnedToCore( audio_task1, "SynthTask1", 8000, NULL, 1, &SynthTask1, 0 );
 	// xTaskCreatePinnedToCore( audio_task2, "SynthTask2", 8000, NULL, 1, &SynthTask2, 1 );
 
-	// somehow we should allow tasks to run
-	xTaskNotifyGive(SynthTask1);
-	//xTaskNotifyGive(SynthTask2);
+	// the audio task is paced by the I2S driver (i2s_get_buffer waits until a DMA buffer is free)
+
+#ifdef CACHE_STRESS
+  cache_stress_init();
+#endif
 
   /*
   // timer interrupt
@@ -159,10 +252,7 @@ void loop() {
 #endif
 
   taskYIELD(); // this can wait
-
-#ifdef MIDI_VIA_SERIAL2
-  MIDI2.read();
-#endif
+  i2s_service_resize(); // a new block length from the audio task
 /*
   if(timer1_fired) {
     timer1_fired = false;
@@ -179,25 +269,123 @@ void loop() {
   run_tick();
   myRandomAddEntropy((uint16_t)(micros() & 0x0000FFFF));
 #endif
+#ifdef DEBUG_AUDIO_LOAD
+  print_audio_telemetry();
+#endif
+#ifdef PROFILE_SYNTH
+  print_stage_profile();
+#endif
 
 }
 
 
 // Core0 task
-static void audio_task1(void *userData) {
+static void RENDER_CODE audio_task1(void *userData) {
   DEBUG ("TASK 1 Started");
+  bool fade_in = false; // the block after a restart of the driver
   while (true) {
-    if (ulTaskNotifyTake(pdTRUE, portMAX_DELAY)) {
-      s1t = micros();
-      for (int i = 0 ; i < DMA_BUF_LEN; i++) {
-        mix_buf_l[i] = mix_buf_r[i] = Synth.getSample();   
+    int len = audio_block_len;
+    i2s_sample_t *out = i2s_get_buffer(); // interleaved L+R, waits until the driver has room for a block
+    uint32_t render_start = ESP.getCycleCount();
+    uint32_t frame = audio_frames; // the first frame of this block
+    SynthEvent head[NUM_EVENT_QUEUES]; // the next event of each queue
+    bool have_head[NUM_EVENT_QUEUES];
+    for (int q = 0; q < NUM_EVENT_QUEUES; q++) {
+      have_head[q] = xQueuePeek(synth_event_queues[q], &head[q], 0);
+    }
+    for (int i = 0 ; i < len; i++) {
+      // apply the events that are due at this sample (or late), the earliest of all queues first:
+      int q;
+      while ((q = next_due_synth_event(head, have_head, frame + i)) >= 0) {
+        xQueueReceive(synth_event_queues[q], &head[q], 0);
+        dispatch_synth_event(head[q]);
+        have_head[q] = xQueuePeek(synth_event_queues[q], &head[q], 0);
       }
-      s1T = micros() - s1t;
+      synth_buf[i] = Synth.getSample();
+    }
+    // the synth is mono, the panner makes it stereo and the conversion interleaves the channels:
+    Synth.panner.process(synth_buf, synth_buf, synth_buf_r, len);
+    // a new block length (decided after the last block) restarts the driver, the output is muted
+    // around that:
+    bool resize = Latency.getBlockSize() != len;
+    if (resize) {
+      fade_block(synth_buf, synth_buf_r, len, 1.0f, 0.0f);
+    } else if (fade_in) {
+      fade_block(synth_buf, synth_buf_r, len, 0.0f, 1.0f);
+      fade_in = false;
+    }
+    // converted straight into the DMA buffer; the float block before it is what the panner, the
+    // fades and the dither (whose noise shaping runs across the block) work on
+    OutConverter.process(synth_buf, synth_buf_r, out, len);
+    uint32_t render_cycles = ESP.getCycleCount() - render_start;
+    Telemetry.blockRendered(render_cycles, (uint32_t)(len * cpu_hz / SAMPLE_RATE));
+    Telemetry.addUnderruns(i2s_take_underruns());
+#ifdef JUKEBOX
+    if (JukeboxTask != NULL) xTaskNotifyGive(JukeboxTask); // let the jukebox schedule ahead
+#endif
+    midi_out_kick();
+    i2s_output(out);
+
+    // a new latency mode or the render load may ask for another block length:
+    int request = latency_mode_request;
+    if (resize) {
+      i2s_resize(Latency.getBlockSize());
+      fade_in = true;
+    } else if (request >= 0) {
+      latency_mode_request = -1;
+      Latency.setMode(request);
+    } else {
+      Latency.update(render_cycles / cpu_hz, (float)len / SAMPLE_RATE);
     }
- // DEBF("time=%dus , sample=%e\r\n" , s1T, mix_buf_l[0]);
-    i2s_output();
     
     taskYIELD();
     
   }
 }
+
+// scales the block with a linear ramp from the gain 'from' to the gain 'to' (reached at the last
+// frame), to mute the output around a restart of the driver without a click
+static void RENDER_CODE fade_block(float *left, float *right, int len, float from, float to) {
+  float step = (to - from) / len;
+  for (int i = 0; i < len; i++) {
+    float gain = from + step * (i + 1);
+    left[i] *= gain;
+    right[i] *= gain;
+  }
+}
+
+#ifdef DEBUG_AUDIO_LOAD
+// prints the render statistics every 5 seconds (from loop(), i.e. not from the audio task)
+void print_audio_telemetry() {
+  static uint32_t last_ms = 0;
+  if (millis() - last_ms < 5000) return;
+  last_ms = millis();
+  rosic::AudioTelemetry::Snapshot s;
+  Telemetry.getSnapshot(s);
+  DEBF("blocks=%u len=%d load=%.1f%% peak=%.1f%% max=%uus late=%u underruns=%u\r\n", s.numBlocks,
+    audio_block_len, 100.0f * s.load, 100.0f * s.peakLoad, (uint32_t)(s.maxRenderTime * 1e6f / cpu_hz),
+    s.numLateBlocks, s.numUnderruns);
+  // render time histogram, bucket b holds the times below 2^b cycles:
+  for (int b = 0; b < rosic::AudioTelemetry::numBuckets; b++) {
+    if (s.histogram[b] > 0) DEBF("  <2^%d cycles: %u\r\n", b, s.histogram[b]);
+  }
+}
+#endif
+
+#ifdef PROFILE_SYNTH
+// prints the time spent in the stages of the synth when 'p' is received on the debug port, 'r'
+// clears the counters
+void print_stage_profile() {
+#if defined DEBUG_ON && !defined MIDI_VIA_SERIAL
+  if (USBSerial.available() <= 0) return;
+  int c = USBSerial.read();
+  if (c == 'p') {
+    static char text[512];
+    rosic::stageProfiler.format(text, sizeof(text));
+    USBSerial.print(text); // too long for the log ring, but we are in loop() anyway
+  } else if (c == 'r') {
+    rosic::stageProfiler.reset();
+  }
+#endif
+}
+#endif
@@ -0,0 +1,30 @@
+#ifdef CACHE_STRESS
+
+// Benchmark for the placement of the render code (RENDER_IN_IRAM): a low priority task on the
+// other core keeps sweeping over a table in flash which is much larger than the flash cache, such
+// that everything the audio task runs from flash is evicted all the time, like it happens with a
+// busy UI or network stack. Compare the render statistics (DEBUG_AUDIO_LOAD) with and without
+// RENDER_IN_IRAM.
+
+#define CACHE_STRESS_SIZE   (256*1024)  // bytes
+#define CACHE_STRESS_STRIDE 32          // bytes, one cache line
+
+static const uint8_t cache_stress_data[CACHE_STRESS_SIZE] = { 1 }; // const, so it stays in flash
+static TaskHandle_t CacheStressTask;
+
+static void cache_stress_task(void *userData) {
+  const volatile uint8_t *data = cache_stress_data;
+
+  while (true) {
+    for (int i = 0; i < CACHE_STRESS_SIZE; i += CACHE_STRESS_STRIDE) {
+      (void) data[i];
+    }
+    vTaskDelay(1);
+  }
+}
+
+void cache_stress_init() {
+  xTaskCreatePinnedToCore( cache_stress_task, "CacheStress", 2048, NULL, 1, &CacheStressTask, 1 );
+}
+
+#endif
@@ -0,0 +1,27 @@
+// Debug output. DEB, DEBF and DEBUG only store the format string and the binary arguments of a
+// message in a lock-free ring (rosic::LogRing), which takes a few dozen instructions and never
+// blocks. This low priority task formats the messages and writes them to USBSerial, so the USB CDC
+// port (which may block for milliseconds) never stalls the audio, MIDI or jukebox tasks, and
+// debug builds keep the timing of release builds.
+
+#ifdef DEBUG_LOG_RING
+static void log_task(void *userData) {
+  static char text[256];
+  rosic::LogRing::Record record;
+  while (true) {
+    while (DebugLog.pop(record)) {
+      rosic::LogRing::formatRecord(record, text, sizeof(text));
+      USBSerial.print(text);
+    }
+    uint32_t dropped = DebugLog.takeNumDropped();
+    if (dropped > 0) USBSerial.printf("[log: %u messages dropped]\r\n", (unsigned)dropped);
+    vTaskDelay(pdMS_TO_TICKS(10));
+  }
+}
+#endif
+
+void log_init() {
+#ifdef DEBUG_LOG_RING
+  xTaskCreatePinnedToCore( log_task, "LogTask", 4096, NULL, 1, NULL, 1 );
+#endif
+}
@@ -1,15 +1,69 @@
 
+#ifdef I2S_ZERO_COPY
+// With the i2s_channel driver, the DMA buffers form a ring which the hardware plays round and round.
+// Whenever one of them has been sent, the driver tells us (in the ISR) which one it was, and as the
+// hardware is busy with the next buffer now, the audio task can render the next block right into
+// the one that was just sent. So there is no intermediate buffer and no copy via i2s_write.
+static i2s_sample_t * volatile i2s_free_buf = NULL; // the DMA buffer that was sent most recently
+static volatile uint32_t i2s_free_buf_us = 0;  // micros() at that moment
+#else
+static QueueHandle_t i2s_event_queue = NULL;     // events of the legacy driver, we look for underruns there
+#endif
+static uint32_t i2s_underruns = 0;              // underruns since the last call of i2s_take_underruns()
+
+#ifdef I2S_ZERO_COPY
+static bool IRAM_ATTR i2s_on_sent(i2s_chan_handle_t handle, i2s_event_data_t *event, void *user_ctx) {
+  i2s_free_buf = *(i2s_sample_t **)event->data; // data points to the pointer to the DMA buffer
+  i2s_free_buf_us = micros();
+  BaseType_t need_yield = pdFALSE;
+  if (SynthTask1 != NULL) vTaskNotifyGiveFromISR(SynthTask1, &need_yield);
+  return need_yield == pdTRUE;
+}
+
+void i2sInit() {
+  i2s_chan_config_t chan_cfg = I2S_CHANNEL_DEFAULT_CONFIG(I2S_NUM_0, I2S_ROLE_MASTER);
+  chan_cfg.dma_desc_num = DMA_NUM_BUF;
+  chan_cfg.dma_frame_num = audio_block_len;
+  chan_cfg.auto_clear = true; // if we are late, a buffer is played as silence rather than repeated
+  i2s_new_channel(&chan_cfg, &i2s_tx_chan, NULL);
+
+  i2s_std_config_t std_cfg = {
+    .clk_cfg = I2S_STD_CLK_DEFAULT_CONFIG(SAMPLE_RATE),
+#if I2S_BITS == 16
+    .slot_cfg = I2S_STD_PHILIPS_SLOT_DEFAULT_CONFIG(I2S_DATA_BIT_WIDTH_16BIT, I2S_SLOT_MODE_STEREO),
+#else
+    .slot_cfg = I2S_STD_PHILIPS_SLOT_DEFAULT_CONFIG(I2S_DATA_BIT_WIDTH_32BIT, I2S_SLOT_MODE_STEREO),
+#endif
+  };
+#if SOC_I2S_SUPPORTS_APLL
+  std_cfg.clk_cfg.clk_src = I2S_CLK_SRC_APLL;
+#endif
+  std_cfg.gpio_cfg.mclk = I2S_GPIO_UNUSED;
+  std_cfg.gpio_cfg.bclk = (gpio_num_t)I2S_BCLK_PIN;
+  std_cfg.gpio_cfg.ws = (gpio_num_t)I2S_WCLK_PIN;
+  std_cfg.gpio_cfg.dout = (gpio_num_t)I2S_DOUT_PIN;
+  std_cfg.gpio_cfg.din = I2S_GPIO_UNUSED;
+  i2s_channel_init_std_mode(i2s_tx_chan, &std_cfg);
+
+  i2s_event_callbacks_t callbacks = {};
+  callbacks.on_sent = i2s_on_sent;
+  i2s_channel_register_event_callback(i2s_tx_chan, &callbacks, NULL);
+  i2s_channel_enable(i2s_tx_chan);
+}
+
+#else
 void i2sInit() {
   i2s_config_t i2s_config = {
     .mode = (i2s_mode_t)(I2S_MODE_MASTER | I2S_MODE_TX ),
     .sample_rate = SAMPLE_RATE,
-    .bits_per_sample = I2S_BITS_PER_SAMPLE_16BIT,
+    .bits_per_sample = (I2S_BITS == 16) ? I2S_BITS_PER_SAMPLE_16BIT : I2S_BITS_PER_SAMPLE_32BIT,
     .channel_format = I2S_CHANNEL_FMT_RIGHT_LEFT,
     .communication_format = (i2s_comm_format_t)(I2S_COMM_FORMAT_STAND_I2S ),
     .intr_alloc_flags = ESP_INTR_FLAG_LEVEL2,
     .dma_buf_count = DMA_NUM_BUF,
-    .dma_buf_len = DMA_BUF_LEN,
+    .dma_buf_len = audio_block_len,
     .use_apll = true,
+    .tx_desc_auto_clear = true, // if we are late, a buffer is played as silence rather than repeated
   };
 
   i2s_pin_config_t i2s_pin_config = {
@@ -18,29 +72,123 @@ void i2sInit() {
     .data_out_num = I2S_DOUT_PIN
   };
 
-  i2s_driver_install(i2s_num, &i2s_config, 0, NULL);
+  i2s_driver_install(i2s_num, &i2s_config, 8, &i2s_event_queue);
 
   i2s_set_pin(i2s_num, &i2s_pin_config);
   i2s_zero_dma_buffer(i2s_num);
 }
+#endif
 
 
+// returns the position of the audio output in frames (samples per channel), which we use as the
+// time base for incoming MIDI. Between two buffers, the position is interpolated with micros().
+uint32_t audio_frame_clock() {
+  uint32_t frames, us;
+  do {
+    frames = audio_frames;
+    us = audio_frames_us;
+  } while (frames != audio_frames); // the audio task has updated them in between
+  uint32_t elapsed = micros() - us;
+  if (elapsed > 10000) elapsed = 10000; // keep the multiplication below from overflowing
+  elapsed = (elapsed * SAMPLE_RATE) / 1000000;
+  if (elapsed > (uint32_t)audio_block_len) elapsed = audio_block_len;
+  return frames + elapsed;
+}
+
 void i2sDeinit() {
+#ifdef I2S_ZERO_COPY
+  i2s_channel_disable(i2s_tx_chan);
+  i2s_del_channel(i2s_tx_chan);
+  i2s_tx_chan = NULL;
+#else
   i2s_zero_dma_buffer(i2s_num);
   i2s_driver_uninstall(i2s_num);
+#endif
 }
 
+static volatile int i2s_resize_len = 0; // the block length that loop() should switch to, 0 for none
 
-inline void i2s_output () {
-  // now out_buf is ready, output
+// changes the length of the DMA buffers (and thus of the blocks), which needs a restart of the
+// driver. The driver allocates its DMA buffers on the heap, which must not happen in the audio
+// task, so the restart is handed over to loop() (which has set up the driver in the first place)
+// and the audio task waits for it with the output muted: the block before has been faded out by
+// the caller and is played before the driver stops. Must be called from the audio task between
+// blocks, the next block should be faded in.
+void i2s_resize(int len) {
+  // let the DMA buffers play out - the faded block and the silence behind it:
+  vTaskDelay(pdMS_TO_TICKS((DMA_NUM_BUF * audio_block_len * 1000) / SAMPLE_RATE) + 2);
+  i2s_resize_len = len;
+  while (i2s_resize_len != 0) vTaskDelay(1);
+#ifdef I2S_ZERO_COPY
+  ulTaskNotifyTake(pdTRUE, 0); // forget what has been sent while we were waiting
+#endif
+  i2s_take_underruns(); // the pause was on purpose
+}
 
-    for (int i=0; i < DMA_BUF_LEN; i++) {      
-    //  out_buf._signed[i*2] = 0x7fff * (float)(fast_tanh( mix_buf_l[i])) ; 
-    //  out_buf._signed[i*2+1] = 0x7fff * (float)(fast_tanh( mix_buf_r[i])) ;
-      out_buf._signed[i*2] = 0x7fff * (float)(( mix_buf_l[i])) ; 
-      out_buf._signed[i*2+1] = 0x7fff * (float)(( mix_buf_r[i])) ;
+// restarts the driver with the block length that the audio task has asked for - loop() only
+void i2s_service_resize() {
+  int len = i2s_resize_len;
+  if (len == 0) return;
+  i2sDeinit();
+  audio_block_len = len;
+#ifdef I2S_ZERO_COPY
+  i2s_free_buf = NULL; // belongs to the old channel
+#endif
+  i2sInit();
+  audio_frames_us = micros();
+  i2s_resize_len = 0;
+}
+
+// returns the number of underruns (blocks that the driver played as silence, because the audio task
+// was late) since the last call - audio task only
+uint32_t RENDER_CODE i2s_take_underruns() {
+#ifndef I2S_ZERO_COPY
+  // the legacy driver reports a TX queue overflow when all of its buffers have been sent:
+  i2s_event_t event;
+  while (i2s_event_queue != NULL && xQueueReceive(i2s_event_queue, &event, 0) == pdTRUE) {
+    if (event.type == I2S_EVENT_TX_Q_OVF) i2s_underruns++;
+  }
+#endif
+  uint32_t n = i2s_underruns;
+  i2s_underruns = 0;
+  return n;
+}
+
+// asks the audio task to switch to another latency mode (0: tight, 1: safe, 2: auto) after the
+// current block, see rosic::LatencyController - may be called from any task
+void audio_set_latency_mode(int mode) {
+  latency_mode_request = mode;
+}
+
+// returns the buffer into which the audio task renders the next block (audio_block_len frames of
+// interleaved L+R samples), waiting until the driver has room for it
+inline RENDER_CODE i2s_sample_t* i2s_get_buffer() {
+#ifdef I2S_ZERO_COPY
+  i2s_sample_t *buf = NULL;
+  while (buf == NULL) {
+    uint32_t sent = ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    buf = i2s_free_buf;
+    // when we were too late, the driver has played silence meanwhile - keep the clock in step:
+    if (sent > 1) {
+      audio_frames += (sent - 1) * audio_block_len;
+      i2s_underruns += sent - 1;
     }
-    i2s_write(i2s_num, out_buf._signed, sizeof(out_buf._signed), &bytes_written, portMAX_DELAY);
+  }
+  return buf;
+#else
+  return out_buf;
+#endif
+}
 
-  xTaskNotifyGive(SynthTask1);
+// hands the rendered block over to the driver and advances the frame clock
+inline void RENDER_CODE i2s_output(i2s_sample_t *buf) {
+#ifdef I2S_ZERO_COPY
+  // the block is already in place, the time is taken when its buffer was freed:
+  audio_frames_us = i2s_free_buf_us;
+#else
+  // i2s_write returns as soon as a DMA buffer was freed, so this is a good moment to take the time:
+  i2s_write(i2s_num, buf, audio_block_len * 2 * sizeof(i2s_sample_t), &bytes_written, portMAX_DELAY);
+  audio_frames_us = micros();
+#endif
+  audio_frames += audio_block_len;
 }
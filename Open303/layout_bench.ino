@@ -0,0 +1,67 @@
+#ifdef LAYOUT_BENCH
+
+// Benchmark for the memory layout of the synth: renders a few seconds of a pattern with an
+// extra Open303 whose audio-rate state (the Open303 object) and cold data (wavetables, patterns)
+// are allocated in internal RAM or in PSRAM, and prints the CPU cycles per sample for each
+// combination. The results go to USBSerial, so DEBUG_ON is needed (without MIDI_VIA_SERIAL).
+
+#include <new>
+#include "esp_heap_caps.h"
+#include "rosic_EventStorm.h"
+
+#define LAYOUT_BENCH_SAMPLES (4*SAMPLE_RATE)
+#define LAYOUT_BENCH_BLOCK   32
+
+static void* layout_bench_alloc(size_t size, bool psram) {
+  uint32_t caps = psram ? MALLOC_CAP_SPIRAM : (MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+  return heap_caps_aligned_alloc(CACHE_LINE_SIZE, size, caps);
+}
+
+static void layout_bench_run(const char *name, bool synth_in_psram, bool cold_in_psram) {
+#if defined DEBUG_ON && !defined MIDI_VIA_SERIAL
+  void *synth_mem = layout_bench_alloc(sizeof(rosic::Open303), synth_in_psram);
+  void *cold_mem  = layout_bench_alloc(sizeof(rosic::Open303ColdData), cold_in_psram);
+  if (synth_mem == NULL || cold_mem == NULL) {
+    USBSerial.printf("%-28s not enough memory\n", name);
+  } else {
+    rosic::Open303ColdData *cold = new (cold_mem) rosic::Open303ColdData;
+    rosic::Open303 *synth = new (synth_mem) rosic::Open303(cold);
+    rosic::EventStorm::setBenchPattern(synth->sequencer.getPattern(0));
+    synth->sequencer.setMode(rosic::AcidSequencer::KEY_SYNC);
+    synth->noteOn(36, 100, 0.0f);
+
+    float sum = 0.0f;
+    uint64_t total = 0;
+    uint32_t worst = 0;
+    for (int n = 0; n < LAYOUT_BENCH_SAMPLES; n += LAYOUT_BENCH_BLOCK) {
+      uint32_t start = ESP.getCycleCount();
+      for (int i = 0; i < LAYOUT_BENCH_BLOCK; i++) {
+        sum += synth->getSample();
+      }
+      uint32_t cycles = ESP.getCycleCount() - start;
+      total += cycles;
+      if (cycles > worst) worst = cycles;
+    }
+    USBSerial.printf("%-28s %8.1f %8.1f%s\n", name, (float)total / LAYOUT_BENCH_SAMPLES,
+      (float)worst / LAYOUT_BENCH_BLOCK, sum != 0.0f ? "" : " (silent)");
+
+    synth->~Open303();
+    cold->~Open303ColdData();
+  }
+  heap_caps_free(synth_mem);
+  heap_caps_free(cold_mem);
+#endif
+}
+
+void layout_bench() {
+#if defined DEBUG_ON && !defined MIDI_VIA_SERIAL
+  USBSerial.printf("Open303: %u bytes, cold data: %u bytes\n", (unsigned)sizeof(rosic::Open303),
+    (unsigned)sizeof(rosic::Open303ColdData));
+  USBSerial.printf("%-28s %8s %8s\n", "synth / cold data", "cyc/smp", "worst");
+#endif
+  layout_bench_run("internal / internal", false, false);
+  layout_bench_run("internal / PSRAM",    false, true);
+  layout_bench_run("PSRAM / PSRAM",       true,  true);
+}
+
+#endif
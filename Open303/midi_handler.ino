@@ -17,15 +17,25 @@ inline void MidiInit() {
   MIDI.setHandleControlChange(handleCC);
   MIDI.setHandlePitchBend(handlePitchBend);
   MIDI.setHandleProgramChange(handleProgramChange);
+  MIDI.setHandleClock(handleClock);
+  MIDI.setHandleStart(handleStart);
+  MIDI.setHandleContinue(handleContinue);
+  MIDI.setHandleStop(handleStop);
+  MIDI.setHandleSongPosition(handleSongPosition);
   MIDI.begin(MIDI_CHANNEL_OMNI);
+  MIDI.turnThruOff(); // the library's thru would write into the output stream behind our back
 #endif
 #ifdef MIDI_VIA_SERIAL2
-  MIDI2.setHandleNoteOn(handleNoteOn);
-  MIDI2.setHandleNoteOff(handleNoteOff);
-  MIDI2.setHandleControlChange(handleCC);
-  MIDI2.setHandlePitchBend(handlePitchBend);
-  MIDI2.setHandleProgramChange(handleProgramChange);
-  MIDI2.begin(MIDI_CHANNEL_OMNI);
+  MIDI2.begin(MIDI_CHANNEL_OMNI); // only used for output, input is handled by midi_uart_receive()
+  // get an event for every byte instead of waiting for a full FIFO or the RX timeout:
+  // (cores without the version macros are older, and a function-like macro that doesn't exist
+  // can't even be parsed in #if, so this needs two levels):
+#if defined(ESP_ARDUINO_VERSION_VAL) && defined(ESP_ARDUINO_VERSION)
+#if ESP_ARDUINO_VERSION >= ESP_ARDUINO_VERSION_VAL(2, 0, 8)
+  Serial2.setRxFIFOFull(1);
+#endif
+#endif
+  Serial2.onReceive(midi_uart_receive);
 #endif
 
 }
@@ -44,67 +54,182 @@ inline void handleNoteOff(uint8_t inChannel, uint8_t inNote, uint8_t inVelocity)
 }
 
 inline void handleCC(uint8_t inChannel, uint8_t cc_number, uint8_t cc_value) {
-  float norm_val ;
+  // synth parameters are table driven, see rosic_Open303CCMap.ino:
+  if (CCMap.handleCC(Synth, cc_number, cc_value)) return;
+
   switch (cc_number) { // global parameters yet set via ANY channel CCs
-   
-    case  CC_303_CUTOFF:
-      norm_val = MIDI_NORM * cc_value;
-      Synth.setCutoff(linToExp(norm_val, 0.0f, 1.0f, MIN_CUTOFF_FREQ, MAX_CUTOFF_FREQ));
+    case CC_ANY_RESET_CCS:
+    case CC_ANY_NOTES_OFF:
+    case CC_ANY_SOUND_OFF:
+      Synth.allNotesOff();
+      break; 
+  }
+}
+
+void handleProgramChange(uint8_t inChannel, uint8_t number) {
+}
+
+inline void handlePitchBend(uint8_t inChannel, int number) {
+  float semitones = ((((float)number + 8191.5f) * (float)TWO_DIV_16383 ) - 1.0f ) * 2.0f;
+  Synth.setPitchBend(semitones);
+}
+
+// MIDI clock (24 PPQN) slave: the ticks are time-stamped with the audio frame clock and filtered by
+// ClockSync. The sequencer of the synth follows the clock when it is in HOST_SYNC mode. The ticks
+// and the transport messages go through the queue of the live events like the notes, so only the
+// audio task touches ClockSync and the tick state of the sequencer (the jukebox task just reads the
+// tempo). The DLL works on the time stamps, so the detour doesn't add any jitter.
+void handleClock() {
+  push_synth_event(LIVE_EVENTS, audio_frame_clock(), 0xF8, 0, 0);
+}
+
+void handleStart() {
+  push_synth_event(LIVE_EVENTS, audio_frame_clock(), 0xFA, 0, 0);
+}
+
+void handleContinue() {
+  push_synth_event(LIVE_EVENTS, audio_frame_clock(), 0xFB, 0, 0);
+}
+
+void handleStop() {
+  push_synth_event(LIVE_EVENTS, audio_frame_clock(), 0xFC, 0, 0);
+}
+
+void handleSongPosition(unsigned int beats) {
+  push_synth_event(LIVE_EVENTS, audio_frame_clock(), 0xF2, beats & 0x7F, (beats >> 7) & 0x7F);
+}
+
+// applies a clock tick or a transport message in the audio task
+void apply_clock_event(const SynthEvent &event) {
+  rosic::AcidSequencer &seq = Synth.sequencer;
+  bool slaved = seq.getSequencerMode() == rosic::AcidSequencer::HOST_SYNC;
+  switch (event.status) {
+    case 0xF8: {
+      int action = ClockSync.clockTick(event.frame);
+      if (!slaved) return;
+      if (action == rosic::MidiClockSync::START) {
+        seq.start();
+      } else if (action == rosic::MidiClockSync::CONTINUE) {
+        seq.continuePlayback();
+      }
+      seq.setClockRate(ClockSync.getTickRate(seq.getClockPosition()));
       break;
-    case  CC_303_RESO:
-      Synth.setResonance(MIDI_NORM_100 * cc_value);
+    }
+    case 0xFA:
+#ifdef DEBUG_MIDI
+      DEBUG("MIDI start");
+#endif
+      ClockSync.start(); // takes effect on the next clock tick
       break;
-    case CC_303_ATTACK:
+    case 0xFB:
+#ifdef DEBUG_MIDI
+      DEBUG("MIDI continue");
+#endif
+      ClockSync.continuePlayback();
       break;
-    case CC_303_DECAY:
+    case 0xFC:
+#ifdef DEBUG_MIDI
+      DEBUG("MIDI stop");
+#endif
+      ClockSync.stop();
+      if (slaved) seq.stop();
       break;
-    case CC_303_ENVMOD_LVL:
-      Synth.setEnvMod(MIDI_NORM_100 * cc_value);
+    case 0xF2: {
+      // one MIDI beat is a 16th note, which is one step of the sequencer
+      int beats = event.data1 | (event.data2 << 7);
+      ClockSync.setSongPosition(beats);
+      if (slaved) seq.locate(beats);
       break;
-    case CC_303_ACCENT_LVL:
-      Synth.setAccent(MIDI_NORM_100 * cc_value);
+    }
+  }
+}
+
+// queues an event for the synth, which will be applied at the given audio frame. Each producer
+// uses its own queue (LIVE_EVENTS or JUKEBOX_EVENTS), with non-decreasing frames. Returns false if
+// the queue is full.
+bool push_synth_event(int queue, uint32_t frame, uint8_t status, uint8_t data1, uint8_t data2) {
+  SynthEvent event = { frame, status, data1, data2 };
+  return xQueueSend(synth_event_queues[queue], &event, 0) == pdTRUE;
+}
+
+// returns the queue whose next event is the earliest among those due at the given frame (or
+// late), -1 if none is due - audio task only
+inline int RENDER_CODE next_due_synth_event(const SynthEvent *head, const bool *have_head, uint32_t frame) {
+  int next = -1;
+  for (int q = 0; q < NUM_EVENT_QUEUES; q++) {
+    if (!have_head[q] || (int32_t)(head[q].frame - frame) > 0) continue;
+    if (next < 0 || (int32_t)(head[q].frame - head[next].frame) < 0) next = q;
+  }
+  return next;
+}
+
+// applies a time-stamped event in the audio task
+inline void dispatch_synth_event(const SynthEvent &event) {
+  uint8_t chan = (event.status & 0x0F) + 1;
+  switch (event.status & 0xF0) {
+    case 0xE0:
+      handlePitchBend(chan, (int)(event.data1 | (event.data2 << 7)) - 8192);
       break;
-    case CC_303_VOLUME:
-      //Synth.setVolume(amp2dBWithCheck((int)127-(int)cc_value, 0.000001f));
+    case 0x90:
+      handleNoteOn(chan, event.data1, event.data2);
       break;
-    case CC_303_DISTORTION:
+    case 0x80:
+      handleNoteOff(chan, event.data1, event.data2);
       break;
-    case CC_303_WAVEFORM:
-      Synth.setWaveform(MIDI_NORM * cc_value);
+    case 0xB0:
+      handleCC(chan, event.data1, event.data2);
       break;
-    case  CC_303_PORTAMENTO:
+    case 0xF0:
+      apply_clock_event(event);
       break;
-    /*
-#define CC_303_PORTATIME    5
-#define CC_303_VOLUME       7
-#define CC_303_PORTAMENTO   65
-#define CC_303_PAN          10
-#define CC_303_WAVEFORM     70
-#define CC_303_RESO         71
-#define CC_303_CUTOFF       74
-#define CC_303_ATTACK       73
-#define CC_303_DECAY        72
-#define CC_303_ENVMOD_LVL   75
-#define CC_303_ACCENT_LVL   76
-#define CC_303_REVERB_SEND  91
-#define CC_303_DELAY_SEND   92
-#define CC_303_DISTORTION   94
-#define CC_303_OVERDRIVE    95
-#define CC_303_SATURATOR    128
-*/
-    case CC_ANY_RESET_CCS:
-    case CC_ANY_NOTES_OFF:
-    case CC_ANY_SOUND_OFF:
-      Synth.allNotesOff();
-      break; 
-
   }
 }
 
-void handleProgramChange(uint8_t inChannel, uint8_t number) {
+#ifdef MIDI_VIA_SERIAL2
+// MIDI input from the UART. The serial driver calls this from its event task as soon as bytes
+// have arrived, so neither the latency nor the jitter depend on what loop() is doing. Each byte is
+// time-stamped on the audio frame clock (taking into account that the earlier bytes of a chunk
+// arrived one byte time of 320us apart) and the parsed messages for the synth go into the queue
+// of the live events. The audio task applies them in a later block at the sample of their time
+// stamp, so the latency from the arrival to the output is constant - except that an event can't be
+// applied in the past: one whose frame has already been rendered (it arrived while its block was
+// being rendered, or the audio task is late) is applied at the start of the next block, so it
+// comes up to one block later than the others.
+static rosic::MidiParser midi_parser;
+
+void midi_uart_receive() {
+  uint32_t now = audio_frame_clock();
+  int n = Serial2.available();
+  for (int i = 0; i < n; i++) {
+    int b = Serial2.read();
+    if (b < 0) break;
+    rosic::MidiMessage msg;
+    if (midi_parser.parseByte((uint8_t)b, msg)) {
+      uint32_t frame = now - (uint32_t)(((n - 1 - i) * SAMPLE_RATE * 10) / 31250);
+      handle_midi_message(msg, frame);
+#ifdef MIDI_SOFT_THRU
+      midi_out_send(msg.status, msg.data1, msg.data2);
+#endif
+    }
+  }
+#ifdef MIDI_SOFT_THRU
+  midi_out_kick();
+#endif
 }
+#endif
 
-inline void handlePitchBend(uint8_t inChannel, int number) {
-  float semitones = ((((float)number + 8191.5f) * (float)TWO_DIV_16383 ) - 1.0f ) * 2.0f;
-  Synth.setPitchBend(semitones);
+// routes a parsed message: the channel messages, the clock and the transport messages are queued
+// for the synth, the other system messages are ignored
+void handle_midi_message(const rosic::MidiMessage &msg, uint32_t frame) {
+  switch (msg.status) {
+    case 0xF8: case 0xFA: case 0xFB: case 0xFC: case 0xF2:
+      push_synth_event(LIVE_EVENTS, frame, msg.status, msg.data1, msg.data2);
+      return;
+  }
+  if (msg.status >= 0xF0) return;
+  if ((msg.status & 0xF0) == 0xC0) {
+    handleProgramChange((msg.status & 0x0F) + 1, msg.data1);
+    return;
+  }
+  push_synth_event(LIVE_EVENTS, frame, msg.status, msg.data1, msg.data2);
 }
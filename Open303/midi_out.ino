@@ -0,0 +1,65 @@
+// MIDI output. Everything that goes out (notes of the sequencers, clock, soft thru) is written into
+// a ring buffer, which never blocks the sender, no matter if that is the audio task, the jukebox or
+// the UART event task. A small task, woken after each audio block, moves the bytes on into the
+// transmit FIFO of the UART - never more than fit, so the write doesn't block either. The FIFO is
+// then emptied by the UART hardware in the background.
+
+#if defined MIDI_VIA_SERIAL2
+  #define MIDI_OUT_PORT Serial2
+#elif defined MIDI_VIA_SERIAL
+  #define MIDI_OUT_PORT Serial
+#endif
+
+TaskHandle_t MidiOutTask = NULL;
+
+#ifdef MIDI_OUT_PORT
+static rosic::MidiOutBuffer midi_out_buffer;
+static portMUX_TYPE midi_out_mux = portMUX_INITIALIZER_UNLOCKED; // serializes the writers
+
+static void midi_out_task(void *userData) {
+  uint8_t chunk[32];
+  while (true) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    int room = MIDI_OUT_PORT.availableForWrite();
+    while (room > 0) {
+      int n = midi_out_buffer.read(chunk, room < (int)sizeof(chunk) ? room : (int)sizeof(chunk));
+      if (n == 0) break;
+      MIDI_OUT_PORT.write(chunk, n);
+      room -= n;
+    }
+  }
+}
+#endif
+
+void midi_out_init() {
+#ifdef MIDI_OUT_PORT
+  xTaskCreatePinnedToCore( midi_out_task, "MidiOutTask", 2048, NULL, 3, &MidiOutTask, 1 );
+#endif
+}
+
+// queues a message for MIDI out, can be called from any task. Returns false if it was dropped
+// because the buffer is full.
+bool RENDER_CODE midi_out_send(uint8_t status, uint8_t data1, uint8_t data2) {
+#ifdef MIDI_OUT_PORT
+  rosic::MidiMessage msg;
+  msg.status = status;
+  msg.data1  = data1;
+  msg.data2  = data2;
+  portENTER_CRITICAL(&midi_out_mux);
+  bool ok = midi_out_buffer.writeMessage(msg);
+  portEXIT_CRITICAL(&midi_out_mux);
+  return ok;
+#else
+  return false;
+#endif
+}
+
+// lets the output task move the queued bytes to the UART
+void RENDER_CODE midi_out_kick() {
+  if (MidiOutTask != NULL) xTaskNotifyGive(MidiOutTask);
+}
+
+// receives the notes of the synth's own sequencer (called from the audio task)
+void RENDER_CODE midi_out_sequencer_note(int key, int velocity) {
+  midi_out_send(0x90 | (SYNTH1_MIDI_CHAN - 1), (uint8_t)key, (uint8_t)velocity);
+}
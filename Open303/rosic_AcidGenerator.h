@@ -0,0 +1,201 @@
+#ifndef rosic_AcidGenerator_h
+#define rosic_AcidGenerator_h
+
+// standard-library includes:
+#include <stdint.h>
+
+// rosic-indcludes:
+#include "GlobalDefinitions.h"
+
+namespace rosic
+{
+
+  /**
+
+  This is a class for representing one generated acid line: 16 steps of MIDI notes (where 0
+  means rest) and bitmasks for the accent and glide flags of the steps.
+
+  */
+
+  class AcidLine
+  {
+  public:
+
+    static const int numSteps = 16;
+
+    /** Size of a serialized line in bytes: the notes followed by the accent and glide masks
+    (little endian). */
+    static const int serializedSize = numSteps + 4;
+
+    uint8_t  notes[numSteps];
+    uint16_t accent;
+    uint16_t glide;
+
+    AcidLine()
+    {
+      for(int i=0; i<numSteps; i++)
+        notes[i] = 0;
+      accent = 0;
+      glide  = 0;
+    }
+
+    /** Writes the line into the buffer, which must have room for serializedSize bytes. */
+    void serialize(uint8_t *buffer) const
+    {
+      for(int i=0; i<numSteps; i++)
+        buffer[i] = notes[i];
+      buffer[numSteps+0] = (uint8_t) (accent & 0xFF);
+      buffer[numSteps+1] = (uint8_t) (accent >> 8);
+      buffer[numSteps+2] = (uint8_t) (glide  & 0xFF);
+      buffer[numSteps+3] = (uint8_t) (glide  >> 8);
+    }
+
+  };
+
+  /**
+
+  This is the pattern generator of the "Endless Acid Banger" (by Vitling) wrapped into a class
+  with an explicit random state. The jukebox draws all randomness from a 16 bit Galois LFSR (the
+  seeds in its memories depend on that), while generateBulk draws from a 64 bit xorshift
+  generator, which doesn't repeat within any corpus of practical size. Either way, the output is
+  completely determined by the seeds and does not depend on the platform. Entropy may be mixed in
+  explicitly via addEntropy(), if that is desired.
+
+  */
+
+  class AcidGenerator
+  {
+
+  public:
+
+    static const int maxNoteSetSize = 16;
+
+    //---------------------------------------------------------------------------------------------
+    // construction/destruction:
+
+    /** Constructor. */
+    AcidGenerator(uint16_t seed = 0x1234)
+    {
+      setState(seed);
+      setBulkSeed(seed);
+      bulk = false;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    // setup:
+
+    /** Sets the state of the LFSR. Zero is its fixed point (all random numbers would be zero
+    from then on), so it is replaced by another one. */
+    void setState(uint16_t newState) { state = nonZero(newState); }
+
+    /** Seeds the 64 bit generator of generateBulk. Any seed is fine, also 0. */
+    void setBulkSeed(uint64_t seed)
+    {
+      // splitmix64, such that neighbouring seeds give unrelated sequences:
+      seed += 0x9E3779B97F4A7C15ULL;
+      seed  = (seed ^ (seed >> 30)) * 0xBF58476D1CE4E5B9ULL;
+      seed  = (seed ^ (seed >> 27)) * 0x94D049BB133111EBULL;
+      seed ^= seed >> 31;
+      bulkState = seed != 0 ? seed : 0x9E3779B97F4A7C15ULL; // zero is the fixed point of xorshift
+    }
+
+    /** Mixes some entropy into the state. */
+    uint16_t addEntropy(uint16_t data)
+    {
+      state = nonZero(lfsrNext((state << 1) ^ data));
+      return state;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    // inquiry:
+
+    /** Returns the state of the random generator. */
+    uint16_t getState() const { return state; }
+
+    //---------------------------------------------------------------------------------------------
+    // random numbers:
+
+    /** Advances the generator and returns the new state (the upper 16 bits of the output of the
+    64 bit generator within generateBulk). */
+    INLINE uint16_t getRaw()
+    {
+      if( bulk )
+      {
+        // xorshift64*:
+        bulkState ^= bulkState >> 12;
+        bulkState ^= bulkState << 25;
+        bulkState ^= bulkState >> 27;
+        return (uint16_t) ((bulkState * 0x2545F4914F6CDD1DULL) >> 48);
+      }
+      state = lfsrNext(state);
+      return state;
+    }
+
+    /** Returns a random number between 0 and max-1 (0, if max is 0). */
+    INLINE uint16_t getInt(uint16_t max)
+    {
+      if( max == 0 )
+        return 0;
+      return getRaw() % max;
+    }
+
+    /** Returns a random number between min and max-1 (like Arduino's random(min, max)). */
+    INLINE int getInt(int min, int max)
+    {
+      if( max <= min )
+        return min;
+      return min + getInt((uint16_t) (max-min));
+    }
+
+    /** Returns true with the given chance in percent. */
+    INLINE bool flip(uint8_t percentChance) { return getInt(100) < percentChance; }
+
+    //---------------------------------------------------------------------------------------------
+    // pattern generation:
+
+    /** Generates a set of notes (a random root note plus a random choice among the typical acid
+    interval sets) into noteSet, which must have room for maxNoteSetSize notes. Returns the number
+    of notes in the set. */
+    int generateNoteSet(uint8_t *noteSet);
+
+    /** Generates a melody from the given note set. */
+    void generateMelody(const uint8_t *noteSet, int noteSetSize, AcidLine *line);
+
+    /** Generates the melody for the given seed and voice (like the jukebox does it for its
+    memories) without disturbing the state of the generator. This stays on the 16 bit LFSR, for
+    the melodies of the jukebox to stay the same - so seeds which differ only in bit 15 give the
+    same melody. */
+    void generateMelody(const uint8_t *noteSet, int noteSetSize, uint16_t seed, uint8_t voice,
+      AcidLine *line);
+
+    /** Generates numLines lines into the buffer, which must have room for
+    numLines * AcidLine::serializedSize bytes. A new note set is generated for every
+    linesPerNoteSet lines - just like pressing the buttons of the jukebox. This is meant for
+    building large corpora of musical input for the synth, so all of it is drawn from the 64 bit
+    generator (see setBulkSeed), and successive calls continue the sequence. */
+    void generateBulk(uint8_t *buffer, int numLines, int linesPerNoteSet = 16);
+
+    //=============================================================================================
+
+  protected:
+
+    INLINE static uint16_t lfsrNext(uint16_t x)
+    {
+      uint16_t y = x >> 1;
+      if( x & 1 )
+        y ^= 0xb400;
+      return y;
+    }
+
+    // the LFSR state that stands in for 0:
+    INLINE static uint16_t nonZero(uint16_t x) { return x != 0 ? x : (uint16_t) 0xACE1; }
+
+    uint16_t state;     // of the LFSR
+    uint64_t bulkState; // of the 64 bit generator, never 0
+    bool     bulk;      // draw from the 64 bit generator (within generateBulk)
+
+  };
+
+} // end namespace rosic
+
+#endif // rosic_AcidGenerator_h
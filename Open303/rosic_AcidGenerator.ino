@@ -0,0 +1,94 @@
+#include "rosic_AcidGenerator.h"
+using namespace rosic;
+
+// the interval sets (relative to the root note) from which the note sets are chosen, terminated
+// by -1:
+static const int8_t acidNoteSets[][AcidGenerator::maxNoteSetSize] =
+{
+  { 0, 0, 12, 24, 27, -1 },
+  { 0, 0, 0, 12, 10, 19, 26, 27, -1 },
+  { 0, 0, 0, 1, 7, 10, 12, 13, -1 },
+  { 0, -1 },
+  { 0, 0, 0, 0, 0, 0, 1, 13, 25, -1 },
+  { 0, 0, 0, 12, 24, -1 },
+  { 0, 0, 12, 12, 18, 24, 24, -1 },
+  { 0, 0, 7, 14, 24, 24, -1 },
+  { 0, 0, 12, 14, 15, 19, -1 },
+  { 0, 0, 0, 12, 12, 13, 16, 19, 22, 24, 25, -1 },
+  { 0, 0, 0, 7, 12, 15, 17, 20, 24, -1 },
+};
+static const int numAcidNoteSets = sizeof(acidNoteSets) / sizeof(acidNoteSets[0]);
+
+//-------------------------------------------------------------------------------------------------
+// pattern generation:
+
+int AcidGenerator::generateNoteSet(uint8_t *noteSet)
+{
+  // random root note and random choice of the intervals:
+  uint8_t root = (uint8_t) (getInt(15) + 28);
+  int     set  = getInt(numAcidNoteSets);
+
+  int i;
+  for(i=0; i<maxNoteSetSize; i++)
+  {
+    int8_t note = acidNoteSets[set][i];
+    if( note < 0 )
+      break;
+    noteSet[i] = root + note;
+  }
+  return i;
+}
+
+void AcidGenerator::generateMelody(const uint8_t *noteSet, int noteSetSize, AcidLine *line)
+{
+  uint8_t density = 255;
+
+  line->accent = 0;
+  line->glide  = 0;
+  for(int i=0; i<AcidLine::numSteps; i++)
+  {
+    // notes are more likely on the beats than in between:
+    uint8_t chance = ((uint16_t) density
+      * (i % 4 == 0 ?  90 : (i % 3 == 0 ?  80 : (i % 2 == 0 ?  50 : 10)))) >> 8;
+    if( flip(chance) )
+    {
+      line->notes[i] = noteSet[getInt((uint16_t) noteSetSize)];
+      if( flip(30) )
+        line->accent |= 1u << i;
+      if( flip(70) )
+        line->glide  |= 1u << i;
+    }
+    else
+      line->notes[i] = 0;
+  }
+}
+
+void AcidGenerator::generateMelody(const uint8_t *noteSet, int noteSetSize, uint16_t seed,
+  uint8_t voice, AcidLine *line)
+{
+  uint16_t oldState = state;
+  state = nonZero((uint16_t) ((seed << 1) ^ voice));
+  generateMelody(noteSet, noteSetSize, line);
+  state = oldState;
+}
+
+void AcidGenerator::generateBulk(uint8_t *buffer, int numLines, int linesPerNoteSet)
+{
+  uint8_t  noteSet[maxNoteSetSize];
+  int      noteSetSize = 0;
+  AcidLine line;
+
+  if( linesPerNoteSet < 1 )
+    linesPerNoteSet = 1;
+
+  bulk = true;
+  for(int n=0; n<numLines; n++)
+  {
+    if( n % linesPerNoteSet == 0 )
+      noteSetSize = generateNoteSet(noteSet);
+    generateMelody(noteSet, noteSetSize, &line);
+    line.serialize(buffer);
+    buffer += AcidLine::serializedSize;
+  }
+  bulk = false;
+}
@@ -18,11 +18,12 @@ namespace rosic
   {
   public:
 
-    int  key;
-    int  octave;
-    bool accent;
-    bool slide;
-    bool gate;
+    int   key;
+    int   octave;
+    bool  accent;
+    bool  slide;
+    bool  gate;
+    float timing; // micro-timing offset in MIDI clock ticks (6 per step), negative is early
 
     AcidNote()
     {
@@ -31,10 +32,14 @@ namespace rosic
       accent = false;
       slide  = false;
       gate   = false;
+      timing = 0.f;
     }
 
     bool isInDefaultState()
-    { return key == 0 && octave == 0 && accent == false && slide == false && gate == false; }
+    { 
+      return key == 0 && octave == 0 && accent == false && slide == false && gate == false 
+        && timing == 0.f; 
+    }
 
   };
 
@@ -77,6 +82,16 @@ namespace rosic
     /** Sets the gate flag for one of the steps. */
     void setGate(int step, bool shouldBeOpen) { notes[step].gate = shouldBeOpen; }
 
+    /** Sets the micro-timing offset for one of the steps in MIDI clock ticks (6 ticks per step). 
+    Negative values move the step earlier, positive values later. The offset is clipped to half a 
+    step in either direction. */
+    void setTiming(int step, float newOffsetInTicks) 
+    { notes[step].timing = clip(newOffsetInTicks, -maxTimingOffset, maxTimingOffset); }
+
+    /** Sets the swing in percent. 50% is straight, 66.7% is triplet feel and 75% is the maximum 
+    where the off-beat 16ths are delayed by half a step. */
+    void setSwing(float newSwing) { swing = clip(newSwing, 50.f, 75.f); }
+
     /** Clears all notes in the pattern. */
     void clear();
 
@@ -118,6 +133,23 @@ namespace rosic
     /** Returns the gate flag for one of the steps. */
     bool getGate(int step) const { return notes[step].gate; }
 
+    /** Returns the micro-timing offset for one of the steps in MIDI clock ticks. */
+    float getTiming(int step) const { return notes[step].timing; }
+
+    /** Returns the swing in percent. */
+    float getSwing() const { return swing; }
+
+    /** Returns the total timing offset of a step in MIDI clock ticks, which is the sum of the 
+    swing delay (for the off-beat 16ths) and the step's own micro-timing. The result is clipped to 
+    half a step in either direction, such that consecutive steps never change their order. */
+    float getTimingOffset(int step) const
+    {
+      float offset = notes[step].timing;
+      if( step & 1 )
+        offset += (swing-50.f) * 0.02f * clockTicksPerStep;
+      return clip(offset, -maxTimingOffset, maxTimingOffset);
+    }
+
     /** Returns the maximum number of steps. */
     static int getMaxNumSteps() { return maxNumSteps; }
 
@@ -137,8 +169,12 @@ namespace rosic
     static const int maxNumSteps = 16;
     AcidNote notes[maxNumSteps];
 
+    static const int clockTicksPerStep = 6;
+    static constexpr float maxTimingOffset = 0.5f * clockTicksPerStep;
+
     int    numSteps;         // number of steps in the pattern
     float stepLength;       // step length in step units (16th notes)
+    float swing;            // swing in percent (50 is straight)
 
   };
 
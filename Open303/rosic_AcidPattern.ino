@@ -5,6 +5,7 @@ AcidPattern::AcidPattern()
 {
   numSteps   = 16;
   stepLength = 0.5;
+  swing      = 50.0;
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -19,7 +20,9 @@ void AcidPattern::clear()
     notes[i].accent = false;
     notes[i].slide  = false;
     notes[i].gate   = false;
+    notes[i].timing = 0.0;
   }
+  swing = 50.0;
 }
 
 void AcidPattern::randomize()
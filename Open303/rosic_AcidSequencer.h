@@ -9,7 +9,53 @@ namespace rosic
 
   /**
 
-  This is a sequencer for typical acid-lines involving slides and accents.
+  This is a class for representing one entry of a song, i.e. a pattern that is played a given 
+  number of times with some transposition applied.
+
+  */
+
+  class AcidSongEntry
+  {
+  public:
+
+    int pattern;   // index of the pattern to play
+    int repeats;   // how many times the pattern is played before we move on
+    int transpose; // transposition in semitones
+
+    AcidSongEntry()
+    {
+      pattern   = 0;
+      repeats   = 1;
+      transpose = 0;
+    }
+
+  };
+
+  /**
+
+  This is a class for the patterns and the song of an AcidSequencer. They are only read when a 
+  step is prefetched and take up much more memory than the rest of the sequencer, so they are kept 
+  apart from the sequencer's audio-rate state (@see Open303ColdData).
+
+  */
+
+  class AcidSequencerData
+  {
+  public:
+
+    static const int numPatterns   = 16;
+    static const int maxSongLength = 64;
+
+    AcidPattern   patterns[numPatterns];
+    AcidSongEntry song[maxSongLength];
+
+  };
+
+  /**
+
+  This is a sequencer for typical acid-lines involving slides and accents. The patterns and the 
+  song live in an AcidSequencerData object which is passed to the constructor and must outlive the 
+  sequencer.
 
   \todo: make the permissibility-thing work correctly
 
@@ -29,11 +75,14 @@ namespace rosic
       NUM_SEQUENCER_MODES
     };
 
+    /** Number of MIDI clock ticks (at 24 per quarter note) per step of the sequencer. */
+    static const int clockTicksPerStep = 6;
+
     //---------------------------------------------------------------------------------------------
     // construction/destruction:
 
     /** Constructor. */
-    AcidSequencer();   
+    AcidSequencer(AcidSequencerData *data);
 
     //---------------------------------------------------------------------------------------------
     // setup:
@@ -44,6 +93,11 @@ namespace rosic
     /** Sets the tempo in BPM. */
     void setTempo(float newTempoInBpm) { bpm = newTempoInBpm; }
 
+    /** Sets the rate (in MIDI clock ticks per sample) at which the sequencer advances in HOST_SYNC
+    mode. This is supposed to be updated on each incoming clock tick, @see MidiClockSync. The 
+    tempo is updated accordingly, such that the gate lengths follow the clock. */
+    void setClockRate(float newTicksPerSample);
+
     /** Sets the key in one of the patterns for one of the steps (between 0...11, 0 is C). */
     void setKey(int pattern, int step, int newKey);
 
@@ -79,6 +133,17 @@ namespace rosic
     /** Toggles the permissibility of a key on/off. */
     void toggleKeyPermissibility(int key);
 
+    /** Switches song mode on/off. In song mode, the sequencer walks through the list of song 
+    entries instead of looping the active pattern. The song is looped as a whole. */
+    void setSongMode(bool shouldPlaySong) { songMode = shouldPlaySong; }
+
+    /** Removes all entries from the song. */
+    void clearSong() { songLength = 0; }
+
+    /** Appends an entry to the song that plays the given pattern 'repeats' times, transposed by 
+    'transpose' semitones. Returns false when the song is full or the arguments are invalid. */
+    bool appendToSong(int pattern, int repeats = 1, int transpose = 0);
+
     //---------------------------------------------------------------------------------------------
     // inquiry:
 
@@ -111,6 +176,23 @@ namespace rosic
     /** Returns, if the given key is among the permissible ones. */
     bool isKeyPermissible(int key);
 
+    /** Returns true when the sequencer is in song mode. */
+    bool isInSongMode() const { return songMode; }
+
+    /** Returns the number of entries in the song. */
+    int getSongLength() const { return songLength; }
+
+    /** Returns the maximum number of entries in a song. */
+    static int getMaxSongLength() { return maxSongLength; }
+
+    /** Returns the index of the song entry that is currently playing. */
+    int getSongPosition() const { return songPosition; }
+
+    /** Returns the position in MIDI clock ticks (since the start or the last locate) in HOST_SYNC
+    mode. The fractional part is the phase between two ticks. This is the position on the straight
+    grid, i.e. not affected by swing and micro-timing. */
+    float getClockPosition() const { return clockTicks + playedOffset + tickPhase; }
+
     //---------------------------------------------------------------------------------------------
     // audio processing:
 
@@ -120,13 +202,11 @@ namespace rosic
     /** Returns the next note that will be scheduled - after getNote() has returned a non-NULL 
     pointer, this will be the next non-NULL note that will be returned. So, if an event has 
     occurred at some time instant, you may investigate the next upcoming event beforehand by 
-    calling this function. */
-    INLINE AcidNote* getNextScheduledNote() 
-    { 
-      AcidNote* note = patterns[activePattern].getNote(step);
-      note->key      = getClosestPermissibleKey(note->key); 
-      return note;
-    }
+    calling this function. The note is prefetched one step ahead (with the key already 
+    quantized and transposed), so this also looks across pattern boundaries in song mode. The
+    step's timing offset (swing and micro-timing) is already taken into account in the time at 
+    which getNote() returns it. */
+    INLINE AcidNote* getNextScheduledNote() { return &scheduledNote; }
 
     /** Returns the key among the permissible ones which is closest to the given key - if two keys 
     are at the same distance, it returns the lower of them. If the passed key is itself 
@@ -142,6 +222,14 @@ namespace rosic
     /** Lets the sequencer stop playing. */
     void stop();
 
+    /** Lets the sequencer continue playing from the current position (i.e. the step after the 
+    last one played, or the step that was set by locate). */
+    void continuePlayback();
+
+    /** Sets the position (in steps from the start of the pattern or the song) from which the
+    sequencer will continue. This is used for MIDI song position pointers. */
+    void locate(int newStep);
+
     //---------------------------------------------------------------------------------------------
     // others:
 
@@ -149,8 +237,20 @@ namespace rosic
 
   protected:
 
-    static const int numPatterns = 16;
-    AcidPattern patterns[numPatterns];
+    /** Advances the lookahead position by one step and resolves the note found there into 
+    scheduledNote. When the lookahead crosses the end of a pattern in song mode, the next song 
+    entry is resolved here - that is, one step before the pattern boundary is actually played - 
+    such that the boundary step itself does not have to do any extra work. */
+    void prefetchNextNote();
+
+    /** Resolves the note at the lookahead position into scheduledNote. */
+    void resolveScheduledNote();
+
+    static const int numPatterns   = AcidSequencerData::numPatterns;
+    static const int maxSongLength = AcidSequencerData::maxSongLength;
+
+    AcidNote playedNote;       // copy of the note returned by getNote()
+    AcidNote scheduledNote;    // prefetched (quantized and transposed) note for the next step
 
     int    activePattern;      // the currently selected pattern
     bool   running;            // flag to indicate that sequencer is running
@@ -158,10 +258,25 @@ namespace rosic
     float sampleRate;         // the sample-rate
     float bpm;                // the tempo in bpm
     int    countDown;          // a sample-countdown - counts down for the next step to occur
-    int    step;               // the current step
+    int    step;               // the step of the prefetched note
     int    sequencerMode;      // the selected mode for the sequencer
     float driftError;         // to keep track and compensate for accumulating timing error
+    float playedOffset;       // timing offset of the played note in clock ticks
+    float scheduledOffset;    // timing offset of the prefetched note in clock ticks
+    float tickPhase;          // clock ticks elapsed since the last step (HOST_SYNC mode)
+    float tickIncrement;      // clock ticks per sample (HOST_SYNC mode)
+    int    clockTicks;         // clock position of the last step (HOST_SYNC mode)
     bool   keyPermissible[13]; // array of flags to indicate if a particular key is permissible
+    bool   songMode;           // flag to indicate that we walk through the song entries
+    int    songLength;         // number of used entries in the song
+    int    songPosition;       // song entry that is currently playing
+    int    scheduledPattern;   // pattern of the prefetched note
+    int    scheduledPosition;  // song entry of the prefetched note
+    int    scheduledRepeat;    // repetition (within its song entry) of the prefetched note
+    int    scheduledTranspose; // transposition of the prefetched note
+
+    AcidPattern   *patterns;   // the patterns (in the AcidSequencerData)
+    AcidSongEntry *song;       // the song entries (in the AcidSequencerData)
 
   };
 
@@ -169,41 +284,66 @@ namespace rosic
   // from here: definitions of the functions to be inlined, i.e. all functions which are supposed 
   // to be called at audio-rate (they can't be put into the .cpp file):
 
-  INLINE AcidNote* AcidSequencer::getNote()
+  RENDER_INLINE AcidNote* AcidSequencer::getNote()
   {
     if( running == false )
       return NULL;
 
-    if( countDown > 0 )
+    // the distance between two notes is one step on the grid plus the difference of their timing
+    // offsets (which are limited to half a step, so it can't get negative):
+    float ticksToNextNote;
+
+    if( sequencerMode == HOST_SYNC )
+    {
+      // advance at the rate of the external clock - the grid steps occur at every 6th tick:
+      ticksToNextNote = clockTicksPerStep + scheduledOffset - playedOffset;
+      tickPhase      += tickIncrement;
+      if( tickPhase < ticksToNextNote )
+        return NULL;
+      tickPhase  -= ticksToNextNote;
+      clockTicks += clockTicksPerStep;
+    }
+    else if( countDown > 0 )
     {
       countDown--;
       return NULL;
     }
-    else
+
+    // the note for this step has been resolved one step earlier - here we only commit it 
+    // (which includes the switch to the next song entry when we cross a pattern boundary):
+    playedNote    = scheduledNote;
+    playedOffset  = scheduledOffset;
+    activePattern = scheduledPattern;
+    songPosition  = scheduledPosition;
+    prefetchNextNote();
+
+    if( sequencerMode != HOST_SYNC )
     {
-      float secondsToNextStep = beatsToSeconds(0.25, bpm);
-      float samplesToNextStep = secondsToNextStep * sampleRate;
-      countDown                = roundToInt(samplesToNextStep);
+      ticksToNextNote         = clockTicksPerStep + scheduledOffset - playedOffset;
+      float secondsToNextStep = beatsToSeconds(0.25f, bpm);
+      float samplesToNextStep = secondsToNextStep * sampleRate * ticksToNextNote 
+                                / clockTicksPerStep;
+      countDown               = roundToInt(samplesToNextStep);
 
       // keep track of accumulating error due to rounding and compensate when the accumulated error
       // exceeds half a sample:
       driftError += countDown - samplesToNextStep;
-      if( driftError < -0.5 ) // negative errors indicate that we are too early
+      if( driftError < -0.5f ) // negative errors indicate that we are too early
       {
-        driftError += 1.0;
+        driftError += 1.0f;
         countDown  += 1;
       }
-      else if( driftError >= 0.5 )
+      else if( driftError >= 0.5f )
       {
-        driftError -= 1.0;
+        driftError -= 1.0f;
         countDown  -= 1;
       }
 
-      AcidNote* note = patterns[activePattern].getNote(step);
-      note->key      = getClosestPermissibleKey(note->key);
-      step           = (step+1) % patterns[activePattern].getNumSteps();
-      return note; 
+      // this call has already been the first sample of the countdown:
+      countDown--;
     }
+
+    return &playedNote; 
   }
 
   INLINE int AcidSequencer::getClosestPermissibleKey(int key)
@@ -4,8 +4,10 @@ using namespace rosic;
 //-------------------------------------------------------------------------------------------------
 // construction/destruction:
 
-AcidSequencer::AcidSequencer()
+AcidSequencer::AcidSequencer(AcidSequencerData *data)
 {
+  patterns      = data->patterns;
+  song          = data->song;
   sampleRate    = SAMPLE_RATE;
   bpm           = 130.0;
   activePattern = 0;
@@ -14,7 +16,20 @@ AcidSequencer::AcidSequencer()
   step          = 0;
   sequencerMode = OFF;
   driftError    = 0.0;
+  playedOffset    = 0.0;
+  scheduledOffset = 0.0;
+  tickPhase     = 0.0;
+  tickIncrement = 0.0;
+  clockTicks    = 0;
   modeChanged   = false;
+  songMode      = false;
+  songLength    = 0;
+  songPosition  = 0;
+
+  scheduledPattern   = 0;
+  scheduledPosition  = 0;
+  scheduledRepeat    = 0;
+  scheduledTranspose = 0;
 
   for(int k=0; k<=12; k++)
     keyPermissible[k] = true;
@@ -27,10 +42,19 @@ AcidSequencer::AcidSequencer()
 
 void AcidSequencer::setSampleRate(float newSampleRate)
 {
-  if( newSampleRate > 0.0 )
+  if( newSampleRate > 0.0f )
     sampleRate = newSampleRate;
 }
 
+void AcidSequencer::setClockRate(float newTicksPerSample)
+{
+  if( newTicksPerSample > 0.0f )
+  {
+    tickIncrement = newTicksPerSample;
+    bpm           = 60.0f * sampleRate * newTicksPerSample / (4*clockTicksPerStep);
+  }
+}
+
 void AcidSequencer::setMode(int newMode)
 {
   if( newMode >= 0 && newMode < NUM_SEQUENCER_MODES )
@@ -52,6 +76,18 @@ void AcidSequencer::toggleKeyPermissibility(int key)
     keyPermissible[key] = !keyPermissible[key];
 }
 
+bool AcidSequencer::appendToSong(int pattern, int repeats, int transpose)
+{
+  if( songLength >= maxSongLength || pattern < 0 || pattern >= numPatterns || repeats < 1 )
+    return false;
+
+  song[songLength].pattern   = pattern;
+  song[songLength].repeats   = repeats;
+  song[songLength].transpose = transpose;
+  songLength++;
+  return true;
+}
+
 //-------------------------------------------------------------------------------------------------
 // inquiry:
 
@@ -85,11 +121,27 @@ bool AcidSequencer::isKeyPermissible(int key)
 
 void AcidSequencer::start()
 {
-  // set up members such that we will trap in the else-branch in the next call to getNote():
-  running    = true;
-  countDown  = -1;
-  step       = 0;
-  driftError = 0.0;
+  // set the lookahead to the first step of the active pattern or the song:
+  if( songMode && songLength > 0 )
+  {
+    scheduledPosition  = 0;
+    scheduledPattern   = song[0].pattern;
+    scheduledTranspose = song[0].transpose;
+  }
+  else
+  {
+    scheduledPosition  = 0;
+    scheduledPattern   = activePattern;
+    scheduledTranspose = 0;
+  }
+  scheduledRepeat = 0;
+  step            = 0;
+  resolveScheduledNote();
+
+  // set up members such that the first step will occur in the next call to getNote() (or after 
+  // its timing offset):
+  clockTicks = -clockTicksPerStep;
+  continuePlayback();
 }
 
 void AcidSequencer::stop()
@@ -97,5 +149,98 @@ void AcidSequencer::stop()
   running = false;
 }
 
+void AcidSequencer::continuePlayback()
+{
+  // the lookahead already points to the step after the last one played (or to the step set by
+  // locate), so we just let getNote() commit it when its timing offset has elapsed - a step that 
+  // should come early can't, so it is played right away:
+  if( scheduledOffset < 0.0f )
+    scheduledOffset = 0.0;
+  float samplesPerTick = beatsToSeconds(0.25, bpm) * sampleRate / clockTicksPerStep;
+  running      = true;
+  countDown    = roundToInt(scheduledOffset * samplesPerTick);
+  driftError   = 0.0;
+  playedOffset = 0.0;
+  tickPhase    = clockTicksPerStep;
+}
+
+void AcidSequencer::locate(int newStep)
+{
+  if( newStep < 0 )
+    newStep = 0;
+  clockTicks = clockTicksPerStep * (newStep-1);
+
+  scheduledRepeat = 0;
+  if( songMode && songLength > 0 )
+  {
+    // the song is looped as a whole, so we wrap the position into the song's length first:
+    int songSteps = 0;
+    for(int i=0; i<songLength; i++)
+      songSteps += song[i].repeats * patterns[song[i].pattern].getNumSteps();
+    newStep = songSteps > 0 ? newStep % songSteps : 0;
+
+    // find the song entry (and the repetition therein) that contains the step:
+    scheduledPosition = 0;
+    while( songSteps > 0 && newStep >= patterns[song[scheduledPosition].pattern].getNumSteps() )
+    {
+      newStep -= patterns[song[scheduledPosition].pattern].getNumSteps();
+      scheduledRepeat++;
+      if( scheduledRepeat >= song[scheduledPosition].repeats )
+      {
+        scheduledRepeat = 0;
+        scheduledPosition++;
+      }
+    }
+    scheduledPattern   = song[scheduledPosition].pattern;
+    scheduledTranspose = song[scheduledPosition].transpose;
+  }
+  else
+  {
+    scheduledPosition  = 0;
+    scheduledPattern   = activePattern;
+    scheduledTranspose = 0;
+    if( patterns[activePattern].getNumSteps() > 0 )
+      newStep %= patterns[activePattern].getNumSteps();
+  }
+  step = newStep;
+  resolveScheduledNote();
+}
+
 //-------------------------------------------------------------------------------------------------
 // others:
+
+void RENDER_CODE AcidSequencer::prefetchNextNote()
+{
+  step++;
+  if( step >= patterns[scheduledPattern].getNumSteps() )
+  {
+    step = 0;
+    if( songMode && songLength > 0 )
+    {
+      scheduledRepeat++;
+      if( scheduledPosition >= songLength || scheduledRepeat >= song[scheduledPosition].repeats )
+      {
+        scheduledRepeat   = 0;
+        scheduledPosition = (scheduledPosition+1) % songLength;
+      }
+      scheduledPattern   = song[scheduledPosition].pattern;
+      scheduledTranspose = song[scheduledPosition].transpose;
+    }
+    else
+    {
+      // follow changes of the active pattern when not in song mode:
+      scheduledPattern   = activePattern;
+      scheduledTranspose = 0;
+    }
+  }
+  resolveScheduledNote();
+}
+
+void RENDER_CODE AcidSequencer::resolveScheduledNote()
+{
+  // we work on a copy such that the quantization does not overwrite the key in the pattern:
+  scheduledNote      = *patterns[scheduledPattern].getNote(step);
+  scheduledNote.key  = getClosestPermissibleKey(scheduledNote.key);
+  scheduledNote.key += scheduledTranspose;
+  scheduledOffset    = patterns[scheduledPattern].getTimingOffset(step);
+}
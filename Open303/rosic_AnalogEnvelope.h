@@ -190,7 +190,7 @@ namespace rosic
   //-----------------------------------------------------------------------------------------------
   // inlined functions:
 
-  INLINE float AnalogEnvelope::getSample()
+  RENDER_INLINE float AnalogEnvelope::getSample()
   {
     float out;
 
@@ -21,7 +21,7 @@ AnalogEnvelope::AnalogEnvelope()
   peakByKey      = 1.0;
   timeScaleByVel = 1.0;
   timeScaleByKey = 1.0;
-  increment      = 1000.0*timeScale/sampleRate;
+  increment      = 1000.0f*timeScale/sampleRate;
   tauScale       = 1.0;
   peakScale      = 1.0;
   noteIsOn       = false;
@@ -45,11 +45,11 @@ AnalogEnvelope::~AnalogEnvelope()
 
 void AnalogEnvelope::setSampleRate(float newSampleRate)
 {
-  if( newSampleRate > 0.0 )
+  if( newSampleRate > 0.0f )
     sampleRate = newSampleRate;
 
   // adjust time increment:
-  increment = 1000.0*timeScale/sampleRate;
+  increment = 1000.0f*timeScale/sampleRate;
 
   //re-calculate coefficients for the 3 filters:
   setAttack (attackTime);
@@ -59,11 +59,11 @@ void AnalogEnvelope::setSampleRate(float newSampleRate)
 
 void AnalogEnvelope::setAttack(float newAttackTime)
 {
-  if( newAttackTime > 0.0 )
+  if( newAttackTime > 0.0f )
   {
     attackTime  = newAttackTime;
-    float tau  = (sampleRate*0.001*attackTime) * tauScale/timeScale;
-    attackCoeff = 1.0 - exp( -1.0 / tau );
+    float tau  = (sampleRate*0.001f*attackTime) * tauScale/timeScale;
+    attackCoeff = 1.0f - expf( -1.0f / tau );
   }
   else // newAttackTime <= 0
   {
@@ -82,11 +82,11 @@ void AnalogEnvelope::setHold(float newHoldTime)
 
 void AnalogEnvelope::setDecay(float newDecayTime)
 {
-  if( newDecayTime > 0.0 )
+  if( newDecayTime > 0.0f )
   {
     decayTime  = newDecayTime;
-    float tau = (sampleRate*0.001*decayTime) * tauScale/timeScale;
-    decayCoeff = 1.0 - exp( -1.0 / tau  );
+    float tau = (sampleRate*0.001f*decayTime) * tauScale/timeScale;
+    decayCoeff = 1.0f - expf( -1.0f / tau  );
   }
   else // newDecayTime <= 0
   {
@@ -96,13 +96,13 @@ void AnalogEnvelope::setDecay(float newDecayTime)
   calculateAccumulatedTimes();
 }
 
-void AnalogEnvelope::setRelease(float newReleaseTime)
+void RENDER_CODE AnalogEnvelope::setRelease(float newReleaseTime)
 {
-  if( newReleaseTime > 0.0 )
+  if( newReleaseTime > 0.0f )
   {
     releaseTime  = newReleaseTime;
-    float tau   = (sampleRate*0.001*releaseTime) * tauScale/timeScale;
-    releaseCoeff = 1.0 - exp( -1.0 / tau  );
+    float tau   = (sampleRate*0.001f*releaseTime) * tauScale/timeScale;
+    releaseCoeff = 1.0f - expf( -1.0f / tau  );
   }
   else // newReleaseTime <= 0
   {
@@ -149,7 +149,7 @@ void AnalogEnvelope::reset()
   time = 0.0f;
 }
 
-void AnalogEnvelope::noteOn(bool startFromCurrentLevel, int newKey, int newVel)
+void RENDER_CODE AnalogEnvelope::noteOn(bool startFromCurrentLevel, int /*newKey*/, int /*newVel*/)
 {
   if( !startFromCurrentLevel )
     previousOutput = startLevel;  // may lead to clicks
@@ -164,7 +164,7 @@ void AnalogEnvelope::noteOn(bool startFromCurrentLevel, int newKey, int newVel)
   outputIsZero = false;
 }
 
-void AnalogEnvelope::noteOff()
+void RENDER_CODE AnalogEnvelope::noteOff()
 {
   noteIsOn = false;
 
@@ -176,7 +176,7 @@ bool AnalogEnvelope::endIsReached()
 {
   //return false; // test
 
-  if( noteIsOn == false && previousOutput < 0.000001 )
+  if( noteIsOn == false && previousOutput < 0.000001f )
     return true;
   else
     return false;
@@ -185,7 +185,7 @@ bool AnalogEnvelope::endIsReached()
 //-------------------------------------------------------------------------------------------------
 // internal functions:
 
-void AnalogEnvelope::calculateAccumulatedTimes()
+void RENDER_CODE AnalogEnvelope::calculateAccumulatedTimes()
 {
   attPlusHld               = attackTime + holdTime;
   attPlusHldPlusDec        = attPlusHld + decayTime;
@@ -0,0 +1,156 @@
+#ifndef rosic_AudioTelemetry_h
+#define rosic_AudioTelemetry_h
+
+// standard-library includes:
+#include <stdint.h>
+
+// rosic-indcludes:
+#include "GlobalDefinitions.h"
+
+namespace rosic
+{
+
+  /**
+
+  This is a class for collecting timing statistics of the audio rendering: the render time of
+  each block in a histogram with logarithmic buckets (bucket k counts the times from 2^(k-1) up to
+  2^k - 1, bucket 0 counts zero), the longest render time so far, the load (render time over the
+  duration of the blocks) averaged over a window and its peak value, the number of blocks which
+  took longer than their duration (i.e. they would have been late without the buffering of the
+  DMA) and the number of underruns, as reported by the output driver.
+
+  The times may be given in any unit (usually CPU cycles), as long as it's the same for all of
+  them. The statistics are written by the audio task only and can be read from any other task via
+  getSnapshot, which makes a consistent copy (with a sequence counter, so the writer never waits
+  for a reader).
+
+  */
+
+  class AudioTelemetry
+  {
+
+  public:
+
+    static const int numBuckets = 32;
+
+    /** A copy of the statistics, @see getSnapshot. */
+    struct Snapshot
+    {
+      uint32_t numBlocks;              // number of blocks rendered
+      uint32_t numLateBlocks;          // blocks with a render time above their duration
+      uint32_t numUnderruns;           // underruns reported by the driver
+      uint32_t lastRenderTime;         // render time of the most recent block
+      uint32_t maxRenderTime;          // longest render time (the watermark)
+      uint32_t blockTime;              // duration of the most recent block
+      float    load;                   // load averaged over the last window (0...1, beyond on overload)
+      float    peakLoad;               // highest load of a single block
+      uint32_t histogram[numBuckets];  // number of blocks per render time bucket
+    };
+
+    //---------------------------------------------------------------------------------------------
+    // construction/destruction:
+
+    /** Constructor. */
+    AudioTelemetry();
+
+    //---------------------------------------------------------------------------------------------
+    // parameter settings:
+
+    /** Sets the length of the window over which the load is averaged (in the unit of the times). */
+    void setLoadWindow(uint32_t newWindow) { loadWindow = newWindow; }
+
+    //---------------------------------------------------------------------------------------------
+    // inquiry:
+
+    /** Returns the histogram bucket for the given time. */
+    static int getBucket(uint32_t time)
+    {
+      if( time == 0 )
+        return 0;
+      int b = 32 - __builtin_clz(time);
+      return b < numBuckets ? b : numBuckets-1;
+    }
+
+    /** Copies the statistics - this may be called from any task. */
+    void getSnapshot(Snapshot &snapshot) const;
+
+    //---------------------------------------------------------------------------------------------
+    // recording (audio task only):
+
+    /** Records the render time of a block with the given duration. */
+    INLINE void blockRendered(uint32_t renderTime, uint32_t blockTime);
+
+    /** Adds underruns reported by the driver. */
+    INLINE void addUnderruns(uint32_t numUnderruns);
+
+    //---------------------------------------------------------------------------------------------
+    // others:
+
+    /** Asks for a reset of the statistics, which is done by the audio task with the next
+    block - this may be called from any task. */
+    void requestReset() { resetRequested = true; }
+
+    //=============================================================================================
+
+  protected:
+
+    /** Resets the statistics (audio task only). */
+    void reset();
+
+    /** Marks the beginning and the end of an update of the statistics for the readers. */
+    INLINE void beginUpdate() { sequence++; __sync_synchronize(); }
+    INLINE void endUpdate()   { __sync_synchronize(); sequence++; }
+
+    Snapshot          stats;            // the statistics
+    uint64_t          renderSum;        // sum of the render times in the current window
+    uint64_t          blockSum;         // sum of the block durations in the current window
+    uint32_t          loadWindow;       // length of the window for the load
+    volatile uint32_t sequence;         // odd while the statistics are updated
+    volatile bool     resetRequested;
+
+  };
+
+  //-----------------------------------------------------------------------------------------------
+  // from here: definitions of the functions to be inlined, i.e. all functions which are supposed
+  // to be called at audio-rate (they can't be put into the .cpp file):
+
+  RENDER_INLINE void AudioTelemetry::blockRendered(uint32_t renderTime, uint32_t blockTime)
+  {
+    if( resetRequested )
+      reset();
+
+    beginUpdate();
+    stats.numBlocks++;
+    stats.histogram[getBucket(renderTime)]++;
+    stats.lastRenderTime = renderTime;
+    stats.blockTime      = blockTime;
+    if( renderTime > stats.maxRenderTime )
+      stats.maxRenderTime = renderTime;
+    if( renderTime > blockTime )
+      stats.numLateBlocks++;
+    if( blockTime > 0 && (float) renderTime > stats.peakLoad * blockTime )
+      stats.peakLoad = (float) renderTime / (float) blockTime;
+
+    renderSum += renderTime;
+    blockSum  += blockTime;
+    if( blockSum >= loadWindow && blockSum > 0 )
+    {
+      stats.load = (float) renderSum / (float) blockSum;
+      renderSum  = 0;
+      blockSum   = 0;
+    }
+    endUpdate();
+  }
+
+  RENDER_INLINE void AudioTelemetry::addUnderruns(uint32_t numUnderruns)
+  {
+    if( numUnderruns == 0 )
+      return;
+    beginUpdate();
+    stats.numUnderruns += numUnderruns;
+    endUpdate();
+  }
+
+} // end namespace rosic
+
+#endif // rosic_AudioTelemetry_h
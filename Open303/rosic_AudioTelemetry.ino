@@ -0,0 +1,50 @@
+#include "rosic_AudioTelemetry.h"
+using namespace rosic;
+
+//-------------------------------------------------------------------------------------------------
+// construction/destruction:
+
+AudioTelemetry::AudioTelemetry()
+{
+  sequence       = 0;
+  loadWindow     = 0;
+  resetRequested = false;
+  reset();
+}
+
+//-------------------------------------------------------------------------------------------------
+// inquiry:
+
+void AudioTelemetry::getSnapshot(Snapshot &snapshot) const
+{
+  uint32_t s;
+  do
+  {
+    s = sequence;
+    __sync_synchronize();
+    snapshot = stats;
+    __sync_synchronize();
+  } while( (s & 1) != 0 || s != sequence ); // the audio task has written meanwhile
+}
+
+//-------------------------------------------------------------------------------------------------
+// others:
+
+void RENDER_CODE AudioTelemetry::reset()
+{
+  beginUpdate();
+  stats.numBlocks      = 0;
+  stats.numLateBlocks  = 0;
+  stats.numUnderruns   = 0;
+  stats.lastRenderTime = 0;
+  stats.maxRenderTime  = 0;
+  stats.blockTime      = 0;
+  stats.load           = 0.0f;
+  stats.peakLoad       = 0.0f;
+  for(int b=0; b<numBuckets; b++)
+    stats.histogram[b] = 0;
+  renderSum      = 0;
+  blockSum       = 0;
+  resetRequested = false;
+  endUpdate();
+}
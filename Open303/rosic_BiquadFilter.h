@@ -106,7 +106,7 @@ namespace rosic
   //-----------------------------------------------------------------------------------------------
   // inlined functions:
 
-  INLINE float BiquadFilter::getSample(float in)
+  RENDER_INLINE float BiquadFilter::getSample(float in)
   {
     // calculate the output sample:
     float y = b0*in + b1*x1 + b2*x2 + a1*y1 + a2*y2 + TINY;
@@ -54,7 +54,7 @@ void BiquadFilter::setBandwidth(float newBandwidth)
 
 void BiquadFilter::calcCoeffs()
 {
-  float w = TWOPI*frequency* DIV_SAMPLE_RATE;
+  float w = TWOPI*frequency * (1.0f/sampleRate);
   float s, c;
   switch(mode)
   {
@@ -126,19 +126,19 @@ void BiquadFilter::calcCoeffs()
       // formula from Robert Bristow Johnson's biquad cookbook:
       sinCos(w, &s, &c);
       float alpha = s * sinhf( 0.5f*logf(2.0f) * bandwidth * w / s );
-      float scale = 1.0/(1.0+alpha);
+      float scale = 1.0f/(1.0f+alpha);
       a1 = 2.0f*c       * scale;
       a2 = (alpha-1.0f) * scale;
-      b0 = 1.0         * scale;
+      b0 = 1.0f        * scale;
       b1 = -2.0f*c      * scale;
-      b2 = 1.0         * scale;
+      b2 = 1.0f        * scale;
     }
     break;
   case PEAK: 
     {
       // formula from Robert Bristow Johnson's biquad cookbook:
       sinCos(w, &s, &c);
-      float alpha = s * sinh( 0.5*log(2.0f) * bandwidth * w / s );
+      float alpha = s * sinhf( 0.5f*logf(2.0f) * bandwidth * w / s );
       float A     = dB2amp(gain);
       float scale = 1.0f/(1.0f+alpha/A);
       a1 = 2.0f*c             * scale;
@@ -152,14 +152,14 @@ void BiquadFilter::calcCoeffs()
     {
       // formula from Robert Bristow Johnson's biquad cookbook:
       sinCos(w, &s, &c);
-      float A     = dB2amp(0.5*gain);
-      float q     = 1.0 / (2.0*sinh( 0.5*log(2.0f) * bandwidth ));
+      float A     = dB2amp(0.5f*gain);
+      float q     = 1.0f / (2.0f*sinhf( 0.5f*logf(2.0f) * bandwidth ));
       float beta  = sqrt(A) / q;
-      float scale = 1.0 / ( (A+1.0f) + (A-1.0f)*c + beta*s);
-      a1 = 2.0 *     ( (A-1.0f) + (A+1.0f)*c          ) * scale;
+      float scale = 1.0f / ( (A+1.0f) + (A-1.0f)*c + beta*s);
+      a1 = 2.0f *    ( (A-1.0f) + (A+1.0f)*c          ) * scale;
       a2 = -         ( (A+1.0f) + (A-1.0f)*c - beta*s ) * scale;
       b0 =       A * ( (A+1.0f) - (A-1.0f)*c + beta*s ) * scale;
-      b1 = 2.0 * A * ( (A-1.0f) - (A+1.0f)*c          ) * scale;
+      b1 = 2.0f * A * ( (A-1.0f) - (A+1.0f)*c          ) * scale;
       b2 =       A * ( (A+1.0f) - (A-1.0f)*c - beta*s ) * scale;
     }
     break;
@@ -180,7 +180,7 @@ void BiquadFilter::calcCoeffs()
   }
 }
 
-void BiquadFilter::reset()
+void RENDER_CODE BiquadFilter::reset()
 {
   x1 = 0.0f;
   x2 = 0.0f;
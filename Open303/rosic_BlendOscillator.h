@@ -117,30 +117,30 @@ namespace rosic
   //-----------------------------------------------------------------------------------------------
   // inlined functions:
 
-  INLINE void BlendOscillator::setFrequency(float newFrequency)
+  RENDER_INLINE void BlendOscillator::setFrequency(float newFrequency)
   {
-    if( (newFrequency > 0.0) && (newFrequency < 20000.0) )
+    if( (newFrequency > 0.0f) && (newFrequency < 20000.0f) )
       freq = newFrequency;
   }
 
   INLINE void BlendOscillator::setPulseWidth(float newPulseWidth)
   {
-    waveTable1->setSymmetry(0.01*newPulseWidth);
-    waveTable2->setSymmetry(0.01*newPulseWidth);
+    waveTable1->setSymmetry(0.01f*newPulseWidth);
+    waveTable2->setSymmetry(0.01f*newPulseWidth);
   }
 
-  INLINE void BlendOscillator::calculateIncrement()
+  RENDER_INLINE void BlendOscillator::calculateIncrement()
   {
     increment = tableLengthDbl*freq*sampleRateRec;
   }
 
-  INLINE float BlendOscillator::getSample()
+  RENDER_INLINE float BlendOscillator::getSample()
   {
     float out1, out2;
     int    tableNumber;
 
     if( waveTable1 == NULL || waveTable2 == NULL )
-      return 0.0;
+      return 0.0f;
 
     // from this increment, decide which table is to be used:
     tableNumber  = ((int)EXPOFFLT(increment));
@@ -154,10 +154,10 @@ namespace rosic
 
     int    intIndex = floorInt(phaseIndex);
     float frac     = phaseIndex  - (float) intIndex;
-    out1 = (1.0-blend) * waveTable1->getValueLinear(intIndex, frac, tableNumber);
+    out1 = (1.0f-blend) * waveTable1->getValueLinear(intIndex, frac, tableNumber);
     out2 =      blend  * waveTable2->getValueLinear(intIndex, frac, tableNumber);
     
-    out2 *= 0.5; // \todo: this is preliminary to scale the square in AciDevil we need to
+    out2 *= 0.5f; // \todo: this is preliminary to scale the square in AciDevil we need to
                  // implement something more general here (like a kind of crest-compensation in 
                  // the wavetable-class)
 
@@ -13,6 +13,7 @@ BlendOscillator::BlendOscillator()
   increment            = (tableLengthDbl*freq)/sampleRate;
   phaseIndex           = 0.0;
   startIndex           = 0.0;
+  blend                = 0.0;
   waveTable1           = NULL;
   waveTable2           = NULL;
 
@@ -37,9 +38,9 @@ BlendOscillator::~BlendOscillator()
 
 void BlendOscillator::setSampleRate(float newSampleRate)
 {
-  if( newSampleRate > 0.0 )
+  if( newSampleRate > 0.0f )
     sampleRate = newSampleRate;
-  sampleRateRec = 1.0 / sampleRate;
+  sampleRateRec = 1.0f / sampleRate;
   increment = tableLengthDbl*freq*sampleRateRec;
 }
 
@@ -68,13 +69,13 @@ void BlendOscillator::setWaveTable2(MipMappedWaveTable* newWaveTable2)
 void BlendOscillator::setStartPhase(float StartPhase)
 {
   if( (StartPhase>=0) && (StartPhase<=360) )
-    startIndex = (StartPhase/360.0)*tableLengthDbl;
+    startIndex = (StartPhase/360.0f)*tableLengthDbl;
 }
 
 //-------------------------------------------------------------------------------------------------
 // event processing:
 
-void BlendOscillator::resetPhase()
+void RENDER_CODE BlendOscillator::resetPhase()
 {
   phaseIndex = startIndex;
 }
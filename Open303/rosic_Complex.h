@@ -123,7 +123,7 @@ namespace rosic
     /** Divides this complex number by another complex number and returns the result. */
     Complex& operator/=(const Complex &z)
     {
-      float scale = 1.0 / (z.re*z.re + z.im*z.im);
+      float scale = 1.0f / (z.re*z.re + z.im*z.im);
       float reNew = scale*( re*z.re  + im*z.im  );
       float imNew = scale*( im*z.re  - re*z.im  );
       this->re     = reNew;
@@ -134,7 +134,7 @@ namespace rosic
     /** Divides this complex number by a real number and returns the result. */
     Complex& operator/=(const float &r)
     {
-      float scale = 1.0 / r;
+      float scale = 1.0f / r;
       this->re *= scale;
       this->im *= scale;
       return *this;
@@ -221,7 +221,7 @@ namespace rosic
   /** Divides two complex numbers. */
   INLINE Complex operator/(const Complex &z, const Complex &w)
   { 
-    float scale = 1.0 / (w.re*w.re + w.im*w.im);
+    float scale = 1.0f / (w.re*w.re + w.im*w.im);
     return Complex( scale*( z.re*w.re + z.im*w.im),     // real part
                     scale*( z.im*w.re - z.re*w.im)  );  // imaginary part
   }
@@ -229,7 +229,7 @@ namespace rosic
   /** Divides a complex number by a real number. */
   INLINE Complex operator/(const Complex &z, const float &r)  
   {
-    float scale = 1.0 / r;
+    float scale = 1.0f / r;
     return Complex(scale*z.re, scale*z.im);
   }
 
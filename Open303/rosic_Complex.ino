@@ -36,7 +36,7 @@ float Complex::getRadius()
 
 float Complex::getAngle()
 {
-  if((re==0.0) && (im==0))
+  if((re==0.0f) && (im==0))
     return 0.0;
   else
     return atan2(im, re);
@@ -72,18 +72,18 @@ Complex Complex::getConjugate()
 
 Complex Complex::getReciprocal()
 {
-  float scaler = 1.0 / (re*re + im*im);
+  float scaler = 1.0f / (re*re + im*im);
   return Complex(scaler*re, -scaler*im);
 }
 
 bool Complex::isReal()
 {
-  return (im == 0.0);
+  return (im == 0.0f);
 }
 
 bool Complex::isImaginary()
 {
-  return (re == 0.0);
+  return (re == 0.0f);
 }
 
 bool Complex::isInfinite()
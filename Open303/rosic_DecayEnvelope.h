@@ -84,7 +84,7 @@ namespace rosic
   //-----------------------------------------------------------------------------------------------
   // inlined functions:
 
-  INLINE float DecayEnvelope::getSample()
+  RENDER_INLINE float DecayEnvelope::getSample()
   {
     y *= c;
     return y;
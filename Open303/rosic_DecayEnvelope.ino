@@ -25,16 +25,16 @@ DecayEnvelope::~DecayEnvelope()
 
 void DecayEnvelope::setSampleRate(float newSampleRate)
 {
-  if( newSampleRate > 0.0 )
+  if( newSampleRate > 0.0f )
   {
     fs = newSampleRate;
     calculateCoefficient();
   }
 }
 
-void DecayEnvelope::setDecayTimeConstant(float newTimeConstant)
+void RENDER_CODE DecayEnvelope::setDecayTimeConstant(float newTimeConstant)
 {
-  if( newTimeConstant > 0.001 ) // at least 0.001 ms decay
+  if( newTimeConstant > 0.001f ) // at least 0.001 ms decay
   {
     tau = newTimeConstant;
     calculateCoefficient();
@@ -50,7 +50,7 @@ void DecayEnvelope::setNormalizeSum(bool shouldNormalizeSum)
 //-------------------------------------------------------------------------------------------------
 // others:
 
-void DecayEnvelope::trigger()
+void RENDER_CODE DecayEnvelope::trigger()
 {
   y = yInit;
 }
@@ -66,11 +66,11 @@ bool DecayEnvelope::endIsReached(float threshold)
 //-------------------------------------------------------------------------------------------------
 // internal functions:
 
-void DecayEnvelope::calculateCoefficient()
+void RENDER_CODE DecayEnvelope::calculateCoefficient()
 {
-  c     = exp( -1.0 / (0.001*tau*fs) );
+  c     = expf( -1.0f / (0.001f*tau*fs) );
   if( normalizeSum == true )
-    yInit = (1.0-c)/c;
+    yInit = (1.0f-c)/c;
   else  
-    yInit = 1.0/c;
+    yInit = 1.0f/c;
 }
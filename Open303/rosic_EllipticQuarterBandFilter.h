@@ -50,7 +50,7 @@ namespace rosic
   //-----------------------------------------------------------------------------------------------
   // inlined functions:
 
-  INLINE float EllipticQuarterBandFilter::getSample(float in)
+  RENDER_INLINE float EllipticQuarterBandFilter::getSample(float in)
   {
     const float a01 =   -9.1891604652189471f;
     const float a02 =   40.177553696870497f;
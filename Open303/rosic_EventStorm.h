@@ -0,0 +1,119 @@
+#ifndef rosic_EventStorm_h
+#define rosic_EventStorm_h
+
+// standard-library includes:
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// rosic-indcludes:
+#include "rosic_Open303CCMap.h"
+
+namespace rosic
+{
+
+  /**
+
+  This is a generator of worst-case event streams for the Open303, for measuring the render time
+  of blocks under load (the tail latency, which decides about underruns - not the mean). Once per
+  block, it applies a burst of events of the selected kind to the synth:
+
+  -NOTES: an accented note every block, alternately retriggered (all notes off, then a new note,
+   which recalculates the envelopes and may reset the filters) and slid to (legato)
+  -CONTROLLERS: all mapped controllers with new values plus the pitch bend, like a burst of MIDI
+   ramps - this includes the shaper controllers, which regenerate the wavetables
+  -WAVEFORM: the waveform blend, the drive and offset of the tanh shaper and the phase of the
+   square, each of which regenerates a wavetable
+  -ALL: all of the above in the same block
+
+  QUIET applies no events and gives the baseline. The streams are deterministic, so the same
+  kind gives the same events on the host and on the device. The block times of a run can be
+  summarized with getPercentiles. setBenchPattern gives the other benchmarks (dsp_bench,
+  layout_bench and LAYOUT_BENCH of the sketch) the same pattern to play.
+
+  */
+
+  class EventStorm
+  {
+
+  public:
+
+    enum kinds
+    {
+      QUIET = 0,
+      NOTES,
+      CONTROLLERS,
+      WAVEFORM,
+      ALL,
+
+      NUM_KINDS
+    };
+
+    /** Summary of the render times of the blocks of a run (in the unit of the times). */
+    struct Percentiles
+    {
+      uint32_t p50;
+      uint32_t p99;
+      uint32_t p999;
+      uint32_t max;
+    };
+
+    //---------------------------------------------------------------------------------------------
+    // construction/destruction:
+
+    /** Constructor. */
+    EventStorm();
+
+    //---------------------------------------------------------------------------------------------
+    // parameter settings:
+
+    /** Selects the kind of events, @see kinds. */
+    void setKind(int newKind);
+
+    //---------------------------------------------------------------------------------------------
+    // inquiry:
+
+    /** Returns the selected kind of events. */
+    int getKind() const { return kind; }
+
+    /** Returns the name of a kind of events (e.g. "notes"), NULL for an invalid kind. */
+    static const char* getKindName(int kind);
+
+    /** Returns the kind with the given name or -1. */
+    static int findKind(const char *name);
+
+    /** Sorts the render times of numBlocks blocks (in place) and returns their 50th, 99th and
+    99.9th percentile and the maximum. */
+    static void getPercentiles(uint32_t *times, int numBlocks, Percentiles &result);
+
+    /** Fills the first 16 steps of the pattern with the pattern of the benchmarks: keys along the
+    circle of fifths, a rest every 8th step, an accent every 3rd and a slide every 5th. */
+    static void setBenchPattern(AcidPattern *pattern);
+
+    //---------------------------------------------------------------------------------------------
+    // event handling:
+
+    /** Puts the synth into the state in which a run begins: a held note with the amplitude
+    envelope at a sustain level, such that the synth keeps rendering between the events. */
+    void start(Open303 &synth);
+
+    /** Applies the events of the next block to the synth. */
+    void applyBlock(Open303 &synth, Open303CCMap &ccMap);
+
+    //=============================================================================================
+
+  protected:
+
+    void applyNotes(Open303 &synth);
+    void applyControllers(Open303 &synth, Open303CCMap &ccMap);
+    void applyWaveform(Open303 &synth);
+
+    int      kind;
+    uint32_t blockCount; // blocks since start
+    int      key;        // the key that is currently held
+
+  };
+
+} // end namespace rosic
+
+#endif // rosic_EventStorm_h
@@ -0,0 +1,133 @@
+#include "rosic_EventStorm.h"
+using namespace rosic;
+
+static const char* const kindNames[EventStorm::NUM_KINDS] =
+{
+  "quiet", "notes", "controllers", "waveform", "all"
+};
+
+//-------------------------------------------------------------------------------------------------
+// construction/destruction:
+
+EventStorm::EventStorm()
+{
+  kind       = ALL;
+  blockCount = 0;
+  key        = 36;
+}
+
+//-------------------------------------------------------------------------------------------------
+// parameter settings:
+
+void EventStorm::setKind(int newKind)
+{
+  if( newKind >= 0 && newKind < NUM_KINDS )
+    kind = newKind;
+}
+
+//-------------------------------------------------------------------------------------------------
+// inquiry:
+
+const char* EventStorm::getKindName(int kind)
+{
+  return (kind >= 0 && kind < NUM_KINDS) ? kindNames[kind] : NULL;
+}
+
+int EventStorm::findKind(const char *name)
+{
+  for(int k=0; k<NUM_KINDS; k++)
+  {
+    if( strcmp(name, kindNames[k]) == 0 )
+      return k;
+  }
+  return -1;
+}
+
+static int compareTimes(const void *a, const void *b)
+{
+  uint32_t x = *(const uint32_t*) a, y = *(const uint32_t*) b;
+  return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+void EventStorm::getPercentiles(uint32_t *times, int numBlocks, Percentiles &result)
+{
+  if( numBlocks < 1 )
+  {
+    result.p50 = result.p99 = result.p999 = result.max = 0;
+    return;
+  }
+  qsort(times, numBlocks, sizeof(uint32_t), compareTimes);
+
+  // nearest rank: the smallest time that at least the given fraction of the blocks don't exceed
+  uint64_t n = numBlocks;
+  result.p50  = times[(n*500 + 999) / 1000 - 1];
+  result.p99  = times[(n*990 + 999) / 1000 - 1];
+  result.p999 = times[(n*999 + 999) / 1000 - 1];
+  result.max  = times[numBlocks-1];
+}
+
+void EventStorm::setBenchPattern(AcidPattern *pattern)
+{
+  for(int k=0; k<16; k++)
+  {
+    pattern->setKey(   k, (7*k) % 12);
+    pattern->setGate(  k, k % 8 != 7);
+    pattern->setAccent(k, k % 3 == 0);
+    pattern->setSlide( k, k % 5 == 4);
+  }
+}
+
+//-------------------------------------------------------------------------------------------------
+// event handling:
+
+void EventStorm::start(Open303 &synth)
+{
+  blockCount = 0;
+  key        = 36;
+  synth.allNotesOff();
+  synth.setAmpSustain(-12.0f);
+  synth.noteOn(key, 100, 0.0f);
+}
+
+void EventStorm::applyBlock(Open303 &synth, Open303CCMap &ccMap)
+{
+  if( kind == NOTES || kind == ALL )
+    applyNotes(synth);
+  if( kind == CONTROLLERS || kind == ALL )
+    applyControllers(synth, ccMap);
+  if( kind == WAVEFORM || kind == ALL )
+    applyWaveform(synth);
+  blockCount++;
+}
+
+void EventStorm::applyNotes(Open303 &synth)
+{
+  int newKey = 36 + (int) ((blockCount * 7) % 24); // never the same key twice in a row
+  if( blockCount % 2 == 0 )
+  {
+    synth.allNotesOff();
+    synth.noteOn(newKey, 127, 0.0f);
+  }
+  else
+  {
+    synth.noteOn(newKey, 127, 0.0f); // slides, because the old key is still held
+    synth.noteOn(key, 0, 0.0f);
+  }
+  key = newKey;
+}
+
+void EventStorm::applyControllers(Open303 &synth, Open303CCMap &ccMap)
+{
+  for(int i=0; i<ccMap.getNumDescriptors(); i++)
+    ccMap.handleCC(synth, ccMap.getDescriptor(i).cc, (int) ((blockCount * 5 + i * 11) & 0x7F));
+  synth.setPitchBend(0.5f * (float) ((int) (blockCount % 9) - 4));
+}
+
+void EventStorm::applyWaveform(Open303 &synth)
+{
+  float x = (1.0f/15.0f) * (float) (blockCount % 16);
+  synth.setWaveform(x);
+  synth.setTanhShaperDrive(60.0f * x);
+  synth.setTanhShaperOffset(20.0f * x - 10.0f);
+  synth.setSquarePhaseShift(360.0f * x);
+}
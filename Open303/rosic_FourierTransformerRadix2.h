@@ -47,8 +47,8 @@ namespace rosic
     //---------------------------------------------------------------------------------------------
     // construction/destruction:
 
-    /** Constructor. */
-    FourierTransformerRadix2();  
+    /** Constructor. Allocates the buffers for the given FFT-size (a power of 2, >= 2). */
+    FourierTransformerRadix2(int initialBlockSize = 256);
 
     /** Destructor. */
     ~FourierTransformerRadix2();
@@ -56,8 +56,9 @@ namespace rosic
     //---------------------------------------------------------------------------------------------
     // parameter settings:
 
-    /** FFT-size, has to be a power of 2 and >= 2. */
-    void setBlockSize(int newBlockSize);     
+    /** FFT-size, has to be a power of 2 and >= 2. A new size reallocates the buffers, so objects
+    that are used on the audio path get their size in the constructor instead. */
+    void setBlockSize(int newBlockSize);
 
     /** Sets the direction of the transform (@see: directions). This will affect the sign of the 
     exponent (or equivalently: theimaginary part) in the twiddling factors and the normalization 
@@ -5,7 +5,7 @@ using namespace rosic;
 //-------------------------------------------------------------------------------------------------
 // construction/destruction:
 
-FourierTransformerRadix2::FourierTransformerRadix2()
+FourierTransformerRadix2::FourierTransformerRadix2(int initialBlockSize)
 {
   N                   = 0;
   logN                = 0;
@@ -16,7 +16,7 @@ FourierTransformerRadix2::FourierTransformerRadix2()
   ip                  = NULL;
   tmpBuffer           = NULL;
 
-  setBlockSize(256);
+  setBlockSize(initialBlockSize);
 }
 
 FourierTransformerRadix2::~FourierTransformerRadix2()
@@ -43,7 +43,7 @@ void FourierTransformerRadix2::setBlockSize(int newBlockSize)
     if( newBlockSize != N )
     {
       N    = newBlockSize;
-      logN = (int) floor( log2((float) N + 0.5 ) );
+      logN = (int) floorf( log2f((float) N + 0.5f ) );
       updateNormalizationFactor();
 
       if( w != NULL )
@@ -52,7 +52,7 @@ void FourierTransformerRadix2::setBlockSize(int newBlockSize)
 
       if( ip != NULL )
         delete[] ip;
-      ip    = new int[(int) ceil(4.0+sqrt((float)N))];
+      ip    = new int[(int) ceilf(4.0f+sqrtf((float)N))];
       ip[0] = 0; // indicate that re-initialization is necesarry
 
       if( tmpBuffer != NULL )
@@ -92,7 +92,7 @@ void FourierTransformerRadix2::setNormalizationMode(int newNormalizationMode)
     DEBUG_BREAK; // passed int-parameter does not correspond to any meaningful enum-field
 }
 
-void FourierTransformerRadix2::setRealSignalMode(bool willBeUsedForRealSignals)
+void FourierTransformerRadix2::setRealSignalMode(bool /*willBeUsedForRealSignals*/)
 {
   ip[0] = 0; // retriggers twiddle-factor computation
 }
@@ -107,7 +107,7 @@ void FourierTransformerRadix2::transformComplexBufferInPlace(Complex *buffer)
   float* d_buffer = &(buffer[0].re);
 
   // normalize the FFT-input, if required:
-  if( normalizationFactor != 1.0 )
+  if( normalizationFactor != 1.0f )
   {
     for(int n=0; n<2*N; n++)
       d_buffer[n] *= normalizationFactor;
@@ -131,7 +131,7 @@ void FourierTransformerRadix2::transformComplexBuffer(Complex *inBuffer, Complex
 
   // copy the input into the output for the in-place routine (thereby normalize, if necesarry):
   int n;
-  if( normalizationFactor != 1.0 )
+  if( normalizationFactor != 1.0f )
   {
     for(n=0; n<2*N; n++)
       d_outBuffer[n] = d_inBuffer[n] * normalizationFactor;
@@ -164,7 +164,7 @@ void FourierTransformerRadix2::transformRealSignal(float *inSignal, Complex *out
 
   // copy the input into the output for the in-place routine (thereby normalize, if necesarry):
   int n;
-  if( normalizationFactor != 1.0 )
+  if( normalizationFactor != 1.0f )
   {
     for(n=0; n<N; n++)
       d_outBuffer[n] = inSignal[n] * normalizationFactor;
@@ -210,7 +210,7 @@ void FourierTransformerRadix2::getRealSignalMagnitudesAndPhases(float *signal,
     re            = dBuffer[2*k];
     im            = dBuffer[2*k+1];
     magnitudes[k] = sqrt(re*re + im*im);
-    if( re == 0.0 && im == 0.0 )
+    if( re == 0.0f && im == 0.0f )
       phases[k] = 0.0;
     else
       phases[k] = atan2(im, re);
@@ -243,15 +243,15 @@ void FourierTransformerRadix2::transformSymmetricSpectrum(Complex *inSpectrum, f
 
   // copy the input into the output for the in-place routine (thereby normalize, if necesarry):
   int n;
-  if( normalizationFactor != 1.0 )
+  if( normalizationFactor != 1.0f )
   {
     for(n=0; n<N; n++)
-      outSignal[n] = 2.0 * d_inBuffer[n] * normalizationFactor;
+      outSignal[n] = 2.0f * d_inBuffer[n] * normalizationFactor;
   }
   else
   {
     for(n=0; n<N; n++)
-      outSignal[n] = 2.0 * d_inBuffer[n];
+      outSignal[n] = 2.0f * d_inBuffer[n];
   }
 
   // for some reason, the subsequent routine expects the second half of the spectrum (the complex 
@@ -297,11 +297,11 @@ void FourierTransformerRadix2::updateNormalizationFactor()
   if( (normalizationMode == NORMALIZE_ON_FORWARD_TRAFO && direction == FORWARD) ||
       (normalizationMode == NORMALIZE_ON_INVERSE_TRAFO && direction == INVERSE)    )
   {
-    normalizationFactor = 1.0 / (float) N;
+    normalizationFactor = 1.0f / (float) N;
   }
   else if( normalizationMode == ORTHONORMAL_TRAFO )
   {
-    normalizationFactor = 1.0 / sqrt((float) N);
+    normalizationFactor = 1.0f / sqrtf((float) N);
   }
   else
     normalizationFactor = 1.0;
@@ -29,7 +29,8 @@ namespace rosic
   /** Circularly shifts the content of the buffer by 'numPositions' to the right - for leftward
   shifts use negative values for numPositions. If the absolute value of 'numPositions' is greater
   than the length of the buffer, it will use numPositions modulo the length - so if the length is 6
-  and numPositions is 8, it will whift by 2 positions. */
+  and numPositions is 8, it will whift by 2 positions. The buffer is rotated in place, without
+  allocating memory. */
   template<class T>
   void circularShift(T *buffer, int length, int numPositions);
 
@@ -170,23 +171,20 @@ namespace rosic
   template <class T>
   void circularShift(T *buffer, int length, int numPositions)
   {
-    int na = abs(numPositions);
-    while( na > length )
-      na -=length;
-    T *tmp = new T[na];
-    if( numPositions < 0 )
-    {
-      memcpy(  tmp,                buffer,              na*sizeof(T));
-      memmove( buffer,            &buffer[na], (length-na)*sizeof(T));
-      memcpy( &buffer[length-na],  tmp,                 na*sizeof(T));
-    }
-    else if( numPositions > 0 )
-    {
-      memcpy(  tmp,        &buffer[length-na],          na*sizeof(T));
-      memmove(&buffer[na],  buffer,            (length-na)*sizeof(T));
-      memcpy(  buffer,      tmp,                        na*sizeof(T));
-    }
-    delete[] tmp;
+    if( length < 2 )
+      return;
+
+    // a shift to the left is a shift to the right by the rest of the length:
+    int na = numPositions % length;
+    if( na < 0 )
+      na += length;
+    if( na == 0 )
+      return;
+
+    // rotate to the right by reversing both parts and then the whole buffer:
+    reverse( buffer,             length-na);
+    reverse(&buffer[length-na],  na);
+    reverse( buffer,             length);
   }
 
   template <class T>
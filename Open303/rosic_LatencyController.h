@@ -0,0 +1,108 @@
+#ifndef rosic_LatencyController_h
+#define rosic_LatencyController_h
+
+// rosic-indcludes:
+#include "GlobalDefinitions.h"
+
+namespace rosic
+{
+
+  /**
+
+  This is a class for choosing the block size (i.e. the length of the DMA buffers) of the audio
+  output, which sets the latency. There are two fixed modes - tight (small blocks, for playing
+  live via MIDI) and safe (large blocks, which leave room for heavy processing, e.g. for the
+  jukebox) - and an automatic mode. In the automatic mode, the controller is fed with the render
+  time of each block and doubles the block size when the render time approaches the deadline (the
+  duration of the block). When the peak load stays low for a while, it halves the block size again.
+  The block sizes are always powers of two between minBlockSize and maxBlockSize.
+
+  */
+
+  class LatencyController
+  {
+
+  public:
+
+    enum latencyModes
+    {
+      TIGHT = 0,
+      SAFE,
+      AUTO,
+
+      NUM_LATENCY_MODES
+    };
+
+    static const int minBlockSize = 32;
+    static const int maxBlockSize = 512;
+
+    //---------------------------------------------------------------------------------------------
+    // construction/destruction:
+
+    /** Constructor. */
+    LatencyController();
+
+    //---------------------------------------------------------------------------------------------
+    // parameter settings:
+
+    /** Selects the latency mode, @see latencyModes. The block size changes immediately (in the
+    automatic mode, it starts from the tight block size). */
+    void setMode(int newMode);
+
+    /** Sets the block sizes for the tight and safe modes, they are rounded down to a power of two
+    within minBlockSize...maxBlockSize. */
+    void setBlockSizes(int newTightSize, int newSafeSize);
+
+    /** Sets the load (render time over block duration, 0...1) above which the automatic mode grows
+    the blocks and the one below which it shrinks them. */
+    void setLoadThresholds(float newGrowLoad, float newShrinkLoad);
+
+    /** Sets the time (in seconds) for which the peak load must stay below the shrink threshold
+    before the blocks are made smaller. */
+    void setShrinkHoldTime(float newHoldTime);
+
+    //---------------------------------------------------------------------------------------------
+    // inquiry:
+
+    /** Returns the latency mode, @see latencyModes. */
+    int getMode() const { return mode; }
+
+    /** Returns the current block size in frames. */
+    int getBlockSize() const { return blockSize; }
+
+    /** Returns the peak load (decaying over about a second), as seen by the automatic mode. */
+    float getPeakLoad() const { return peakLoad; }
+
+    //---------------------------------------------------------------------------------------------
+    // processing:
+
+    /** Must be called after each block with the time that was needed for rendering it and the
+    duration of the block (both in seconds). Returns true when the block size has changed,
+    in which case the output should be reconfigured with getBlockSize() before the next block. */
+    bool update(float renderTime, float blockTime);
+
+    //=============================================================================================
+
+  protected:
+
+    /** Rounds down to a power of two within minBlockSize...maxBlockSize. */
+    static int clipBlockSize(int size);
+
+    /** Switches to a new block size and restarts the measurement. */
+    void changeBlockSize(int newSize);
+
+    int   mode;          // @see latencyModes
+    int   blockSize;     // current block size in frames
+    int   tightSize;     // block size for the tight mode (and the start of the automatic mode)
+    int   safeSize;      // block size for the safe mode
+    float growLoad;      // load above which the blocks grow
+    float shrinkLoad;    // peak load below which the blocks shrink
+    float holdTime;      // time (in s) for which the load must be low before shrinking
+    float peakLoad;      // peak-hold of the load with decay
+    float lowTime;       // time (in s) for which the peak load has been low
+
+  };
+
+} // end namespace rosic
+
+#endif // rosic_LatencyController_h
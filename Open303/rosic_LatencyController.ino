@@ -0,0 +1,102 @@
+#include "rosic_LatencyController.h"
+using namespace rosic;
+
+//-------------------------------------------------------------------------------------------------
+// construction/destruction:
+
+LatencyController::LatencyController()
+{
+  tightSize  = minBlockSize;
+  safeSize   = 256;
+  growLoad   = 0.7f;
+  shrinkLoad = 0.25f;
+  holdTime   = 2.0f;
+  setMode(TIGHT);
+}
+
+//-------------------------------------------------------------------------------------------------
+// parameter settings:
+
+void LatencyController::setMode(int newMode)
+{
+  if( newMode < 0 || newMode >= NUM_LATENCY_MODES )
+    return;
+  mode = newMode;
+  changeBlockSize(mode == SAFE ? safeSize : tightSize);
+}
+
+void LatencyController::setBlockSizes(int newTightSize, int newSafeSize)
+{
+  tightSize = clipBlockSize(newTightSize);
+  safeSize  = clipBlockSize(newSafeSize);
+  if( mode != AUTO )
+    changeBlockSize(mode == SAFE ? safeSize : tightSize);
+}
+
+void LatencyController::setLoadThresholds(float newGrowLoad, float newShrinkLoad)
+{
+  // shrinking halves the blocks, which may raise the load (the overhead per block stays the
+  // same), so the shrink threshold must stay well below half of the grow threshold:
+  if( newGrowLoad > 0.0f && newShrinkLoad >= 0.0f && newShrinkLoad < 0.5f*newGrowLoad )
+  {
+    growLoad   = newGrowLoad;
+    shrinkLoad = newShrinkLoad;
+  }
+}
+
+void LatencyController::setShrinkHoldTime(float newHoldTime)
+{
+  if( newHoldTime >= 0.0f )
+    holdTime = newHoldTime;
+}
+
+//-------------------------------------------------------------------------------------------------
+// processing:
+
+bool RENDER_CODE LatencyController::update(float renderTime, float blockTime)
+{
+  if( mode != AUTO || blockTime <= 0.0f )
+    return false;
+
+  // peak-hold with a decay time constant of about a second:
+  float load = renderTime / blockTime;
+  if( load > peakLoad )
+    peakLoad = load;
+  else
+    peakLoad *= 1.0f - blockTime;
+
+  if( load > growLoad && blockSize < maxBlockSize )
+  {
+    changeBlockSize(2*blockSize);
+    return true;
+  }
+
+  if( peakLoad < shrinkLoad )
+    lowTime += blockTime;
+  else
+    lowTime = 0.0f;
+  if( lowTime >= holdTime && blockSize > tightSize )
+  {
+    changeBlockSize(blockSize/2);
+    return true;
+  }
+  return false;
+}
+
+//-------------------------------------------------------------------------------------------------
+// internal functions:
+
+int RENDER_CODE LatencyController::clipBlockSize(int size)
+{
+  int s = minBlockSize;
+  while( 2*s <= size && 2*s <= maxBlockSize )
+    s *= 2;
+  return s;
+}
+
+void RENDER_CODE LatencyController::changeBlockSize(int newSize)
+{
+  blockSize = clipBlockSize(newSize);
+  peakLoad  = 0.0f;
+  lowTime   = 0.0f;
+}
@@ -80,7 +80,7 @@ namespace rosic
   //-----------------------------------------------------------------------------------------------
   // inlined functions:
 
-  INLINE float LeakyIntegrator::getSample(float in)
+  RENDER_INLINE float LeakyIntegrator::getSample(float in)
   {
     return y1 = in + coeff*(y1-in);
   }
@@ -23,7 +23,7 @@ LeakyIntegrator::~LeakyIntegrator()
 
 void LeakyIntegrator::setSampleRate(float newSampleRate)
 {
-  if( newSampleRate > 0.0 )
+  if( newSampleRate > 0.0f )
   {
     sampleRate = newSampleRate;
     calculateCoefficient();
@@ -32,7 +32,7 @@ void LeakyIntegrator::setSampleRate(float newSampleRate)
 
 void LeakyIntegrator::setTimeConstant(float newTimeConstant)
 {
-  if( newTimeConstant >= 0.0 && newTimeConstant != tau )
+  if( newTimeConstant >= 0.0f && newTimeConstant != tau )
   {
     tau = newTimeConstant; 
     calculateCoefficient();
@@ -42,28 +42,28 @@ void LeakyIntegrator::setTimeConstant(float newTimeConstant)
 //-------------------------------------------------------------------------------------------------
 // inquiry:
 
-float LeakyIntegrator::getNormalizer(float tau1, float tau2, float fs)
+float RENDER_CODE LeakyIntegrator::getNormalizer(float tau1, float tau2, float fs)
 {
-  float td = 0.001*tau1;
-  float ta = 0.001*tau2;
+  float td = 0.001f*tau1;
+  float ta = 0.001f*tau2;
 
   // catch some special cases:
-  if( ta == 0.0 && td == 0.0 )
-    return 1.0;
-  else if( ta == 0.0 )
+  if( ta == 0.0f && td == 0.0f )
+    return 1.0f;
+  else if( ta == 0.0f )
   {
-    return 1.0 / (1.0-exp(-1.0/(fs*td)));
+    return 1.0f / (1.0f-expf(-1.0f/(fs*td)));
   }
-  else if( td == 0.0 )
+  else if( td == 0.0f )
   {
-    return 1.0 / (1.0-exp(-1.0/(fs*ta)));
+    return 1.0f / (1.0f-expf(-1.0f/(fs*ta)));
   }
 
   // compute the filter coefficients:
-  float x  = exp( -1.0 / (fs*td)  );
+  float x  = expf( -1.0f / (fs*td)  );
   float bd = 1-x;
   float ad = -x;
-  x         = exp( -1.0 / (fs*ta)  );
+  x         = expf( -1.0f / (fs*ta)  );
   float ba = 1-x;
   float aa = -x;
 
@@ -73,22 +73,22 @@ float LeakyIntegrator::getNormalizer(float tau1, float tau2, float fs)
   {
     float tp  = ta;
     float np  = fs*tp;
-    xp         = (np+1.0)*ba*ba*pow(aa, np);
+    xp         = (np+1.0f)*ba*ba*powf(aa, np);
   }
   else
   {
-    float tp  = log(ta/td) / ( (1.0/td) - (1.0/ta) );
+    float tp  = logf(ta/td) / ( (1.0f/td) - (1.0f/ta) );
     float np  = fs*tp;
-    float s   = 1.0 / (aa-ad);
+    float s   = 1.0f / (aa-ad);
     float b01 = s * aa*ba*bd;
     float b02 = s * ad*ba*bd;
     float a01 = s * (ad-aa)*aa;
     float a02 = s * (ad-aa)*ad;
-    xp         = b01*pow(a01, np) - b02*pow(a02, np);
+    xp         = b01*powf(a01, np) - b02*powf(a02, np);
   }
 
   // return the normalizer as reciprocal of the peak height:
-  return 1.0/xp;
+  return 1.0f/xp;
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -101,8 +101,8 @@ void LeakyIntegrator::reset()
 
 void LeakyIntegrator::calculateCoefficient()
 {
-  if( tau > 0.0 )
-    coeff = exp( -1.0 / (sampleRate*0.001*tau)  );
+  if( tau > 0.0f )
+    coeff = expf( -1.0f / (sampleRate*0.001f*tau)  );
   else
     coeff = 0.0;
 }
@@ -0,0 +1,212 @@
+#ifndef rosic_LogRing_h
+#define rosic_LogRing_h
+
+// standard-library includes:
+#include <stdint.h>
+
+// rosic-indcludes:
+#include "GlobalDefinitions.h"
+
+namespace rosic
+{
+
+  /**
+
+  This is a class for logging from real-time code. A message is stored as a pointer to its printf
+  format string (which must be a literal, it serves as the ID of the message) plus up to maxArgs
+  arguments in binary form - formatting and writing the text are left to a low priority task
+  which drains the ring with pop and formatRecord. Logging a message costs a few dozen
+  instructions, never blocks and never allocates. When the ring is full, messages are dropped (and
+  counted).
+
+  The ring is a bounded lock-free queue with a sequence number per slot (after Dmitry Vyukov), so
+  any number of tasks (and interrupts) may log at the same time, while one task drains it.
+
+  Arguments may be integers, floats (doubles are stored as floats) and strings - strings are
+  stored as pointers, so they must stay valid until the message is printed (i.e. they should be
+  literals, too).
+
+  */
+
+  class LogRing
+  {
+
+  public:
+
+    static const int numSlots = 64;  // must be a power of 2
+    static const int maxArgs  = 8;
+
+    /** Types of the stored arguments. */
+    enum argTypes
+    {
+      SIGNED = 0,
+      UNSIGNED,
+      FLOAT,
+      STRING
+    };
+
+    /** A logged message. */
+    struct Record
+    {
+      const char *format;
+      uint8_t     numArgs;
+      uint8_t     types[maxArgs];
+      union
+      {
+        int32_t     i;
+        uint32_t    u;
+        float       f;
+        const char *s;
+      } args[maxArgs];
+    };
+
+    //---------------------------------------------------------------------------------------------
+    // construction/destruction:
+
+    /** Constructor. */
+    LogRing();
+
+    //---------------------------------------------------------------------------------------------
+    // logging (any task):
+
+    /** Logs a message with a printf format string (which must be a literal) and its arguments.
+    Arguments beyond maxArgs are ignored. Returns false, when the message was dropped. */
+    template<typename... Args>
+    INLINE bool printf(const char *format, Args... args)
+    {
+      Record r;
+      r.format  = format;
+      r.numArgs = 0;
+      int dummy[] = { 0, (setArg(r, args), 0)... };
+      (void) dummy;
+      return push(r);
+    }
+
+    /** Logs a single value like Arduino's Print::print does (floats with 2 decimals). */
+    INLINE bool print(const char *s)   { return printf("%s", s); }
+    INLINE bool print(char c)          { return printf("%c", c); }
+    INLINE bool print(int x)           { return printf("%d", x); }
+    INLINE bool print(unsigned int x)  { return printf("%u", x); }
+    INLINE bool print(long x)          { return printf("%ld", x); }
+    INLINE bool print(unsigned long x) { return printf("%lu", x); }
+    INLINE bool print(double x)        { return printf("%.2f", x); }
+
+    /** Like print, followed by a line break. */
+    INLINE bool println(const char *s)   { return printf("%s\r\n", s); }
+    INLINE bool println(char c)          { return printf("%c\r\n", c); }
+    INLINE bool println(int x)           { return printf("%d\r\n", x); }
+    INLINE bool println(unsigned int x)  { return printf("%u\r\n", x); }
+    INLINE bool println(long x)          { return printf("%ld\r\n", x); }
+    INLINE bool println(unsigned long x) { return printf("%lu\r\n", x); }
+    INLINE bool println(double x)        { return printf("%.2f\r\n", x); }
+
+    /** Stores a message, returns false when the ring is full. */
+    INLINE bool push(const Record &record);
+
+    //---------------------------------------------------------------------------------------------
+    // draining (one task only):
+
+    /** Takes the oldest message out of the ring, returns false when it is empty. */
+    INLINE bool pop(Record &record);
+
+    /** Formats a message into buffer (like snprintf) and returns the length of the text. */
+    static int formatRecord(const Record &record, char *buffer, int bufferSize);
+
+    /** Returns the number of messages that were dropped since the last call. */
+    uint32_t takeNumDropped() { return __atomic_exchange_n(&numDropped, 0, __ATOMIC_RELAXED); }
+
+    //=============================================================================================
+
+  protected:
+
+    static INLINE void setArg(Record &r, int x)                { setArg(r, SIGNED, (uint32_t) x); }
+    static INLINE void setArg(Record &r, long x)               { setArg(r, SIGNED, (uint32_t) x); }
+    static INLINE void setArg(Record &r, unsigned int x)       { setArg(r, UNSIGNED, x); }
+    static INLINE void setArg(Record &r, unsigned long x)      { setArg(r, UNSIGNED, (uint32_t) x); }
+    static INLINE void setArg(Record &r, double x)
+    {
+      if( r.numArgs < maxArgs )
+      {
+        r.types[r.numArgs]  = FLOAT;
+        r.args[r.numArgs].f = (float) x;
+        r.numArgs++;
+      }
+    }
+    static INLINE void setArg(Record &r, const char *s)
+    {
+      if( r.numArgs < maxArgs )
+      {
+        r.types[r.numArgs]  = STRING;
+        r.args[r.numArgs].s = s;
+        r.numArgs++;
+      }
+    }
+    static INLINE void setArg(Record &r, int type, uint32_t x)
+    {
+      if( r.numArgs < maxArgs )
+      {
+        r.types[r.numArgs]  = (uint8_t) type;
+        r.args[r.numArgs].u = x;
+        r.numArgs++;
+      }
+    }
+
+    struct Slot
+    {
+      uint32_t sequence; // tells whether the slot is free for the writer or filled for the reader
+      Record   record;
+    };
+
+    Slot     slots[numSlots];
+    uint32_t writePosition;
+    uint32_t readPosition;
+    uint32_t numDropped;
+
+  };
+
+  //-----------------------------------------------------------------------------------------------
+  // from here: definitions of the functions to be inlined, i.e. all functions which are supposed
+  // to be called at audio-rate (they can't be put into the .cpp file):
+
+  RENDER_INLINE bool LogRing::push(const Record &record)
+  {
+    uint32_t position = __atomic_load_n(&writePosition, __ATOMIC_RELAXED);
+    Slot *slot;
+    while( true )
+    {
+      slot = &slots[position & (numSlots-1)];
+      int32_t d = (int32_t) (__atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE) - position);
+      if( d == 0 )
+      {
+        // the slot is free - try to claim it (on failure, position is updated to the new one):
+        if( __atomic_compare_exchange_n(&writePosition, &position, position+1, true,
+          __ATOMIC_RELAXED, __ATOMIC_RELAXED) )
+          break;
+      }
+      else if( d < 0 )
+      {
+        __atomic_fetch_add(&numDropped, 1, __ATOMIC_RELAXED); // the ring is full
+        return false;
+      }
+      else
+        position = __atomic_load_n(&writePosition, __ATOMIC_RELAXED); // another writer was faster
+    }
+    slot->record = record;
+    __atomic_store_n(&slot->sequence, position+1, __ATOMIC_RELEASE);
+    return true;
+  }
+
+  INLINE bool LogRing::pop(Record &record)
+  {
+    Slot *slot = &slots[readPosition & (numSlots-1)];
+    if( __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE) != readPosition+1 )
+      return false; // empty (or the writer hasn't finished the slot yet)
+    record = slot->record;
+    __atomic_store_n(&slot->sequence, readPosition+numSlots, __ATOMIC_RELEASE);
+    readPosition++;
+    return true;
+  }
+
+} // end namespace rosic
+
+#endif // rosic_LogRing_h
@@ -0,0 +1,106 @@
+#include "rosic_LogRing.h"
+#include <stdio.h>
+#include <string.h>
+using namespace rosic;
+
+//-------------------------------------------------------------------------------------------------
+// construction/destruction:
+
+LogRing::LogRing()
+{
+  for(int i=0; i<numSlots; i++)
+    slots[i].sequence = i;
+  writePosition = 0;
+  readPosition  = 0;
+  numDropped    = 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+// draining:
+
+int LogRing::formatRecord(const Record &record, char *buffer, int bufferSize)
+{
+  if( bufferSize <= 0 )
+    return 0;
+
+  // the format string is copied piece by piece, each conversion is done by snprintf with the
+  // stored argument converted to the type that the conversion expects:
+  const char *f = record.format;
+  int length    = 0;
+  int argIndex  = 0;
+  while( *f != '\0' && length < bufferSize-1 )
+  {
+    if( *f != '%' || f[1] == '%' )
+    {
+      buffer[length++] = *f;
+      f += (*f == '%') ? 2 : 1;
+      continue;
+    }
+
+    // collect the conversion specification without length modifiers:
+    char spec[16];
+    int  specLength = 0;
+    const char *start = f;
+    spec[specLength++] = *f++;
+    while( *f != '\0' && strchr("-+ #0123456789.", *f) != NULL && specLength < 12 )
+      spec[specLength++] = *f++;
+    while( *f != '\0' && strchr("hlLqjzt", *f) != NULL )
+      f++;
+    char conversion = *f;
+    if( conversion == '\0' )
+      break;
+    f++;
+
+    int  remaining = bufferSize - length;
+    int  n         = 0;
+    bool haveArg   = argIndex < record.numArgs;
+    if( !haveArg )
+      n = snprintf(buffer+length, remaining, "%.*s", (int) (f-start), start); // print it as it is
+    else
+    {
+      int type = record.types[argIndex];
+      double value = type == FLOAT    ? (double) record.args[argIndex].f
+                   : type == UNSIGNED ? (double) record.args[argIndex].u
+                   : type == SIGNED   ? (double) record.args[argIndex].i : 0.0;
+      if( conversion == 'c' )
+      {
+        spec[specLength++] = 'c';
+        spec[specLength]   = '\0';
+        n = snprintf(buffer+length, remaining, spec, (int) record.args[argIndex].i);
+      }
+      else if( strchr("diouxX", conversion) != NULL )
+      {
+        spec[specLength++] = 'l';
+        spec[specLength++] = conversion;
+        spec[specLength]   = '\0';
+        if( type == SIGNED )
+          n = snprintf(buffer+length, remaining, spec, (long) record.args[argIndex].i);
+        else if( type == UNSIGNED )
+          n = snprintf(buffer+length, remaining, spec, (unsigned long) record.args[argIndex].u);
+        else
+          n = snprintf(buffer+length, remaining, spec, (long) value);
+      }
+      else if( strchr("fFeEgGaA", conversion) != NULL )
+      {
+        spec[specLength++] = conversion;
+        spec[specLength]   = '\0';
+        n = snprintf(buffer+length, remaining, spec, value);
+      }
+      else if( conversion == 's' && type == STRING )
+      {
+        spec[specLength++] = 's';
+        spec[specLength]   = '\0';
+        n = snprintf(buffer+length, remaining, spec,
+          record.args[argIndex].s != NULL ? record.args[argIndex].s : "(null)");
+      }
+      else
+        n = snprintf(buffer+length, remaining, "%.*s", (int) (f-start), start); // mismatch
+      argIndex++;
+    }
+    if( n < 0 )
+      break;
+    length += n < remaining ? n : remaining-1;
+  }
+  buffer[length] = '\0';
+  return length;
+}
@@ -0,0 +1,137 @@
+#ifndef rosic_MidiClockSync_h
+#define rosic_MidiClockSync_h
+
+// standard-library includes:
+#include <stdint.h>
+
+// rosic-indcludes:
+#include "rosic_RealFunctions.h"
+
+namespace rosic
+{
+
+  /**
+
+  This is a class for slaving to an external MIDI clock (24 ticks per quarter note). The arrival
+  times of the clock ticks (measured in samples of the audio clock) are fed into a second order
+  delay-locked loop (DLL) which filters out the jitter of the transmission and the polling and
+  produces a smooth estimate for the tick period and the time of the current tick. From these, it
+  derives a tick rate (in ticks per sample) for a sequencer that runs its own phase accumulator,
+  where the rate is slightly corrected according to the phase error between the sequencer and the
+  filtered clock - thus, sequencer and clock form a phase-locked loop.
+
+  See: Fons Adriaensen - Using a DLL to filter time
+
+  */
+
+  class MidiClockSync
+  {
+
+  public:
+
+    /** Actions which must be taken by the sequencer on a clock tick, @see clockTick. */
+    enum tickActions
+    {
+      NO_ACTION = 0,
+      START,
+      CONTINUE
+    };
+
+    static const int ticksPerQuarter = 24;
+
+    //---------------------------------------------------------------------------------------------
+    // construction/destruction:
+
+    /** Constructor. */
+    MidiClockSync();
+
+    //---------------------------------------------------------------------------------------------
+    // parameter settings:
+
+    /** Sets the sample-rate of the clock that is used for the time stamps. */
+    void setSampleRate(float newSampleRate);
+
+    /** Sets the bandwidth of the DLL (in Hz). Lower values filter more jitter but react slower on
+    tempo changes. */
+    void setBandwidth(float newBandwidth);
+
+    //---------------------------------------------------------------------------------------------
+    // inquiry:
+
+    /** Returns true when the DLL has locked onto an incoming clock. */
+    bool isLocked() const { return lockCount >= lockThreshold; }
+
+    /** Returns true between a start/continue and a stop message. */
+    bool isRunning() const { return running; }
+
+    /** Returns the filtered period of the clock ticks in samples. */
+    float getSamplesPerTick() const { return period; }
+
+    /** Returns the filtered tempo in beats per minute. */
+    float getTempo() const { return 60.0f * sampleRate / (ticksPerQuarter * period); }
+
+    /** Returns the number of ticks received since the start (or since the song position that
+    was set before a continue). */
+    int getTickCount() const { return tickCount; }
+
+    /** Returns the rate (in ticks per sample) at which a sequencer should advance its tick
+    phase, given its current position in ticks. The rate is the reciprocal of the filtered period
+    with a small correction that pulls the sequencer towards the phase of the filtered clock. */
+    float getTickRate(float sequencerPosition) const;
+
+    //---------------------------------------------------------------------------------------------
+    // event handling:
+
+    /** Must be called for each incoming clock tick (0xF8) with the time (in samples of the audio
+    clock) of its arrival. The return value tells, whether the sequencer should be started or
+    continued on this tick, @see tickActions. */
+    int clockTick(uint32_t timeStamp);
+
+    /** Handles a start message (0xFA) - the next tick will start the playback from the beginning. */
+    void start();
+
+    /** Handles a continue message (0xFB) - the next tick will continue the playback from the
+    current song position. */
+    void continuePlayback();
+
+    /** Handles a stop message (0xFC). */
+    void stop();
+
+    /** Handles a song position pointer message (0xF2) - the position is given in MIDI beats
+    (i.e. 16th notes, 6 ticks each). */
+    void setSongPosition(int newPosition);
+
+    /** Forgets about the clock, such that the DLL will re-initialize on the next tick. */
+    void reset();
+
+    //=============================================================================================
+
+  protected:
+
+    /** Re-initializes the DLL for the given period (in samples) with the tick at timeStamp. */
+    void initLoop(uint32_t timeStamp, float newPeriod);
+
+    /** Calculates the loop coefficients from the bandwidth and the period. */
+    void calculateCoefficients();
+
+    static const int lockThreshold = 4; // number of regular ticks before we consider us locked
+
+    uint32_t t1Int;        // predicted time of the next tick, integer part (in samples)
+    float    t1Frac;       // ...and fractional part
+    float    period;       // filtered tick period in samples (e2 in Adriaensen's paper)
+    float    arrivalError; // offset of the last tick's arrival time from its filtered time
+    float    b, c;         // loop filter coefficients
+    float    bandwidth;    // loop bandwidth in Hz
+    float    sampleRate;   // the sample-rate of the time stamps
+    float    phaseGain;    // gain of the phase correction for the sequencer
+    int      tickCount;    // number of ticks since start (or song position)
+    int      lockCount;    // number of consecutive regular ticks
+    int      pendingAction;
+    bool     running;
+    bool     initialized;
+
+  };
+
+} // end namespace rosic
+
+#endif // rosic_MidiClockSync_h
@@ -0,0 +1,168 @@
+#include "rosic_MidiClockSync.h"
+using namespace rosic;
+
+//-------------------------------------------------------------------------------------------------
+// construction/destruction:
+
+MidiClockSync::MidiClockSync()
+{
+  sampleRate    = SAMPLE_RATE;
+  bandwidth     = 1.0f;
+  phaseGain     = 0.02f;
+  period        = sampleRate * 60.0f / (130.0f * ticksPerQuarter);
+  t1Int         = 0;
+  t1Frac        = 0.0f;
+  arrivalError  = 0.0f;
+  tickCount     = 0;
+  lockCount     = 0;
+  pendingAction = NO_ACTION;
+  running       = false;
+  initialized   = false;
+  calculateCoefficients();
+}
+
+//-------------------------------------------------------------------------------------------------
+// parameter settings:
+
+void MidiClockSync::setSampleRate(float newSampleRate)
+{
+  if( newSampleRate > 0.0f )
+  {
+    period     = period * newSampleRate / sampleRate;
+    sampleRate = newSampleRate;
+    reset();
+  }
+}
+
+void MidiClockSync::setBandwidth(float newBandwidth)
+{
+  if( newBandwidth > 0.0f )
+  {
+    bandwidth = newBandwidth;
+    calculateCoefficients();
+  }
+}
+
+//-------------------------------------------------------------------------------------------------
+// inquiry:
+
+float MidiClockSync::getTickRate(float sequencerPosition) const
+{
+  // the position where the sequencer should be now, according to the filtered clock:
+  float targetPosition = tickCount + arrivalError / period;
+
+  // pull the sequencer towards that position by slightly speeding it up or slowing it down - the
+  // correction is limited such that a large error (for example after a dropout) doesn't lead to
+  // wild tempo fluctuations:
+  float correction = clip(phaseGain * (targetPosition - sequencerPosition), -0.05f, 0.05f);
+  return (1.0f + correction) / period;
+}
+
+//-------------------------------------------------------------------------------------------------
+// event handling:
+
+int MidiClockSync::clockTick(uint32_t timeStamp)
+{
+  if( !initialized )
+    initLoop(timeStamp, period);
+  else
+  {
+    // the error between the actual and the predicted time of this tick - the integer parts of the
+    // times are subtracted first, such that we don't lose precision on large time stamps:
+    float e = (float) (int32_t) (timeStamp - t1Int) - t1Frac;
+
+    if( fabsf(e) > 0.5f * period )
+    {
+      // the tick is way off the prediction - either the tempo has jumped or the clock was paused,
+      // so we re-initialize with the measured interval (if plausible):
+      float interval = e + period;
+      if( interval > 0.0f && interval < 4.0f * period )
+        initLoop(timeStamp, interval);
+      else
+        initLoop(timeStamp, period);
+    }
+    else
+    {
+      // the actual DLL update - the filtered time of this tick is the old prediction t1:
+      arrivalError = e;
+      float dt     = b * e + period;
+      period      += c * e;
+
+      // advance the prediction and move whole samples from the fractional into the integer part:
+      t1Frac     += dt;
+      int32_t n   = (int32_t) floorf(t1Frac);
+      t1Int      += n;
+      t1Frac     -= n;
+
+      if( lockCount < lockThreshold )
+        lockCount++;
+    }
+  }
+
+  // count the ticks and handle pending transport messages:
+  int action = NO_ACTION;
+  if( pendingAction != NO_ACTION )
+  {
+    // start and continue take effect on the first tick after the message:
+    action        = pendingAction;
+    pendingAction = NO_ACTION;
+    running       = true;
+  }
+  else if( running )
+    tickCount++;
+
+  return action;
+}
+
+void MidiClockSync::start()
+{
+  tickCount     = 0;
+  pendingAction = START;
+}
+
+void MidiClockSync::continuePlayback()
+{
+  pendingAction = CONTINUE;
+}
+
+void MidiClockSync::stop()
+{
+  running       = false;
+  pendingAction = NO_ACTION;
+}
+
+void MidiClockSync::setSongPosition(int newPosition)
+{
+  // song position pointers are specified to be sent only while stopped - they count 16th notes
+  // of 6 ticks each:
+  if( newPosition >= 0 )
+    tickCount = 6 * newPosition;
+}
+
+void MidiClockSync::reset()
+{
+  initialized = false;
+  lockCount   = 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+// internal functions:
+
+void MidiClockSync::initLoop(uint32_t timeStamp, float newPeriod)
+{
+  period       = newPeriod;
+  arrivalError = 0.0f;
+  t1Int        = timeStamp + (uint32_t) floorf(period);
+  t1Frac       = period - floorf(period);
+  lockCount    = 0;
+  initialized  = true;
+  calculateCoefficients();
+}
+
+void MidiClockSync::calculateCoefficients()
+{
+  // the coefficients depend on the bandwidth relative to the tick rate:
+  float omega = 2.0f * (float) PI * bandwidth * period / sampleRate;
+  b           = (float) SQRT2 * omega;
+  c           = omega * omega;
+}
@@ -0,0 +1,139 @@
+#ifndef rosic_MidiOutBuffer_h
+#define rosic_MidiOutBuffer_h
+
+// standard-library includes:
+#include <stdint.h>
+
+// rosic-indcludes:
+#include "rosic_MidiParser.h"
+
+namespace rosic
+{
+
+  /**
+
+  This is a ring buffer for outgoing MIDI bytes. Messages are written as a whole (or not at all,
+  when there is not enough room) using running status, so a stream of notes takes 2 instead of 3
+  bytes per message. The bytes are read out in chunks that fit into the transmitter. Writing and
+  reading never block and never allocate memory.
+
+  There may be one writer and one reader running concurrently. Several writers must be serialized
+  by the caller (a spinlock around writeMessage is sufficient, as it does a constant amount of
+  work).
+
+  */
+
+  class MidiOutBuffer
+  {
+
+  public:
+
+    static const int capacity = 256; // must be a power of 2
+
+    //---------------------------------------------------------------------------------------------
+    // construction/destruction:
+
+    /** Constructor. */
+    MidiOutBuffer()
+    {
+      head          = 0;
+      tail          = 0;
+      numDropped    = 0;
+      runningStatus = 0;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    // inquiry:
+
+    /** Returns the number of bytes waiting to be read. */
+    int getNumBytes() const { return (int) (head - tail); }
+
+    /** Returns the number of messages that had to be dropped because the buffer was full. */
+    uint32_t getNumDropped() const { return numDropped; }
+
+    /** Returns the number of bytes of the message with the given status byte. */
+    static int getMessageLength(uint8_t status)
+    {
+      if( status < 0xF0 )
+        return ((status & 0xE0) == 0xC0) ? 2 : 3;
+      switch( status )
+      {
+      case 0xF1:
+      case 0xF3: return 2;
+      case 0xF2: return 3;
+      default:   return 1;
+      }
+    }
+
+    //---------------------------------------------------------------------------------------------
+    // writing/reading:
+
+    /** Appends a message (system exclusive messages are not supported). Returns false if there
+    was not enough room. */
+    INLINE bool writeMessage(const MidiMessage &message);
+
+    /** Takes up to maxBytes bytes out of the buffer and returns their number. */
+    INLINE int read(uint8_t *destination, int maxBytes);
+
+    //=============================================================================================
+
+  protected:
+
+    static const uint32_t mask = capacity - 1;
+
+    uint8_t           bytes[capacity];
+    volatile uint32_t head;          // total number of bytes written (only changed by the writer)
+    volatile uint32_t tail;          // total number of bytes read (only changed by the reader)
+    uint32_t          numDropped;    // number of messages that didn't fit
+    uint8_t           runningStatus; // status of the last channel message written, 0 if none
+
+  };
+
+  //-----------------------------------------------------------------------------------------------
+  // from here: definitions of the functions to be inlined, i.e. all functions which are supposed
+  // to be called at audio-rate (they can't be put into the .cpp file):
+
+  INLINE bool MidiOutBuffer::writeMessage(const MidiMessage &message)
+  {
+    uint8_t  status = message.status;
+    int      length = getMessageLength(status);
+    bool     skipStatus = status < 0xF0 && status == runningStatus;
+    uint32_t h = head;
+
+    if( (uint32_t) capacity - (h - tail) < (uint32_t) (skipStatus ? length-1 : length) )
+    {
+      numDropped++;
+      return false;
+    }
+
+    if( !skipStatus )
+      bytes[h++ & mask] = status;
+    if( length > 1 )
+      bytes[h++ & mask] = message.data1 & 0x7F;
+    if( length > 2 )
+      bytes[h++ & mask] = message.data2 & 0x7F;
+    head = h; // publish the message only after all of its bytes are in place
+
+    // realtime messages don't affect the running status, system common messages cancel it:
+    if( status < 0xF0 )
+      runningStatus = status;
+    else if( status < 0xF8 )
+      runningStatus = 0;
+    return true;
+  }
+
+  INLINE int MidiOutBuffer::read(uint8_t *destination, int maxBytes)
+  {
+    uint32_t t = tail;
+    int n = (int) (head - t);
+    if( n > maxBytes )
+      n = maxBytes;
+    for(int i=0; i<n; i++)
+      destination[i] = bytes[t++ & mask];
+    tail = t;
+    return n;
+  }
+
+} // end namespace rosic
+
+#endif // rosic_MidiOutBuffer_h
@@ -0,0 +1,152 @@
+#ifndef rosic_MidiParser_h
+#define rosic_MidiParser_h
+
+// standard-library includes:
+#include <stdint.h>
+
+// rosic-indcludes:
+#include "GlobalDefinitions.h"
+
+namespace rosic
+{
+
+  /**
+
+  This is a class for representing a complete MIDI message (without system exclusive data). For
+  messages with less than 2 data bytes, the unused ones are zero.
+
+  */
+
+  class MidiMessage
+  {
+  public:
+
+    uint8_t status;
+    uint8_t data1;
+    uint8_t data2;
+
+    MidiMessage()
+    {
+      status = 0;
+      data1  = 0;
+      data2  = 0;
+    }
+
+  };
+
+  /**
+
+  This is a parser that turns a stream of MIDI bytes into messages, one byte at a time. It
+  handles running status and realtime messages that are interleaved with other messages (they are
+  reported immediately and leave the message in progress untouched). System exclusive messages are
+  skipped. The parser does not allocate any memory and does a constant amount of work per byte, so
+  it can be called from an interrupt or a high priority task.
+
+  */
+
+  class MidiParser
+  {
+
+  public:
+
+    //---------------------------------------------------------------------------------------------
+    // construction/destruction:
+
+    /** Constructor. */
+    MidiParser() { reset(); }
+
+    //---------------------------------------------------------------------------------------------
+    // parsing:
+
+    /** Feeds one byte into the parser. Returns true when this byte completes a message, which is
+    then written into message. */
+    INLINE bool parseByte(uint8_t byte, MidiMessage &message);
+
+    /** Forgets the running status and any message in progress. */
+    void reset()
+    {
+      status      = 0;
+      numData     = 0;
+      numExpected = 0;
+      data1       = 0;
+      inSysEx     = false;
+    }
+
+    //=============================================================================================
+
+  protected:
+
+    uint8_t status;      // status of the message in progress (the running status), 0 if none
+    uint8_t data1;       // first data byte of a message in progress
+    uint8_t numData;     // number of data bytes received so far
+    uint8_t numExpected; // number of data bytes of the message in progress
+    bool    inSysEx;     // flag to indicate that we are skipping system exclusive data
+
+  };
+
+  //-----------------------------------------------------------------------------------------------
+  // from here: definitions of the functions to be inlined, i.e. all functions which are supposed
+  // to be called at audio-rate (they can't be put into the .cpp file):
+
+  INLINE bool MidiParser::parseByte(uint8_t byte, MidiMessage &message)
+  {
+    if( byte >= 0xF8 )
+    {
+      // realtime messages may occur anywhere (even within system exclusive data) and don't affect
+      // the running status:
+      message.status = byte;
+      message.data1  = 0;
+      message.data2  = 0;
+      return true;
+    }
+
+    if( byte & 0x80 )
+    {
+      numData = 0;
+      inSysEx = false;
+      if( byte < 0xF0 )
+      {
+        // channel messages - program change and channel pressure have only one data byte:
+        status      = byte;
+        numExpected = ((byte & 0xE0) == 0xC0) ? 1 : 2;
+        return false;
+      }
+
+      // system messages cancel the running status:
+      status = 0;
+      switch( byte )
+      {
+      case 0xF0: inSysEx = true;  return false;
+      case 0xF1:
+      case 0xF3: status = byte; numExpected = 1; return false;
+      case 0xF2: status = byte; numExpected = 2; return false;
+      case 0xF6:
+        message.status = byte;
+        message.data1  = 0;
+        message.data2  = 0;
+        return true;
+      default:   return false; // end of exclusive and undefined ones
+      }
+    }
+
+    // data bytes - ignored, when we don't know what they belong to:
+    if( inSysEx || status == 0 )
+      return false;
+    if( numData == 0 && numExpected == 2 )
+    {
+      data1   = byte;
+      numData = 1;
+      return false;
+    }
+    message.status = status;
+    message.data1  = (numExpected == 2) ? data1 : byte;
+    message.data2  = (numExpected == 2) ? byte  : 0;
+    numData        = 0;
+    if( status >= 0xF0 )
+      status = 0; // system common messages have no running status
+    return true;
+  }
+
+} // end namespace rosic
+
+#endif // rosic_MidiParser_h
@@ -191,7 +191,7 @@ namespace rosic
   //-----------------------------------------------------------------------------------------------
   // inlined functions:
     
-  INLINE float MipMappedWaveTable::getValueLinear(int integerPart, float fractionalPart, int tableIndex)
+  RENDER_INLINE float MipMappedWaveTable::getValueLinear(int integerPart, float fractionalPart, int tableIndex)
   {
     // ensure, that the table index is in the valid range:
     if( tableIndex<=0 )
@@ -199,11 +199,11 @@ namespace rosic
     else if ( tableIndex>numTables )
       tableIndex = 11;
 
-    return   (1.0-fractionalPart) * tableSet[tableIndex][integerPart] 
+    return   (1.0f-fractionalPart) * tableSet[tableIndex][integerPart] 
            +      fractionalPart  * tableSet[tableIndex][integerPart+1];
   }
 
-  INLINE float MipMappedWaveTable::getValueLinear(float phaseIndex, int tableIndex)
+  RENDER_INLINE float MipMappedWaveTable::getValueLinear(float phaseIndex, int tableIndex)
   {
     /*
     // ensure, that the table index is in the valid range:
@@ -2,6 +2,7 @@
 using namespace rosic;
 
 MipMappedWaveTable::MipMappedWaveTable()
+  : fourierTransformer(tableLength) // sized once, so regenerating the tables never allocates
 {
   // init member variables:
   sampleRate = SAMPLE_RATE;
@@ -13,9 +14,6 @@ MipMappedWaveTable::MipMappedWaveTable()
   tanhShaperOffset = 4.37;
   squarePhaseShift = 180.0;
 
-  // set up the fourier-transformer:
-  fourierTransformer.setBlockSize(tableLength);
-
   // initialize the buffers:
   initPrototypeTable();
   initTableSet();
@@ -102,7 +100,7 @@ void MipMappedWaveTable::normalize()
       max = fabs(prototypeTable[i]);
 
   // normalize to amplitude 1.0:
-  float scale = 1.0/max;
+  float scale = 1.0f/max;
   for(i=0; i<tableLength; i++)
     prototypeTable[i] *= scale;
 }
@@ -205,10 +203,10 @@ void MipMappedWaveTable::fillWithTriangle()
     prototypeTable[i] = (float)(4*i) / (float)(tableLength);
 
   for (i=(tableLength/4); i<(3*tableLength/4); i++)
-    prototypeTable[i] = 2.0 - ((float)(4*i) / (float)(tableLength));
+    prototypeTable[i] = 2.0f - ((float)(4*i) / (float)(tableLength));
 
   for (i=(3*tableLength/4); i<(tableLength); i++)
-    prototypeTable[i] = -4.0+ ((float)(4*i) / (float)(tableLength));
+    prototypeTable[i] = -4.0f+ ((float)(4*i) / (float)(tableLength));
 
   generateMipMap();
 }
@@ -237,7 +235,7 @@ void MipMappedWaveTable::fillWithSaw()
   for(int n=0; n<N1; n++)
     prototypeTable[n] = s1*n;
   for(int n=N1; n<N; n++)
-    prototypeTable[n] = -1.0 + s2*(n-N1);
+    prototypeTable[n] = -1.0f + s2*(n-N1);
 
   generateMipMap();
 }
@@ -254,14 +252,14 @@ void MipMappedWaveTable::fillWithSquare303()
   for(int n=0; n<N1; n++)
     prototypeTable[n] = s1*n;
   for(int n=N1; n<N; n++)
-    prototypeTable[n] = -1.0 + s2*(n-N1);
+    prototypeTable[n] = -1.0f + s2*(n-N1);
 
   // switch polarity and apply tanh-shaping with dc-offset:
   for(int n=0; n<N; n++)
     prototypeTable[n] = -tanh(tanhShaperFactor*prototypeTable[n] + tanhShaperOffset);
 
   // do a circular shift to phase-align with the saw-wave, when both waveforms are mixed:
-  int nShift = roundToInt(N*squarePhaseShift/360.0);
+  int nShift = roundToInt(N*squarePhaseShift/360.0f);
   circularShift(prototypeTable, N, nShift);
 
   generateMipMap();
@@ -279,7 +277,7 @@ void MipMappedWaveTable::fillWithSaw303()
   for(int n=0; n<N1; n++)
     prototypeTable[n] = s1*n;
   for(int n=N1; n<N; n++)
-    prototypeTable[n] = -1.0 + s2*(n-N1);
+    prototypeTable[n] = -1.0f + s2*(n-N1);
 
   // switch polarity:
   //for(int n=0; n<N; n++)
@@ -311,7 +309,7 @@ void MipMappedWaveTable::fillWithMoogSaw()
     prototypeTable[i] = (float)(2*i) / (float)(tableLength);
 
   for (i=(tableLength/2); i<(tableLength); i++)
-    prototypeTable[i] = (float)(2*i) / (float)(tableLength) - 2.0;
+    prototypeTable[i] = (float)(2*i) / (float)(tableLength) - 2.0f;
 
   // the triangle part:
   for (i=0; i<(tableLength/2); i++)
@@ -0,0 +1,166 @@
+#ifndef rosic_NoteStack_h
+#define rosic_NoteStack_h
+
+// standard-library includes:
+#include <stdint.h>
+
+// rosic-indcludes:
+#include "GlobalDefinitions.h"
+
+namespace rosic
+{
+
+  /**
+
+  This is a class for keeping track of the keys that are currently held down for a monophonic
+  synth and deciding which of them should sound (last, lowest or highest note priority). It has a
+  fixed capacity of all 128 MIDI keys and stores everything inline, so it never allocates memory.
+  Pushing and removing a key are O(1): the keys are kept in a doubly linked list (in order of
+  arrival) which is threaded through arrays indexed by the key, and additionally in a 128 bit
+  mask from which the lowest and highest key are found with count-leading/trailing-zeros.
+
+  */
+
+  class NoteStack
+  {
+
+  public:
+
+    enum priorityModes
+    {
+      LAST_NOTE = 0,
+      LOW_NOTE,
+      HIGH_NOTE,
+
+      NUM_PRIORITY_MODES
+    };
+
+    //---------------------------------------------------------------------------------------------
+    // construction/destruction:
+
+    /** Constructor. */
+    NoteStack();
+
+    //---------------------------------------------------------------------------------------------
+    // parameter settings:
+
+    /** Selects which of the held keys is the current one, @see priorityModes. */
+    void setPriorityMode(int newMode);
+
+    //---------------------------------------------------------------------------------------------
+    // inquiry:
+
+    /** Returns the selected priority mode, @see priorityModes. */
+    int getPriorityMode() const { return priorityMode; }
+
+    /** Returns true when no key is held. */
+    bool isEmpty() const { return numNotes == 0; }
+
+    /** Returns the number of held keys. */
+    int getNumNotes() const { return numNotes; }
+
+    /** Returns true when the given key is held. */
+    bool isHeld(int key) const
+    { return key >= 0 && key < numKeys && (mask[key >> 5] & (1u << (key & 31))) != 0; }
+
+    /** Returns the velocity with which the given key was pushed (0 when it isn't held). */
+    int getVelocity(int key) const { return isHeld(key) ? velocities[key] : 0; }
+
+    /** Returns the key that should sound according to the priority mode, -1 if none is held. */
+    INLINE int getCurrentKey() const;
+
+    //---------------------------------------------------------------------------------------------
+    // event handling:
+
+    /** Adds a key (as the most recent one - if it was already held, it is moved to the front). */
+    INLINE void push(int key, int velocity);
+
+    /** Removes a key, if it is held. */
+    INLINE void remove(int key);
+
+    /** Removes all keys. */
+    void clear();
+
+    //=============================================================================================
+
+  protected:
+
+    static const int     numKeys = 128;
+    static const uint8_t none    = 0xFF; // end marker for the linked list
+
+    uint8_t  previous[numKeys];   // the next older key for each held key
+    uint8_t  next[numKeys];       // the next more recent key for each held key
+    uint8_t  velocities[numKeys]; // velocity for each held key
+    uint32_t mask[numKeys/32];    // bit k is set when key k is held
+    uint8_t  newest;              // most recently pushed key
+    int      numNotes;            // number of held keys
+    int      priorityMode;        // @see priorityModes
+
+  };
+
+  //-----------------------------------------------------------------------------------------------
+  // from here: definitions of the functions to be inlined, i.e. all functions which are supposed
+  // to be called at audio-rate (they can't be put into the .cpp file):
+
+  INLINE int NoteStack::getCurrentKey() const
+  {
+    if( numNotes == 0 )
+      return -1;
+
+    switch( priorityMode )
+    {
+    case LOW_NOTE:
+      for(int w=0; w<numKeys/32; w++)
+      {
+        if( mask[w] != 0 )
+          return 32*w + __builtin_ctz(mask[w]);
+      }
+      return -1;
+    case HIGH_NOTE:
+      for(int w=numKeys/32-1; w>=0; w--)
+      {
+        if( mask[w] != 0 )
+          return 32*w + 31 - __builtin_clz(mask[w]);
+      }
+      return -1;
+    default:
+      return newest;
+    }
+  }
+
+  INLINE void NoteStack::push(int key, int velocity)
+  {
+    if( key < 0 || key >= numKeys )
+      return;
+    remove(key);
+
+    previous[key]   = numNotes > 0 ? newest : none;
+    next[key]       = none;
+    velocities[key] = (uint8_t) velocity;
+    if( numNotes > 0 )
+      next[newest] = (uint8_t) key;
+    newest = (uint8_t) key;
+    mask[key >> 5] |= 1u << (key & 31);
+    numNotes++;
+  }
+
+  INLINE void NoteStack::remove(int key)
+  {
+    if( !isHeld(key) )
+      return;
+
+    // unlink the key:
+    if( previous[key] != none )
+      next[previous[key]] = next[key];
+    if( next[key] != none )
+      previous[next[key]] = previous[key];
+    else
+      newest = previous[key]; // it was the newest one
+
+    mask[key >> 5] &= ~(1u << (key & 31));
+    numNotes--;
+  }
+
+} // end namespace rosic
+
+#endif // rosic_NoteStack_h
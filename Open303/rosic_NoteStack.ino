@@ -0,0 +1,31 @@
+#include "rosic_NoteStack.h"
+using namespace rosic;
+
+//-------------------------------------------------------------------------------------------------
+// construction/destruction:
+
+NoteStack::NoteStack()
+{
+  priorityMode = LAST_NOTE;
+  clear();
+}
+
+//-------------------------------------------------------------------------------------------------
+// parameter settings:
+
+void NoteStack::setPriorityMode(int newMode)
+{
+  if( newMode >= 0 && newMode < NUM_PRIORITY_MODES )
+    priorityMode = newMode;
+}
+
+//-------------------------------------------------------------------------------------------------
+// event handling:
+
+void NoteStack::clear()
+{
+  for(int w=0; w<numKeys/32; w++)
+    mask[w] = 0;
+  newest   = none;
+  numNotes = 0;
+}
@@ -43,9 +43,9 @@ namespace rosic
     return (i);
      */
 #  else
-    float xFloor = floor(x);
+    float xFloor = floorf(x);
     float xFrac  = x-xFloor;
-    if( xFrac >= 0.5 )
+    if( xFrac >= 0.5f )
       return (int) xFloor + 1;
     else
       return (int) xFloor;
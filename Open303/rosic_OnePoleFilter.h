@@ -108,7 +108,7 @@ class OnePoleFilter
 //-----------------------------------------------------------------------------------------------
 // inlined functions:
 
-inline float OnePoleFilter::getSample(float in)
+RENDER_INLINE float OnePoleFilter::getSample(float in)
 {
   // calculate the output sample:
   y1 = (float)b0 * in + b1 * x1 + a1 * y1 + (float)1.1e-38;
@@ -152,7 +152,7 @@ void OnePoleFilter::calcCoeffs()
   }
 }
 
-void OnePoleFilter::reset()
+void RENDER_CODE OnePoleFilter::reset()
 {
   x1 = 0.0f;
   y1 = 0.0f;
@@ -1,7 +1,7 @@
 #ifndef rosic_Open303_h
 #define rosic_Open303_h
 
-#include "rosic_MidiNoteEvent.h"
+#include "rosic_NoteStack.h"
 #include "rosic_BlendOscillator.h"
 #include "rosic_BiquadFilter.h"
 #include "rosic_TeeBeeFilter.h"
@@ -10,22 +10,45 @@
 #include "rosic_LeakyIntegrator.h"
 #include "rosic_EllipticQuarterBandFilter.h"
 #include "rosic_AcidSequencer.h"
+#include "rosic_StereoPanner.h"
+#include "rosic_StageProfiler.h"
 #include <limits.h>
 
-#include <list>
-using namespace std; // for the noteList
-
 namespace rosic
 {
 
   /**
 
+  This is a class for the large data of an Open303 which is rarely touched while rendering: the 
+  wavetables (with their mip-maps and the FFT used to build them) and the patterns and the song of 
+  the sequencer. Per sample, the oscillator reads only a few values from the current table of the 
+  mip-map. Together this is about 60 kB, whereas the audio-rate state of the synth takes less 
+than 2 kB.
+
+  */
+
+  class Open303ColdData
+  {
+  public:
+
+    MipMappedWaveTable waveTable1, waveTable2;
+    AcidSequencerData  sequencerData;
+
+  };
+
+  /**
+
   This is a monophonic bass-synth that aims to emulate the sound of the famous Roland TB 303 and
   goes a bit beyond.
 
+  The object itself holds only the state and the coefficients that are used at audio-rate, packed 
+  together and aligned to the cache lines, such that rendering touches as few cache lines as 
+  possible. The big tables are held by reference in an Open303ColdData object, which can be put 
+  into another memory than the synth (e.g. the synth into internal RAM and the tables into PSRAM).
+
   */
 
-  class Open303
+  class alignas(CACHE_LINE_SIZE) Open303
   {
 
   public:
@@ -33,8 +56,9 @@ namespace rosic
     //-----------------------------------------------------------------------------------------------
     // construction/destruction:
 
-    /** Constructor. */
-    Open303();
+    /** Constructor. The synth uses the given cold data, which must outlive it, or allocates its own 
+    when it is NULL. */
+    Open303(Open303ColdData *externalColdData = NULL);
 
     /** Destructor. */
     ~Open303();
@@ -56,7 +80,11 @@ namespace rosic
     void setCutoff(float newCutoff); 
 
     /** Sets the resonance amount for the filter. */
-    void setResonance(float newResonance) { filter.setResonance(newResonance); }
+    void setResonance(float newResonance) 
+    { 
+      resonance = resonanceTarget = newResonance; 
+      filter.setResonance(newResonance); 
+    }
 
     /** Sets the modulation depth of the filter's cutoff frequency by the filter-envelope generator 
     (in percent). */
@@ -140,6 +168,40 @@ namespace rosic
       ampEnv.setRelease(newAmpRelease); 
     }
 
+    /** Selects which of the held keys is played (last, lowest or highest), 
+    @see NoteStack::priorityModes. */
+    void setNotePriority(int newPriority) { noteStack.setPriorityMode(newPriority); }
+
+    //  from here: smoothed parameter settings (meant for MIDI controllers):
+
+    /** Sets the time constant (in ms) with which the smoothed parameters approach their targets. 
+    The smoothed parameters are updated once per block of controlBlockSize samples. */
+    void setSmoothingTime(float newSmoothingTime);
+
+    /** Sets the target for the filter's nominal cutoff frequency (in Hz). In contrast to 
+    setCutoff, nothing is recalculated here - the cutoff glides towards the target and the 
+    envelope scaler and offset are updated once per control block, no matter how many targets 
+    were set in between. */
+    void setCutoffTarget(float newCutoff) { cutoffTarget = newCutoff; }
+
+    /** Sets the target for the resonance (in percent), @see setCutoffTarget. */
+    void setResonanceTarget(float newResonance) { resonanceTarget = newResonance; }
+
+    /** Sets the target for the envelope modulation depth (in percent), @see setCutoffTarget. */
+    void setEnvModTarget(float newEnvMod) { envModTarget = newEnvMod; }
+
+    /** Sets the stereo position between -1 (left) and +1 (right) for the panner, which is applied 
+    to blocks of the output (the synth itself is mono), @see StereoPanner. */
+    void setPan(float newPan) { panner.setPan(newPan); }
+
+    /** Sets a function that receives the notes played by the sequencer (velocity 127 for 
+    accented notes, 64 otherwise and 0 for note-offs), for example to send them to MIDI out. On 
+    slides, the new note is sent before the note-off of the old one, so a receiving 303 slides as 
+    well. The function is called from getSample, so it must be quick and must not block. Pass 
+    NULL to turn the output off. */
+    void setSequencerNoteOutput(void (*newNoteOutput)(int key, int velocity)) 
+    { sequencerNoteOutput = newNoteOutput; }
+
     //-----------------------------------------------------------------------------------------------
     // inquiry:
 
@@ -164,7 +226,7 @@ namespace rosic
     float getDecay() const { return normalDecay; }
 
     /** Returns the accent (in percent). */
-    float getAccent() const { return 100.0 * accent; }
+    float getAccent() const { return 100.0f * accent; }
 
     /** Returns the master volume level (in dB). */
     float getVolume() const { return level; }
@@ -216,6 +278,15 @@ namespace rosic
     /** Returns the amplitudes envelope's release time (in milliseconds). */
     float getAmpRelease() const { return normalAmpRelease; }
 
+    /** Returns the note priority, @see NoteStack::priorityModes. */
+    int getNotePriority() const { return noteStack.getPriorityMode(); }
+
+    /** Returns the time constant for the smoothed parameters (in ms). */
+    float getSmoothingTime() const { return smoothingTime; }
+
+    /** Returns the stereo position between -1 (left) and +1 (right). */
+    float getPan() const { return panner.getPan(); }
+
     //-----------------------------------------------------------------------------------------------
     // audio processing:
 
@@ -237,9 +308,12 @@ namespace rosic
     void setPitchBend(float newPitchBend);  
 
     //-----------------------------------------------------------------------------------------------
-    // embedded objects: 
+    // embedded objects (in the order in which getSample uses them, the wavetables are in the cold 
+    // data): 
 
-    MipMappedWaveTable        waveTable1, waveTable2;
+    Open303ColdData * const   coldData;
+    MipMappedWaveTable        &waveTable1, &waveTable2;
+    AcidSequencer             sequencer;
     BlendOscillator           oscillator;
     TeeBeeFilter              filter;
     AnalogEnvelope            ampEnv; 
@@ -253,7 +327,7 @@ namespace rosic
     //EllipticQuarterBandFilter antiAliasFilter;
     
     BiquadFilter              antiAliasFilter;
-    AcidSequencer             sequencer;
+    StereoPanner              panner;
 
   protected:
 
@@ -274,6 +348,13 @@ namespace rosic
 
     void calculateEnvModScalerAndOffset();
 
+    /** Moves the smoothed parameters one control block towards their targets. */
+    INLINE void updateSmoothedParameters();
+
+    /** Passes a note played by the sequencer to the sequencerNoteOutput (key -1 means that the 
+    sounding note was released). */
+    INLINE void outputSequencerNote(int key, bool hasAccent, bool slide);
+
     /** Updates the normalizer n1 according to the time-constant of rc1 and the decay-time of the
     main envelope generator. */
     void updateNormalizer1();
@@ -282,7 +363,8 @@ namespace rosic
     main envelope generator. */
     void updateNormalizer2();
 
-    static const int oversampling = 1;
+    static const int oversampling     = 1;
+    static const int controlBlockSize = 32; // number of samples per smoothed parameter update
 
     float tuning;           // master tunung for A4 in Hz
     float ampScaler;        // final volume as raw factor
@@ -306,32 +388,57 @@ namespace rosic
     float accentGain;       // between 0.0...1.0 - to scale the 3rd amp-envelope on accents
     float pitchWheelFactor; // scale factor for oscillator frequency from pitch-wheel
     float n1, n2;           // normalizers for the RCs that are driven by the MEG
+    float resonance;        // resonance of the filter in percent (smoothed)
+    float cutoffTarget;     // target for the smoothed cutoff
+    float resonanceTarget;  // target for the smoothed resonance
+    float envModTarget;     // target for the smoothed envMod
+    float smoothingTime;    // time constant for the smoothed parameters (in ms)
+    float smoothingCoeff;   // per control block coefficient for the smoothed parameters
+    int    controlCountDown; // samples until the next update of the smoothed parameters
+    int    sequencerOutKey;  // key of the note last sent to the sequencerNoteOutput (-1 if none)
+    void (*sequencerNoteOutput)(int key, int velocity); // receives the sequencer's notes
     int    currentNote;      // note which is currently played (-1 if none)
     int    currentVel;       // velocity of currently played note
     int    noteOffCountDown; // a countdown variable till next note-off in sequencer mode
     bool   slideToNextNote;  // indicate that we need to slide to the next note in sequencer mode
     bool   idle;             // flag to indicate that we have currently nothing to do in getSample
 
-    list<MidiNoteEvent> noteList;
+    NoteStack noteStack;     // the held keys
+
+    bool   ownsColdData;     // true when we allocated the coldData ourselves
+
+  private:
+
+    // not copyable - a copy would share (and delete) the cold data and its wavetables:
+    Open303(const Open303&);
+    Open303& operator=(const Open303&);
 
   };
 
   //-------------------------------------------------------------------------------------------------
   // inlined functions:
 
-  INLINE float Open303::getSample()
+  RENDER_INLINE float Open303::getSample()
   {
     //if( sequencer.getSequencerMode() == AcidSequencer::OFF && ampEnv.endIsReached() )
     //  return 0.0;
-    if( idle )
+    // smoothed parameters are updated at control rate (also when idle to let them settle):
+    if( --controlCountDown <= 0 )
+      updateSmoothedParameters();
+
+    if( idle && !sequencer.isRunning() )
       return 0.0f;
 
     // check the sequencer if we have some note to trigger:
     if( sequencer.getSequencerMode() != AcidSequencer::OFF )
     {
+      PROFILE_STAGE(SEQUENCER);
       noteOffCountDown--;
       if( noteOffCountDown == 0 || sequencer.isRunning() == false )
+      {
         releaseNote(currentNote);
+        outputSequencerNote(-1, false, false);
+      }
 
       AcidNote *note = sequencer.getNote();
       if( note != NULL )
@@ -345,6 +452,7 @@ namespace rosic
             triggerNote(key, note->accent);
           else
             slideToNote(key, note->accent);
+          outputSequencerNote(key, note->accent, slideToNextNote);
 
           AcidNote* nextNote = sequencer.getNextScheduledNote();
           if( note->slide && nextNote->gate == true )
@@ -361,50 +469,68 @@ namespace rosic
       }
     }
 
-    // calculate instantaneous oscillator frequency and set up the oscillator:
-    float instFreq = pitchSlewLimiter.getSample(oscFreq);
-    oscillator.setFrequency(instFreq*pitchWheelFactor);
-    oscillator.calculateIncrement();
-
-    // calculate instantaneous cutoff frequency from the nominal cutoff and all its modifiers and 
-    // set up the filter:
-    float mainEnvOut = mainEnv.getSample();
-    float tmp1       = n1 * rc1.getSample(mainEnvOut);
-    float tmp2       = 0.0f;
-    if( accentGain > 0.0f )
-      tmp2 = mainEnvOut;
-    tmp2 = n2 * rc2.getSample(tmp2);  
-    tmp1 = envScaler * ( tmp1 - envOffset );  // seems not to work yet
-    tmp2 = accentGain*tmp2;
-    float instCutoff = cutoff * powf(2.0f, tmp1+tmp2);
-    filter.setCutoff(instCutoff);
+    float ampEnvOut;
+    {
+      PROFILE_STAGE(MODULATION);
+
+      // calculate instantaneous oscillator frequency and set up the oscillator:
+      float instFreq = pitchSlewLimiter.getSample(oscFreq);
+      oscillator.setFrequency(instFreq*pitchWheelFactor);
+      oscillator.calculateIncrement();
+
+      // calculate instantaneous cutoff frequency from the nominal cutoff and all its modifiers and 
+      // set up the filter:
+      float mainEnvOut = mainEnv.getSample();
+      float tmp1       = n1 * rc1.getSample(mainEnvOut);
+      float tmp2       = 0.0f;
+      if( accentGain > 0.0f )
+        tmp2 = mainEnvOut;
+      tmp2 = n2 * rc2.getSample(tmp2);  
+      tmp1 = envScaler * ( tmp1 - envOffset );  // seems not to work yet
+      tmp2 = accentGain*tmp2;
+      float instCutoff = cutoff * powf(2.0f, tmp1+tmp2);
+      filter.setCutoff(instCutoff);
     
-    float ampEnvOut = ampEnv.getSample();
+      ampEnvOut = ampEnv.getSample();
     
-    //ampEnvOut += 0.45*filterEnvOut + accentGain*6.8*filterEnvOut; 
-    if( ampEnv.isNoteOn() )
-      ampEnvOut += 0.45f*mainEnvOut + accentGain*4.0f*mainEnvOut; 
-    ampEnvOut = ampDeClicker.getSample(ampEnvOut);
+      //ampEnvOut += 0.45*filterEnvOut + accentGain*6.8*filterEnvOut; 
+      if( ampEnv.isNoteOn() )
+        ampEnvOut += 0.45f*mainEnvOut + accentGain*4.0f*mainEnvOut; 
+      ampEnvOut = ampDeClicker.getSample(ampEnvOut);
+    }
 
     // oversampled calculations:
     float tmp;
     for(int i=1; i<=oversampling; i++)
     {
-      tmp  = -oscillator.getSample();         // the raw oscillator signal 
-      tmp  = highpass1.getSample(tmp);        // pre-filter highpass
-      tmp  = filter.getSample(tmp);           // now it's filtered
-      tmp  = antiAliasFilter.getSample(tmp);  // anti-aliasing filtered
+      {
+        PROFILE_STAGE(OSCILLATOR);
+        tmp  = -oscillator.getSample();         // the raw oscillator signal 
+      }
+      {
+        PROFILE_STAGE(FILTER);
+        tmp  = highpass1.getSample(tmp);        // pre-filter highpass
+        tmp  = filter.getSample(tmp);           // now it's filtered
+      }
+      if( oversampling > 1 )                    // without oversampling, there's nothing to
+      {                                         // filter (and a cutoff at Nyquist is unstable)
+        PROFILE_STAGE(ANTI_ALIAS);
+        tmp  = antiAliasFilter.getSample(tmp);  // anti-aliasing filtered
+      }
    //   DEBF ("SYNTH: oversampled tmp: %f\r\n", tmp);
 
     }
 
     // these filters may actually operate without oversampling (but only if we reset them in
     // triggerNote - avoid clicks)
-    tmp  = allpass.getSample(tmp);
-    tmp  = highpass2.getSample(tmp);        
-    tmp  = notch.getSample(tmp);
-    tmp *= ampEnvOut;                       // amplified
-    tmp *= ampScaler;
+    {
+      PROFILE_STAGE(POST_CHAIN);
+      tmp  = allpass.getSample(tmp);
+      tmp  = highpass2.getSample(tmp);        
+      tmp  = notch.getSample(tmp);
+      tmp *= ampEnvOut;                       // amplified
+      tmp *= ampScaler;
+    }
 
     // find out whether we may switch ourselves off for the next call:
     idle = false;
@@ -414,6 +540,54 @@ namespace rosic
     return tmp;
   }
 
+  RENDER_INLINE void Open303::updateSmoothedParameters()
+  {
+    controlCountDown = controlBlockSize;
+
+    // the targets are snapped to once the remaining distance is inaudible (this also makes the 
+    // update free when nothing moves):
+    bool envChanged = false;
+    if( cutoff != cutoffTarget )
+    {
+      cutoff += smoothingCoeff * (cutoffTarget - cutoff);
+      if( fabsf(cutoffTarget - cutoff) < 0.001f * cutoffTarget )
+        cutoff = cutoffTarget;
+      envChanged = true;
+    }
+    if( envMod != envModTarget )
+    {
+      envMod += smoothingCoeff * (envModTarget - envMod);
+      if( fabsf(envModTarget - envMod) < 0.01f )
+        envMod = envModTarget;
+      envChanged = true;
+    }
+    if( envChanged )
+      calculateEnvModScalerAndOffset();
+
+    if( resonance != resonanceTarget )
+    {
+      resonance += smoothingCoeff * (resonanceTarget - resonance);
+      if( fabsf(resonanceTarget - resonance) < 0.01f )
+        resonance = resonanceTarget;
+      filter.setResonance(resonance, false); // coefficients are updated per sample with the cutoff
+    }
+  }
+
+  RENDER_INLINE void Open303::outputSequencerNote(int key, bool hasAccent, bool slide)
+  {
+    int oldKey = sequencerOutKey;
+    if( sequencerNoteOutput == NULL || (key == oldKey && (slide || key < 0)) )
+      return; // nothing to send (or a slide between notes of the same pitch)
+
+    if( oldKey >= 0 && !slide )
+      sequencerNoteOutput(oldKey, 0);
+    if( key >= 0 )
+      sequencerNoteOutput(key, hasAccent ? 127 : 64);
+    if( oldKey >= 0 && slide )
+      sequencerNoteOutput(oldKey, 0);
+    sequencerOutKey = key;
+  }
+
 }
 
 #endif 
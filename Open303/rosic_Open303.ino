@@ -4,8 +4,13 @@ using namespace rosic;
 //-------------------------------------------------------------------------------------------------
 // construction/destruction:
 
-Open303::Open303()
+Open303::Open303(Open303ColdData *externalColdData)
+  : coldData(externalColdData != NULL ? externalColdData : new Open303ColdData),
+    waveTable1(coldData->waveTable1),
+    waveTable2(coldData->waveTable2),
+    sequencer(&coldData->sequencerData)
 {
+  ownsColdData     = externalColdData == NULL;
   tuning           =   440.0;
   ampScaler        =     1.0;
   oscFreq          =   440.0;
@@ -15,6 +20,13 @@ Open303::Open303()
   accent           =     0.0;
   slideTime        =    60.0;
   cutoff           =  1000.0;
+  cutoffTarget     =  cutoff;
+  resonance        = filter.getResonance();
+  resonanceTarget  = resonance;
+  smoothingTime    =    10.0;
+  controlCountDown =     0;
+  sequencerOutKey  =    -1;
+  sequencerNoteOutput = NULL;
   envUpFraction    =     2.0/3.0;
   normalAttack     =     3.0;
   accentAttack     =     3.0;
@@ -24,6 +36,8 @@ Open303::Open303()
   accentAmpRelease =    50.0;
   accentGain       =     0.0;
   pitchWheelFactor =     1.0;
+  n1               =     1.0;
+  n2               =     1.0;
   currentNote      =    -1;
   currentVel       =     0;
   noteOffCountDown =     0;
@@ -61,10 +75,8 @@ Open303::Open303()
   notch.setMode(BiquadFilter::BANDREJECT);
 
   //by copych
-  antiAliasFilter.setSampleRate(2 * SAMPLE_RATE);
   antiAliasFilter.setMode(BiquadFilter::LOWPASS12);
   antiAliasFilter.setGain(0.0f);
-  antiAliasFilter.setFrequency(0.5f * SAMPLE_RATE);
   //end by copych
 
   setSampleRate(sampleRate);
@@ -82,7 +94,8 @@ Open303::Open303()
 
 Open303::~Open303()
 {
-
+  if( ownsColdData )
+    delete coldData;
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -97,12 +110,16 @@ void Open303::setSampleRate(float newSampleRate)
   rc1.setSampleRate(             (float)newSampleRate);
   rc2.setSampleRate(             (float)newSampleRate);
   sequencer.setSampleRate(              newSampleRate);
+  sampleRate = newSampleRate;
+  setSmoothingTime(smoothingTime);
 
   highpass2.setSampleRate     (         newSampleRate);
   allpass.setSampleRate       (         newSampleRate);
   notch.setSampleRate         (         newSampleRate);
 
   highpass1.setSampleRate     (  (float)oversampling*(float)newSampleRate);
+  antiAliasFilter.setSampleRate(  (float)oversampling*(float)newSampleRate);
+  antiAliasFilter.setFrequency (  0.5f*newSampleRate); // cuts at the Nyquist frequency of the output
 
   oscillator.setSampleRate    (  (float)oversampling*(float)newSampleRate);
   filter.setSampleRate        (  (float)oversampling*(float)newSampleRate);
@@ -110,13 +127,13 @@ void Open303::setSampleRate(float newSampleRate)
 
 void Open303::setCutoff(float newCutoff)
 {
-  cutoff = newCutoff;
+  cutoff = cutoffTarget = newCutoff;
   calculateEnvModScalerAndOffset();
 }
 
 void Open303::setEnvMod(float newEnvMod)
 {
-  envMod = newEnvMod;
+  envMod = envModTarget = newEnvMod;
   calculateEnvModScalerAndOffset();
 }
 
@@ -140,6 +157,19 @@ void Open303::setSlideTime(float newSlideTime)
   }
 }
 
+void Open303::setSmoothingTime(float newSmoothingTime)
+{
+  if( newSmoothingTime >= 0.0f )
+    smoothingTime = newSmoothingTime;
+
+  // one-pole coefficient per control block - zero time means jumping to the target:
+  float blocks = 0.001f * smoothingTime * sampleRate / (float) controlBlockSize;
+  if( blocks > 0.0f )
+    smoothingCoeff = 1.0f - expf(-1.0f / blocks);
+  else
+    smoothingCoeff = 1.0f;
+}
+
 void Open303::setPitchBend(float newPitchBend)
 {
   pitchWheelFactor = pitchOffsetToFreqFactor(newPitchBend);
@@ -148,23 +178,28 @@ void Open303::setPitchBend(float newPitchBend)
 //------------------------------------------------------------------------------------------------------------
 // others:
 
-void Open303::noteOn(int noteNumber, int velocity, float detune)
+void Open303::noteOn(int noteNumber, int velocity, float /*detune*/)
 {
   if( sequencer.modeWasChanged() )
     allNotesOff();
 
   if( sequencer.getSequencerMode() != AcidSequencer::OFF )
   {
+    // in HOST_SYNC mode, the sequencer is started and stopped by the clock and the keys only 
+    // select the root note:
+    bool keySync = sequencer.getSequencerMode() == AcidSequencer::KEY_SYNC;
     if( velocity == 0 )
     {
-      sequencer.stop();
+      if( keySync )
+        sequencer.stop();
       releaseNote(currentNote);
       currentNote = -1;
       currentVel  = 0;
     }
     else
     {
-      sequencer.start();
+      if( keySync )
+        sequencer.start();
       noteOffCountDown = INT_MAX;
       slideToNextNote  = false;
       currentNote      = noteNumber;
@@ -176,48 +211,39 @@ void Open303::noteOn(int noteNumber, int velocity, float detune)
 
   if( velocity == 0 ) // velocity zero indicates note-off events
   {
-    MidiNoteEvent releasedNote(noteNumber, 0);
-    noteList.remove(releasedNote);
-    if( noteList.empty() )
-    {
-      currentNote = -1;
-      currentVel  = 0;
-    }
-    else
-    {
-      currentNote = noteList.front().getKey();
-      currentVel  = noteList.front().getVelocity();
-    }
+    noteStack.remove(noteNumber);
+    currentNote = noteStack.getCurrentKey();
+    currentVel  = noteStack.getVelocity(currentNote);
     releaseNote(noteNumber);
   }
   else // velocity was not zero, so this is an actual note-on
   {
-    // check if the note-list is empty (indicating that currently no note is playing) - if so,
-    // trigger a new note, otherwise, slide to the new note:
-    if( noteList.empty() )
+    // check if the stack is empty (indicating that currently no note is playing) - if so,
+    // trigger a new note, otherwise, slide to the new note (if it takes priority):
+    bool wasEmpty = noteStack.isEmpty();
+    noteStack.push(noteNumber, velocity);
+    if( wasEmpty )
       triggerNote(noteNumber, velocity >= 80);
-    else
+    else if( noteStack.getCurrentKey() == noteNumber )
       slideToNote(noteNumber, velocity >= 80);
+    else
+      return; // a held key with higher priority keeps sounding
 
     currentNote = noteNumber;
     currentVel  = 64;
-
-    // and we need to add the new note to our list, of course:
-    MidiNoteEvent newNote(noteNumber, velocity);
-    noteList.push_front(newNote);
   }
   idle = false;
 }
 
 void Open303::allNotesOff()
 {
-  noteList.clear();
+  noteStack.clear();
   ampEnv.noteOff();
   currentNote = -1;
   currentVel  = 0;
 }
 
-void Open303::triggerNote(int noteNumber, bool hasAccent)
+void RENDER_CODE Open303::triggerNote(int noteNumber, bool hasAccent)
 {
   // retrigger osc and reset filter buffers only if amplitude is near zero (to avoid clicks):
   if( idle )
@@ -252,7 +278,7 @@ void Open303::triggerNote(int noteNumber, bool hasAccent)
   idle = false;
 }
 
-void Open303::slideToNote(int noteNumber, bool hasAccent)
+void RENDER_CODE Open303::slideToNote(int noteNumber, bool hasAccent)
 {
   oscFreq = pitchToFreq(noteNumber, tuning);
 
@@ -271,12 +297,12 @@ void Open303::slideToNote(int noteNumber, bool hasAccent)
   idle = false;
 }
 
-void Open303::releaseNote(int noteNumber)
+void RENDER_CODE Open303::releaseNote(int /*noteNumber*/)
 {
   // check if the note-list is empty now. if so, trigger a release, otherwise slide to the note
   // at the beginning of the list (this is the most recent one which is still in the list). this
   // initiates a slide back to the most recent note that is still being held:
-  if( noteList.empty() )
+  if( noteStack.isEmpty() )
   {
     //filterEnvelope.noteOff();
     ampEnv.noteOff();
@@ -288,14 +314,14 @@ void Open303::releaseNote(int noteNumber)
   }
 }
 
-void Open303::setMainEnvDecay(float newDecay)
+void RENDER_CODE Open303::setMainEnvDecay(float newDecay)
 {
   mainEnv.setDecayTimeConstant(newDecay);
   updateNormalizer1();
   updateNormalizer2();
 }
 
-void Open303::calculateEnvModScalerAndOffset()
+void RENDER_CODE Open303::calculateEnvModScalerAndOffset()
 {
   bool useMeasuredMapping = true; // might be shown as user parameter later
   if( useMeasuredMapping == true )
@@ -330,13 +356,13 @@ void Open303::calculateEnvModScalerAndOffset()
   }
 }
 
-void Open303::updateNormalizer1()
+void RENDER_CODE Open303::updateNormalizer1()
 {
   n1 = LeakyIntegrator::getNormalizer(mainEnv.getDecayTimeConstant(), rc1.getTimeConstant(),     sampleRate);
   n1 = 1.0f; // test
 }
 
-void Open303::updateNormalizer2()
+void RENDER_CODE Open303::updateNormalizer2()
 {
   n2 = LeakyIntegrator::getNormalizer(mainEnv.getDecayTimeConstant(), rc2.getTimeConstant(),     sampleRate);
   n2 = 1.0f; // test
@@ -0,0 +1,133 @@
+#ifndef rosic_Open303CCMap_h
+#define rosic_Open303CCMap_h
+
+// standard-library includes:
+#include <stdint.h>
+
+// rosic-indcludes:
+#include "rosic_Open303.h"
+
+namespace rosic
+{
+
+  /**
+
+  This is a descriptor for one MIDI controllable parameter of the Open303: the controller number,
+  the shape of the response curve, the range of the parameter (in the units of the setter) and
+  the setter that receives the mapped value.
+
+  */
+
+  struct Open303CCDescriptor
+  {
+    enum curves
+    {
+      LINEAR = 0,   // value = min + (max-min) * cc/127
+      EXPONENTIAL,  // value = min * (max/min)^(cc/127) - for frequencies and times, min must be > 0
+      DECIBELS      // like LINEAR, but cc = 0 gives silence - for levels in dB
+    };
+
+    uint8_t cc;
+    uint8_t curve;
+    float   min;
+    float   max;
+    void (Open303::*setter)(float);
+  };
+
+  /**
+
+  This is a class that maps MIDI controllers to the parameters of the Open303. The mapping is
+  described by a constant table of descriptors (see rosic_Open303CCMap.ino) and the response
+  curves are evaluated once in the constructor into tables with one entry per controller value,
+  so handling a controller is a table lookup and a call to the setter - no pow/exp per message.
+
+  All parameters can also be set with 14 bit resolution, in which case the tables are
+  interpolated linearly:
+  -for controllers 0...31 by the usual pairs of MSB and LSB (controller number + 32)
+  -for all others by NRPNs, where the parameter number is 0 (MSB) and the controller number (LSB)
+  The MSB alone gives exactly the same value as the plain 7 bit controller, the LSB refines it.
+  Cutoff, resonance and env mod are set via the smoothed setters of the synth, so sweeps with
+  many controller messages neither step nor cause a recalculation per message.
+
+  */
+
+  class Open303CCMap
+  {
+
+  public:
+
+    static const int numControllers = 128;
+    static const int maxDescriptors = 32;
+
+    //---------------------------------------------------------------------------------------------
+    // construction/destruction:
+
+    /** Constructor. Evaluates the response curves of all descriptors. */
+    Open303CCMap();
+
+    //---------------------------------------------------------------------------------------------
+    // inquiry:
+
+    /** Returns the number of mapped controllers. */
+    int getNumDescriptors() const { return numDescriptors; }
+
+    /** Returns the descriptor with the given index (0...getNumDescriptors()-1). */
+    const Open303CCDescriptor& getDescriptor(int index) const { return *descriptors[index]; }
+
+    /** Returns the index of the descriptor for the given controller number or -1 if the
+    controller is not mapped. */
+    int getIndex(int cc) const
+    { return (cc >= 0 && cc < numControllers) ? ccToIndex[cc] : -1; }
+
+    /** Returns the parameter value for the given descriptor index and controller value. */
+    float getValue(int index, int value) const { return curves[index][value & 0x7F]; }
+
+    /** Returns the parameter value for the given descriptor index and a 14 bit value (MSB*128 +
+    LSB). */
+    float getValue14(int index, int value) const
+    {
+      int   i = (value >> 7) & 0x7F;
+      float f = (float) (value & 0x7F) * (1.0f/128.0f);
+      if( i >= numControllers-1 )
+        return curves[index][numControllers-1];
+      return curves[index][i] + f * (curves[index][i+1] - curves[index][i]);
+    }
+
+    //---------------------------------------------------------------------------------------------
+    // event handling:
+
+    /** Applies a controller to the synth (this includes the LSBs and NRPN messages). Returns 
+    false, if the controller is not mapped. */
+    bool handleCC(Open303 &synth, int cc, int value);
+
+    /** Forgets the selected NRPN. */
+    void reset();
+
+    //=============================================================================================
+
+  protected:
+
+    /** Sets the MSB or LSB of the 14 bit value of a parameter and applies it to the synth. */
+    void setValue(Open303 &synth, int index, int value, bool isLsb);
+
+    // controllers for parameter numbers and data entry:
+    static const int dataEntryMsb = 6;
+    static const int dataEntryLsb = 38;
+    static const int nrpnLsb      = 98;
+    static const int nrpnMsb      = 99;
+    static const int rpnLsb       = 100;
+    static const int rpnMsb       = 101;
+
+    int      numDescriptors;
+    int      nrpnIndex;                              // descriptor index of the selected NRPN or -1
+    uint8_t  nrpnNumber[2];                          // selected NRPN number (MSB, LSB)
+    int8_t   ccToIndex[numControllers];              // descriptor index per controller, -1 if none
+    uint16_t values[maxDescriptors];                 // last 14 bit value per descriptor
+    const Open303CCDescriptor *descriptors[maxDescriptors]; // the descriptors in use
+    float    curves[maxDescriptors][numControllers]; // parameter value per controller value
+
+  };
+
+} // end namespace rosic
+
+#endif // rosic_Open303CCMap_h
@@ -0,0 +1,145 @@
+#include "rosic_Open303CCMap.h"
+using namespace rosic;
+
+// the mapping of controllers to parameters - ranges follow the Devil Fish where it has one and
+// otherwise the ones that make musical sense around the defaults of the Open303. The pan range
+// starts a bit below -1 (where it is clipped), such that 64 is the center. The table is looked
+// up by the audio task when it dispatches a controller, so it is kept out of the flash cache:
+static constexpr uint8_t linCurve = Open303CCDescriptor::LINEAR;
+static constexpr uint8_t expCurve = Open303CCDescriptor::EXPONENTIAL;
+static constexpr uint8_t dBCurve  = Open303CCDescriptor::DECIBELS;
+
+// the level of controller value 0 on a DECIBELS curve - the amplitude (1e-20) vanishes in the
+// conversion to integer samples, which is exact silence, while the table stays finite such that
+// the interpolation of the 14 bit values between 0 and 1 still works:
+static constexpr float silenceLevel = -400.0f;
+static constexpr Open303CCDescriptor RENDER_DATA open303CCDescriptors[] =
+{
+  // controller          curve     min              max              setter
+  { CC_303_WAVEFORM,      linCurve, 0.0f,            1.0f,            &Open303::setWaveform },
+  { CC_303_TUNING,        linCurve, 400.0f,          480.0f,          &Open303::setTuning },
+  { CC_303_CUTOFF,        expCurve, MIN_CUTOFF_FREQ, MAX_CUTOFF_FREQ, &Open303::setCutoffTarget },
+  { CC_303_RESO,          linCurve, 0.0f,            100.0f,          &Open303::setResonanceTarget },
+  { CC_303_ENVMOD_LVL,    linCurve, 0.0f,            100.0f,          &Open303::setEnvModTarget },
+  { CC_303_DECAY,         expCurve, 200.0f,          2000.0f,         &Open303::setDecay },
+  { CC_303_ACCENT_LVL,    linCurve, 0.0f,            100.0f,          &Open303::setAccent },
+  { CC_303_VOLUME,        dBCurve,  -60.0f,          0.0f,            &Open303::setVolume },
+  { CC_303_PAN,           linCurve, -64.0f/63.0f,    1.0f,            &Open303::setPan },
+  { CC_303_AMP_SUSTAIN,   linCurve, -60.0f,          0.0f,            &Open303::setAmpSustain },
+  { CC_303_TANH_DRIVE,    linCurve, 0.0f,            60.0f,           &Open303::setTanhShaperDrive },
+  { CC_303_TANH_OFFSET,   linCurve, -10.0f,          10.0f,           &Open303::setTanhShaperOffset },
+  { CC_303_PRE_HPF,       expCurve, 10.0f,           500.0f,          &Open303::setPreFilterHighpass },
+  { CC_303_FEEDBACK_HPF,  expCurve, 10.0f,           500.0f,          &Open303::setFeedbackHighpass },
+  { CC_303_POST_HPF,      expCurve, 10.0f,           500.0f,          &Open303::setPostFilterHighpass },
+  { CC_303_SQUARE_PHASE,  linCurve, 0.0f,            360.0f,          &Open303::setSquarePhaseShift },
+  { CC_303_PORTATIME,     expCurve, 1.0f,            500.0f,          &Open303::setSlideTime },
+  { CC_303_ATTACK,        expCurve, 0.3f,            30.0f,           &Open303::setNormalAttack },
+  { CC_303_ACCENT_ATTACK, expCurve, 0.3f,            30.0f,           &Open303::setAccentAttack },
+  { CC_303_ACCENT_DECAY,  expCurve, 30.0f,           3000.0f,         &Open303::setAccentDecay },
+  { CC_303_AMP_DECAY,     expCurve, 16.0f,           3000.0f,         &Open303::setAmpDecay },
+  { CC_303_AMP_RELEASE,   expCurve, 0.5f,            500.0f,          &Open303::setAmpRelease },
+};
+static constexpr int numOpen303CCDescriptors =
+  sizeof(open303CCDescriptors) / sizeof(open303CCDescriptors[0]);
+
+static_assert(numOpen303CCDescriptors <= Open303CCMap::maxDescriptors,
+  "too many controller descriptors for Open303CCMap");
+
+//-------------------------------------------------------------------------------------------------
+// construction/destruction:
+
+Open303CCMap::Open303CCMap()
+{
+  for(int c=0; c<numControllers; c++)
+    ccToIndex[c] = -1;
+
+  numDescriptors = 0;
+  for(int i=0; i<numOpen303CCDescriptors; i++)
+  {
+    const Open303CCDescriptor &d = open303CCDescriptors[i];
+    if( d.cc >= numControllers || ccToIndex[d.cc] >= 0 )
+      continue; // invalid or duplicate controller number - the first one wins
+
+    ccToIndex[d.cc] = (int8_t) numDescriptors;
+    descriptors[numDescriptors] = &d;
+    values[numDescriptors]      = 0;
+    for(int v=0; v<numControllers; v++)
+    {
+      float x = MIDI_NORM * v;
+      if( d.curve == Open303CCDescriptor::EXPONENTIAL )
+        curves[numDescriptors][v] = linToExp(x, 0.0f, 1.0f, d.min, d.max);
+      else if( d.curve == Open303CCDescriptor::DECIBELS && v == 0 )
+        curves[numDescriptors][v] = silenceLevel;
+      else
+        curves[numDescriptors][v] = d.min + (d.max-d.min) * x;
+    }
+    numDescriptors++;
+  }
+  reset();
+}
+
+//-------------------------------------------------------------------------------------------------
+// event handling:
+
+bool Open303CCMap::handleCC(Open303 &synth, int cc, int value)
+{
+  int index;
+  switch( cc )
+  {
+  case nrpnMsb:
+  case nrpnLsb:
+    // only the NRPNs with MSB 0 are ours, their LSB is the controller number of the parameter:
+    nrpnNumber[cc == nrpnMsb ? 0 : 1] = (uint8_t) value;
+    nrpnIndex = nrpnNumber[0] == 0 ? getIndex(nrpnNumber[1]) : -1;
+    return nrpnIndex >= 0;
+  case rpnMsb:
+  case rpnLsb:
+    reset(); // data entry is meant for an RPN now
+    return false;
+  case dataEntryMsb:
+  case dataEntryLsb:
+    if( nrpnIndex < 0 )
+      return false;
+    setValue(synth, nrpnIndex, value, cc == dataEntryLsb);
+    return true;
+  }
+
+  index = getIndex(cc);
+  if( index >= 0 )
+  {
+    setValue(synth, index, value, false);
+    return true;
+  }
+
+  // LSBs for controllers 0...31:
+  if( cc >= 32 && cc < 64 )
+  {
+    index = getIndex(cc-32);
+    if( index >= 0 )
+    {
+      setValue(synth, index, value, true);
+      return true;
+    }
+  }
+  return false;
+}
+
+void Open303CCMap::reset()
+{
+  nrpnNumber[0] = 127; // the null function
+  nrpnNumber[1] = 127;
+  nrpnIndex     = -1;
+}
+
+//-------------------------------------------------------------------------------------------------
+// internal functions:
+
+void Open303CCMap::setValue(Open303 &synth, int index, int value, bool isLsb)
+{
+  // a new MSB clears the LSB, as usual for 14 bit controllers:
+  if( isLsb )
+    values[index] = (uint16_t) ((values[index] & 0x3F80) | (value & 0x7F));
+  else
+    values[index] = (uint16_t) ((value & 0x7F) << 7);
+  (synth.*(descriptors[index]->setter))(getValue14(index, values[index]));
+}
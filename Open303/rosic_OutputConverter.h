@@ -0,0 +1,115 @@
+#ifndef rosic_OutputConverter_h
+#define rosic_OutputConverter_h
+
+// standard-library includes:
+#include <stdint.h>
+
+// rosic-indcludes:
+#include "GlobalDefinitions.h"
+
+namespace rosic
+{
+
+  /**
+
+  This is a class for converting blocks of float samples (nominal range -1...+1) into the
+  interleaved stereo integer format of the I2S output. Samples beyond full scale are saturated
+  (instead of wrapping around). The output can be 16 bit (int16_t per sample) or 24 or 32 bit (both
+  in int32_t per sample, 24 bit samples are left-justified, i.e. the lowest byte is zero).
+
+  Optionally, TPDF dither (triangular probability density, +-1 LSB) is added before quantization,
+  which turns the quantization distortion of quiet signals into a constant noise floor, and the
+  quantization error can additionally be fed back (first order noise shaping), which moves the
+  noise up in frequency. For 32 bit output, dither makes no sense and is not applied.
+
+  Without dither, the conversion uses the SIMD instructions of the host (SSE2) or the float to
+  integer instructions of the Xtensa FPU, which scale and saturate in hardware. processScalar is a
+  portable reference implementation.
+
+  */
+
+  class OutputConverter
+  {
+
+  public:
+
+    enum ditherModes
+    {
+      NO_DITHER = 0,
+      TPDF,        // triangular dither of +-1 LSB
+      TPDF_SHAPED, // triangular dither with first order noise shaping
+
+      NUM_DITHER_MODES
+    };
+
+    //---------------------------------------------------------------------------------------------
+    // construction/destruction:
+
+    /** Constructor. */
+    OutputConverter();
+
+    //---------------------------------------------------------------------------------------------
+    // parameter settings:
+
+    /** Selects the output format by its number of bits (16, 24 or 32) - other values are ignored. */
+    void setNumBits(int newNumBits);
+
+    /** Selects the dither mode, @see ditherModes. */
+    void setDitherMode(int newMode);
+
+    //---------------------------------------------------------------------------------------------
+    // inquiry:
+
+    /** Returns the number of bits of the output format. */
+    int getNumBits() const { return numBits; }
+
+    /** Returns the size of one output sample in bytes (2 for 16 bit, 4 otherwise). */
+    int getBytesPerSample() const { return numBits == 16 ? 2 : 4; }
+
+    /** Returns the dither mode, @see ditherModes. */
+    int getDitherMode() const { return ditherMode; }
+
+    //---------------------------------------------------------------------------------------------
+    // audio processing:
+
+    /** Converts numFrames samples of both channels into interleaved integer samples (left first)
+    at destination, which must have room for 2*numFrames*getBytesPerSample() bytes. left and right
+    may point to the same buffer (for mono signals). */
+    void process(const float *left, const float *right, void *destination, int numFrames);
+
+    /** Same as process, but always uses the portable scalar code. */
+    void processScalar(const float *left, const float *right, void *destination, int numFrames);
+
+    //---------------------------------------------------------------------------------------------
+    // others:
+
+    /** Resets the state of the noise shaper and the random generator of the dither. */
+    void reset();
+
+    //=============================================================================================
+
+  protected:
+
+    /** The dithered conversion (which is always scalar, because of the error feedback). */
+    void processDithered(const float *left, const float *right, void *destination, int numFrames);
+
+    /** Returns a random value with triangular distribution between -1 and +1. */
+    RENDER_INLINE float getTriangularRandom()
+    {
+      randomState   = 1664525*randomState + 1013904223;
+      int32_t r1    = (int32_t) randomState;
+      randomState   = 1664525*randomState + 1013904223;
+      int32_t r2    = (int32_t) randomState;
+      return ((float) r1 + (float) r2) * (1.0f/4294967296.0f);
+    }
+
+    int      numBits;       // 16, 24 or 32
+    int      ditherMode;    // @see ditherModes
+    uint32_t randomState;   // state of the random generator for the dither
+    float    error[2];      // quantization error of the previous sample (in LSBs) per channel
+
+  };
+
+} // end namespace rosic
+
+#endif // rosic_OutputConverter_h
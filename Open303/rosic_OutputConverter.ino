@@ -0,0 +1,254 @@
+#include "rosic_OutputConverter.h"
+using namespace rosic;
+
+#if defined(__SSE2__)
+  #include <emmintrin.h>
+  #define OUTPUT_CONVERTER_SSE2
+#elif defined(__XTENSA__)
+  #include <xtensa/config/core-isa.h>
+  #if XCHAL_HAVE_FP && XCHAL_HAVE_CLAMPS
+    #define OUTPUT_CONVERTER_XTENSA
+  #endif
+#endif
+
+// full scale and largest (positive) sample value per format as floats - for 32 bit, the largest
+// float below 2^31 is used, as 2^31-1 itself is not representable:
+static const float fullScale16 = 32768.0f;
+static const float fullScale24 = 8388608.0f;
+static const float fullScale32 = 2147483648.0f;
+static const float maxValue16  = 32767.0f;
+static const float maxValue24  = 8388607.0f;
+static const float maxValue32  = 2147483520.0f;
+
+// rounds the (scaled) sample to the nearest integer, saturating at -fullScale and maxValue:
+static RENDER_INLINE int32_t roundAndClip(float x, float fullScale, float maxValue)
+{
+  if( x > maxValue )
+    x = maxValue;
+  if( x < -fullScale )
+    x = -fullScale;
+  return (int32_t) (x >= 0.0f ? x + 0.5f : x - 0.5f);
+}
+
+#ifdef OUTPUT_CONVERTER_XTENSA
+// round.s scales by a power of 2, rounds and saturates to 32 bit in a single instruction, clamps
+// saturates to 16 bit:
+static RENDER_INLINE int32_t xtensaRound16(float x)
+{
+  int32_t r;
+  __asm__ ("round.s %0, %1, 15" : "=a" (r) : "f" (x));
+  __asm__ ("clamps %0, %0, 15" : "+a" (r));
+  return r;
+}
+
+static RENDER_INLINE int32_t xtensaRound24(float x)
+{
+  int32_t r;
+  __asm__ ("round.s %0, %1, 23" : "=a" (r) : "f" (x));
+  r = r >  8388607 ?  8388607 : r; // clamps doesn't go beyond 23 bits
+  r = r < -8388608 ? -8388608 : r;
+  return r;
+}
+
+static RENDER_INLINE int32_t xtensaRound32(float x)
+{
+  int32_t r;
+  __asm__ ("round.s %0, %1, 31" : "=a" (r) : "f" (x));
+  return r;
+}
+#endif
+
+//-------------------------------------------------------------------------------------------------
+// construction/destruction:
+
+OutputConverter::OutputConverter()
+{
+  numBits    = 16;
+  ditherMode = NO_DITHER;
+  reset();
+}
+
+//-------------------------------------------------------------------------------------------------
+// parameter settings:
+
+void OutputConverter::setNumBits(int newNumBits)
+{
+  if( newNumBits == 16 || newNumBits == 24 || newNumBits == 32 )
+    numBits = newNumBits;
+}
+
+void OutputConverter::setDitherMode(int newMode)
+{
+  if( newMode >= 0 && newMode < NUM_DITHER_MODES )
+    ditherMode = newMode;
+}
+
+//-------------------------------------------------------------------------------------------------
+// audio processing:
+
+void RENDER_CODE OutputConverter::process(const float *left, const float *right, void *destination,
+  int numFrames)
+{
+  if( ditherMode != NO_DITHER && numBits != 32 )
+  {
+    processDithered(left, right, destination, numFrames);
+    return;
+  }
+
+  int n = 0;
+
+#if defined(OUTPUT_CONVERTER_SSE2)
+  // 8 frames at a time - clip in the float domain (the conversion would return 0x80000000 for
+  // positive overs), convert with rounding, pack (16 bit) and interleave:
+  float fullScale = numBits == 16 ? fullScale16 : (numBits == 24 ? fullScale24 : fullScale32);
+  float maxValue  = numBits == 16 ? maxValue16  : (numBits == 24 ? maxValue24  : maxValue32);
+  __m128 scale = _mm_set1_ps(fullScale);
+  __m128 hi    = _mm_set1_ps(maxValue);
+  __m128 lo    = _mm_set1_ps(-fullScale);
+  for(; n+8 <= numFrames; n+=8)
+  {
+    __m128i l0 = _mm_cvtps_epi32(_mm_max_ps(_mm_min_ps(_mm_mul_ps(_mm_loadu_ps(left+n),    scale), hi), lo));
+    __m128i l1 = _mm_cvtps_epi32(_mm_max_ps(_mm_min_ps(_mm_mul_ps(_mm_loadu_ps(left+n+4),  scale), hi), lo));
+    __m128i r0 = _mm_cvtps_epi32(_mm_max_ps(_mm_min_ps(_mm_mul_ps(_mm_loadu_ps(right+n),   scale), hi), lo));
+    __m128i r1 = _mm_cvtps_epi32(_mm_max_ps(_mm_min_ps(_mm_mul_ps(_mm_loadu_ps(right+n+4), scale), hi), lo));
+    if( numBits == 16 )
+    {
+      __m128i l  = _mm_packs_epi32(l0, l1);
+      __m128i r  = _mm_packs_epi32(r0, r1);
+      __m128i *d = (__m128i*) ((int16_t*) destination + 2*n);
+      _mm_storeu_si128(d,   _mm_unpacklo_epi16(l, r));
+      _mm_storeu_si128(d+1, _mm_unpackhi_epi16(l, r));
+    }
+    else
+    {
+      if( numBits == 24 )
+      {
+        l0 = _mm_slli_epi32(l0, 8);
+        l1 = _mm_slli_epi32(l1, 8);
+        r0 = _mm_slli_epi32(r0, 8);
+        r1 = _mm_slli_epi32(r1, 8);
+      }
+      __m128i *d = (__m128i*) ((int32_t*) destination + 2*n);
+      _mm_storeu_si128(d,   _mm_unpacklo_epi32(l0, r0));
+      _mm_storeu_si128(d+1, _mm_unpackhi_epi32(l0, r0));
+      _mm_storeu_si128(d+2, _mm_unpacklo_epi32(l1, r1));
+      _mm_storeu_si128(d+3, _mm_unpackhi_epi32(l1, r1));
+    }
+  }
+#elif defined(OUTPUT_CONVERTER_XTENSA)
+  if( numBits == 16 )
+  {
+    int16_t *d = (int16_t*) destination;
+    for(; n<numFrames; n++)
+    {
+      d[2*n]   = (int16_t) xtensaRound16(left[n]);
+      d[2*n+1] = (int16_t) xtensaRound16(right[n]);
+    }
+  }
+  else if( numBits == 24 )
+  {
+    int32_t *d = (int32_t*) destination;
+    for(; n<numFrames; n++)
+    {
+      d[2*n]   = xtensaRound24(left[n])  << 8;
+      d[2*n+1] = xtensaRound24(right[n]) << 8;
+    }
+  }
+  else
+  {
+    int32_t *d = (int32_t*) destination;
+    for(; n<numFrames; n++)
+    {
+      d[2*n]   = xtensaRound32(left[n]);
+      d[2*n+1] = xtensaRound32(right[n]);
+    }
+  }
+#endif
+
+  // the remaining frames (or all of them, when there is no optimized code for this platform):
+  if( n < numFrames )
+  {
+    int bytesPerFrame = 2 * getBytesPerSample();
+    processScalar(left+n, right+n, (uint8_t*) destination + n*bytesPerFrame, numFrames-n);
+  }
+}
+
+void RENDER_CODE OutputConverter::processScalar(const float *left, const float *right, void *destination,
+  int numFrames)
+{
+  if( ditherMode != NO_DITHER && numBits != 32 )
+  {
+    processDithered(left, right, destination, numFrames);
+    return;
+  }
+
+  if( numBits == 16 )
+  {
+    int16_t *d = (int16_t*) destination;
+    for(int n=0; n<numFrames; n++)
+    {
+      d[2*n]   = (int16_t) roundAndClip(fullScale16 * left[n],  fullScale16, maxValue16);
+      d[2*n+1] = (int16_t) roundAndClip(fullScale16 * right[n], fullScale16, maxValue16);
+    }
+  }
+  else if( numBits == 24 )
+  {
+    int32_t *d = (int32_t*) destination;
+    for(int n=0; n<numFrames; n++)
+    {
+      d[2*n]   = roundAndClip(fullScale24 * left[n],  fullScale24, maxValue24) * 256;
+      d[2*n+1] = roundAndClip(fullScale24 * right[n], fullScale24, maxValue24) * 256;
+    }
+  }
+  else
+  {
+    int32_t *d = (int32_t*) destination;
+    for(int n=0; n<numFrames; n++)
+    {
+      d[2*n]   = roundAndClip(fullScale32 * left[n],  fullScale32, maxValue32);
+      d[2*n+1] = roundAndClip(fullScale32 * right[n], fullScale32, maxValue32);
+    }
+  }
+}
+
+void RENDER_CODE OutputConverter::processDithered(const float *left, const float *right, void *destination,
+  int numFrames)
+{
+  float   fullScale = numBits == 16 ? fullScale16 : fullScale24;
+  float   maxValue  = numBits == 16 ? maxValue16  : maxValue24;
+  bool    shaped    = ditherMode == TPDF_SHAPED;
+  int16_t *d16      = (int16_t*) destination;
+  int32_t *d32      = (int32_t*) destination;
+
+  for(int n=0; n<numFrames; n++)
+  {
+    for(int c=0; c<2; c++)
+    {
+      // everything in LSBs of the output format from here:
+      float x = fullScale * (c == 0 ? left[n] : right[n]);
+      if( shaped )
+        x -= error[c];
+      int32_t q = roundAndClip(x + getTriangularRandom(), fullScale, maxValue);
+      if( shaped )
+      {
+        // the error is limited, such that clipping can't make the feedback run away:
+        float e  = (float) q - x;
+        error[c] = e > 1.5f ? 1.5f : (e < -1.5f ? -1.5f : e);
+      }
+      if( numBits == 16 )
+        d16[2*n+c] = (int16_t) q;
+      else
+        d32[2*n+c] = q * 256;
+    }
+  }
+}
+
+//-------------------------------------------------------------------------------------------------
+// others:
+
+void OutputConverter::reset()
+{
+  randomState = 0x12345678;
+  error[0]    = 0.0f;
+  error[1]    = 0.0f;
+}
@@ -0,0 +1,146 @@
+#ifndef rosic_StageProfiler_h
+#define rosic_StageProfiler_h
+
+// standard-library includes:
+#include <stdint.h>
+#if !defined(__XTENSA__) && (defined(__x86_64__) || defined(__i386__))
+  #include <x86intrin.h>
+#elif !defined(__XTENSA__)
+  #include <chrono>
+#endif
+
+// rosic-indcludes:
+#include "GlobalDefinitions.h"
+
+namespace rosic
+{
+
+  /**
+
+  This is a class for measuring how the time in the signal chain of the Open303 is spread among
+  its stages. The code of a stage is wrapped into a scope with PROFILE_STAGE(stage), which adds
+  the ticks spent in the scope to the stage (CPU cycles on the ESP32 and on x86, nanoseconds
+  elsewhere). The markers are only compiled in when PROFILE_SYNTH is defined - otherwise they
+  expand to nothing and cost nothing.
+
+  The counters are written by the audio task without any synchronization, so a breakdown that is
+  read while the synth runs may be off by the last few samples, which doesn't matter for this.
+
+  */
+
+  class StageProfiler
+  {
+
+  public:
+
+    enum stages
+    {
+      SEQUENCER = 0, // sequencer and note triggering
+      MODULATION,    // pitch slew, envelopes, cutoff and amplitude calculation
+      OSCILLATOR,    // the oscillator (oversampled)
+      FILTER,        // pre-filter highpass and TeeBeeFilter (oversampled)
+      ANTI_ALIAS,    // anti-aliasing filter (only with oversampling)
+      POST_CHAIN,    // allpass, post-filter highpass, notch and amplifier
+
+      NUM_STAGES
+    };
+
+    //---------------------------------------------------------------------------------------------
+    // construction/destruction:
+
+    /** Constructor. */
+    StageProfiler() { reset(); }
+
+    //---------------------------------------------------------------------------------------------
+    // inquiry:
+
+    /** Returns the name of a stage. */
+    static const char* getStageName(int stage);
+
+    /** Returns the ticks spent in a stage since the last reset. */
+    uint64_t getTicks(int stage) const { return ticks[stage]; }
+
+    /** Returns how often a stage was entered since the last reset. */
+    uint32_t getNumCalls(int stage) const { return numCalls[stage]; }
+
+    /** Writes the breakdown as a table (one line per stage with the total ticks, the ticks per call
+    and the share of the sum of all stages) into buffer and returns the length of the text. */
+    int format(char *buffer, int bufferSize) const;
+
+    /** Returns the current value of the tick counter. */
+    static INLINE uint32_t readTicks()
+    {
+#if defined(__XTENSA__)
+      uint32_t c;
+      __asm__ __volatile__ ("rsr %0, ccount" : "=a" (c));
+      return c;
+#elif defined(__x86_64__) || defined(__i386__)
+      return (uint32_t) __rdtsc();
+#else
+      return (uint32_t) std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+
+    //---------------------------------------------------------------------------------------------
+    // recording:
+
+    /** Adds the ticks of one pass through a stage. */
+    INLINE void add(int stage, uint32_t numTicks)
+    {
+      ticks[stage] += numTicks;
+      numCalls[stage]++;
+    }
+
+    /** Clears all counters. */
+    void reset();
+
+    //=============================================================================================
+
+  protected:
+
+    uint64_t ticks[NUM_STAGES];    // accumulated ticks per stage
+    uint32_t numCalls[NUM_STAGES]; // number of passes per stage
+
+  };
+
+  /** The profiler used by the PROFILE_STAGE markers. */
+  extern StageProfiler stageProfiler;
+
+  /**
+
+  Adds the ticks from its construction to its destruction to a stage of the profiler.
+
+  */
+
+  class ProfileScope
+  {
+  public:
+
+    INLINE ProfileScope(int stageToMeasure)
+    {
+      stage = stageToMeasure;
+      start = StageProfiler::readTicks();
+    }
+
+    INLINE ~ProfileScope() { stageProfiler.add(stage, StageProfiler::readTicks() - start); }
+
+  protected:
+
+    int      stage;
+    uint32_t start;
+
+  };
+
+} // end namespace rosic
+
+#define PROFILE_CONCAT2(a, b) a##b
+#define PROFILE_CONCAT(a, b)  PROFILE_CONCAT2(a, b)
+#ifdef PROFILE_SYNTH
+  #define PROFILE_STAGE(stage) \
+    rosic::ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(rosic::StageProfiler::stage)
+#else
+  #define PROFILE_STAGE(stage)
+#endif
+
+#endif // rosic_StageProfiler_h
@@ -0,0 +1,48 @@
+#include "rosic_StageProfiler.h"
+#include <stdio.h>
+using namespace rosic;
+
+StageProfiler rosic::stageProfiler;
+
+//-------------------------------------------------------------------------------------------------
+// inquiry:
+
+const char* StageProfiler::getStageName(int stage)
+{
+  static const char *names[NUM_STAGES] =
+    { "sequencer", "modulation", "oscillator", "filter", "anti-alias", "post chain" };
+  if( stage < 0 || stage >= NUM_STAGES )
+    return "";
+  return names[stage];
+}
+
+int StageProfiler::format(char *buffer, int bufferSize) const
+{
+  uint64_t total = 0;
+  for(int s=0; s<NUM_STAGES; s++)
+    total += ticks[s];
+
+  int length = snprintf(buffer, bufferSize, "%-12s %14s %10s %8s\r\n",
+    "stage", "ticks", "per call", "share");
+  for(int s=0; s<NUM_STAGES && length < bufferSize; s++)
+  {
+    unsigned long long t = ticks[s];
+    float perCall = numCalls[s] > 0 ? (float) t / (float) numCalls[s] : 0.0f;
+    float share   = total > 0 ? 100.0f * (float) t / (float) total : 0.0f;
+    length += snprintf(buffer+length, bufferSize-length, "%-12s %14llu %10.1f %7.1f%%\r\n",
+      getStageName(s), t, (double) perCall, (double) share);
+  }
+  return length < bufferSize ? length : bufferSize-1;
+}
+
+//-------------------------------------------------------------------------------------------------
+// recording:
+
+void StageProfiler::reset()
+{
+  for(int s=0; s<NUM_STAGES; s++)
+  {
+    ticks[s]    = 0;
+    numCalls[s] = 0;
+  }
+}
@@ -0,0 +1,73 @@
+#ifndef rosic_StereoPanner_h
+#define rosic_StereoPanner_h
+
+// rosic-indcludes:
+#include "rosic_RealFunctions.h"
+
+namespace rosic
+{
+
+  /**
+
+  This is a class for placing a mono signal in the stereo field with a constant power pan law.
+  The gains are looked up (with linear interpolation) in a small table of a quarter sine when the
+  pan is set, so nothing trigonometric is calculated at audio rate. Changes of the pan are applied
+  at block rate: the gains ramp linearly from their old to their new values over the next block,
+  which avoids zipper noise. The gains are scaled such that the center position passes the signal
+  at unity gain on both channels (so hard left/right is +3 dB on one side).
+
+  */
+
+  class StereoPanner
+  {
+
+  public:
+
+    //---------------------------------------------------------------------------------------------
+    // construction/destruction:
+
+    /** Constructor. */
+    StereoPanner();
+
+    //---------------------------------------------------------------------------------------------
+    // parameter settings:
+
+    /** Sets the pan between -1 (hard left) and +1 (hard right), 0 is the center. The new gains are
+    reached at the end of the next block. */
+    void setPan(float newPan);
+
+    //---------------------------------------------------------------------------------------------
+    // inquiry:
+
+    /** Returns the pan between -1 and +1. */
+    float getPan() const { return pan; }
+
+    //---------------------------------------------------------------------------------------------
+    // audio processing:
+
+    /** Pans a block of numFrames mono samples into left and right. The input may be the same
+    buffer as left (or right), so the block can be processed in place. */
+    void process(const float *in, float *left, float *right, int numFrames);
+
+    //---------------------------------------------------------------------------------------------
+    // others:
+
+    /** Makes the gains jump to their targets (without the ramp over the next block). */
+    void reset();
+
+    //=============================================================================================
+
+  protected:
+
+    static const int tableSize = 64; // number of intervals of the quarter sine table
+
+    float gainTable[tableSize+1]; // sqrt(2) * sin(x) for x = 0...pi/2
+    float pan;                    // -1...+1
+    float gainL, gainR;           // current gains
+    float targetL, targetR;       // gains at the end of the next block
+
+  };
+
+} // end namespace rosic
+
+#endif // rosic_StereoPanner_h
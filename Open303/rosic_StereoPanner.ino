@@ -0,0 +1,71 @@
+#include "rosic_StereoPanner.h"
+using namespace rosic;
+
+//-------------------------------------------------------------------------------------------------
+// construction/destruction:
+
+StereoPanner::StereoPanner()
+{
+  for(int i=0; i<=tableSize; i++)
+    gainTable[i] = SQRT2 * sinf(HALFPI * i / tableSize);
+  gainTable[tableSize/2] = 1.0f; // exactly unity in the center
+
+  setPan(0.0f);
+  reset();
+}
+
+//-------------------------------------------------------------------------------------------------
+// parameter settings:
+
+void StereoPanner::setPan(float newPan)
+{
+  pan = clip(newPan, -1.0f, 1.0f);
+
+  // position in the table for the right channel, the left one is the mirror image:
+  float x = 0.5f * (pan + 1.0f) * tableSize;
+  int   i = (int) x;
+  if( i >= tableSize )
+    i = tableSize-1;
+  float f = x - i;
+  targetR = gainTable[i]           + f * (gainTable[i+1]           - gainTable[i]);
+  targetL = gainTable[tableSize-i] + f * (gainTable[tableSize-i-1] - gainTable[tableSize-i]);
+}
+
+//-------------------------------------------------------------------------------------------------
+// audio processing:
+
+void RENDER_CODE StereoPanner::process(const float *in, float *left, float *right, int numFrames)
+{
+  if( gainL == targetL && gainR == targetR )
+  {
+    for(int n=0; n<numFrames; n++)
+    {
+      float x  = in[n];
+      left[n]  = gainL * x;
+      right[n] = gainR * x;
+    }
+    return;
+  }
+
+  float incL = (targetL - gainL) / numFrames;
+  float incR = (targetR - gainR) / numFrames;
+  for(int n=0; n<numFrames; n++)
+  {
+    gainL   += incL;
+    gainR   += incR;
+    float x  = in[n];
+    left[n]  = gainL * x;
+    right[n] = gainR * x;
+  }
+  gainL = targetL; // no rounding errors left over
+  gainR = targetR;
+}
+
+//-------------------------------------------------------------------------------------------------
+// others:
+
+void StereoPanner::reset()
+{
+  gainL = targetL;
+  gainR = targetR;
+}
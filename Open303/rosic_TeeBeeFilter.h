@@ -67,7 +67,8 @@ namespace rosic
 
     /** Sets the cutoff frequency for this filter - the actual coefficient calculation may be 
     supressed by passing 'false' as second parameter, in this case, it should be triggered
-    manually later by calling calculateCoefficients. */
+    manually later by calling calculateCoefficients. The cutoff is limited to 20 kHz and to a fifth 
+    of the sample-rate, above which the filter becomes unstable with resonance. */
     INLINE void setCutoff(float newCutoff, bool updateCoefficients = true);
 
     /** Sets the resonance in percent where 100% is self oscillation. */
@@ -89,7 +90,7 @@ namespace rosic
     float getCutoff() const { return cutoff; }
 
     /** Returns the resonance parameter of this filter. */
-    float getResonance() const { return 100.0 * resonanceRaw; }
+    float getResonance() const { return 100.0f * resonanceRaw; }
 
     /** Returns the drive parameter in decibels. */
     float getDrive() const { return drive; }
@@ -138,6 +139,7 @@ namespace rosic
     float resonanceSkewed;     // mapped resonance parameter to make it behave more musical
     float sampleRate;          // the sample rate in Hz
     float twoPiOverSampleRate; // 2*PI/sampleRate
+    float maxCutoff;           // upper limit for the cutoff frequency
     int    mode;                // the selected filter-mode
 
     OnePoleFilter feedbackHighpass;
@@ -147,14 +149,14 @@ namespace rosic
   //-----------------------------------------------------------------------------------------------
   // inlined functions:
 
-  INLINE void TeeBeeFilter::setCutoff(float newCutoff, bool updateCoefficients)
+  RENDER_INLINE void TeeBeeFilter::setCutoff(float newCutoff, bool updateCoefficients)
   {
     if( newCutoff != cutoff )
     {
       if( newCutoff < 200.0f )  // an absolute floor for the cutoff frequency - tweakable
         cutoff = 200.0f;  
-      else if( newCutoff > 20000.0f )
-        cutoff = 20000.0f;
+      else if( newCutoff > maxCutoff )
+        cutoff = maxCutoff;
       else
         cutoff = newCutoff;
 
@@ -163,7 +165,7 @@ namespace rosic
     }
   }
 
-  INLINE void TeeBeeFilter::setResonance(float newResonance, bool updateCoefficients)
+  RENDER_INLINE void TeeBeeFilter::setResonance(float newResonance, bool updateCoefficients)
   {
     resonanceRaw    = 0.01f * newResonance;
     resonanceSkewed = (1.0f-expf(-3.0f*resonanceRaw)) / (1.0f-expf(-3.0f));
@@ -177,14 +179,14 @@ namespace rosic
     float wc = (float)twoPiOverSampleRate * (float)cutoff;
     float s, c;
     sinCos(wc, &s, &c);             // c = cos(wc); s = sin(wc);
-    float t  = tan(0.25f*(wc-PI));
+    float t  = tanf(0.25f*(wc-(float)PI));
     float r  = resonanceSkewed;
 
     // calculate filter a1-coefficient tuned such the resonance frequency is just right:
     float a1_fullRes = t / (s-c*t);
 
     // calculate filter a1-coefficient as if there were no resonance:
-    float x        = exp(-wc);
+    float x        = expf(-wc);
     float a1_noRes = -x;
 
     // use a weighted sum between the resonance-tuned and no-resonance coefficient:
@@ -203,7 +205,7 @@ namespace rosic
       k *= 4.25f;
   }
 
-  INLINE void TeeBeeFilter::calculateCoefficientsApprox4()
+  RENDER_INLINE void TeeBeeFilter::calculateCoefficientsApprox4()
   {
     // calculate intermediate variables:
     float wc  = twoPiOverSampleRate * cutoff;
@@ -265,7 +267,7 @@ namespace rosic
     }
   }
 
-  INLINE float TeeBeeFilter::shape(float x)
+  RENDER_INLINE float TeeBeeFilter::shape(float x)
   {
     // return tanhApprox(x); // \todo: find some more suitable nonlinearity here
     //return x; // test
@@ -277,7 +279,7 @@ namespace rosic
     //return clip(x, -1.0, 1.0);
   }
 
-  INLINE float TeeBeeFilter::getSample(float in)
+  RENDER_INLINE float TeeBeeFilter::getSample(float in)
   {
     float y0;
 
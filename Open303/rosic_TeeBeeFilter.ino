@@ -14,6 +14,7 @@ TeeBeeFilter::TeeBeeFilter()
   g                   =     1.0f;
   sampleRate          = SAMPLE_RATE;
   twoPiOverSampleRate = (float)TWOPI * (float)DIV_SAMPLE_RATE;
+  maxCutoff           = 0.2f*SAMPLE_RATE < 20000.0f ? 0.2f*SAMPLE_RATE : 20000.0f;
 
   feedbackHighpass.setMode(OnePoleFilter::HIGHPASS);
   feedbackHighpass.setCutoff(150.0f);
@@ -34,9 +35,10 @@ TeeBeeFilter::~TeeBeeFilter()
 
 void TeeBeeFilter::setSampleRate(float newSampleRate)
 {
-  if( newSampleRate > 0.0 )
+  if( newSampleRate > 0.0f )
     sampleRate = newSampleRate;
-  twoPiOverSampleRate = (float)TWOPI * (float)DIV_SAMPLE_RATE;
+  twoPiOverSampleRate = (float)TWOPI * (1.0f/sampleRate);
+  maxCutoff = 0.2f*sampleRate < 20000.0f ? 0.2f*sampleRate : 20000.0f;
   feedbackHighpass.setSampleRate(newSampleRate);
   calculateCoefficientsExact();
 }
@@ -78,7 +80,7 @@ void TeeBeeFilter::setMode(int newMode)
 //-------------------------------------------------------------------------------------------------
 // others:
 
-void TeeBeeFilter::reset()
+void RENDER_CODE TeeBeeFilter::reset()
 {
   feedbackHighpass.reset();
   y1 = 0.0f;
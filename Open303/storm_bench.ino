@@ -0,0 +1,90 @@
+#ifdef STORM_BENCH
+
+// Benchmark for the tail latency of the audio task: renders a few seconds block by block for each
+// block size of the LatencyController and each kind of rosic::EventStorm (worst-case bursts of
+// notes, controllers and waveform changes) with an extra Open303 in internal RAM, and prints the
+// 50th, 99th and 99.9th percentile and the maximum of the render time of a block in CPU cycles
+// and microseconds, next to the deadline. A block is rendered like in audio_task1: the events,
+// the synth, the panner and the conversion. host/storm_bench runs the same storms on the host.
+// The results go to USBSerial, so DEBUG_ON is needed (without MIDI_VIA_SERIAL).
+
+#include <new>
+#include "esp_heap_caps.h"
+#include "rosic_EventStorm.h"
+
+#define STORM_BENCH_SECONDS 4
+
+static void* storm_bench_alloc(size_t size) {
+  return heap_caps_aligned_alloc(CACHE_LINE_SIZE, size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+}
+
+void storm_bench() {
+#if defined DEBUG_ON && !defined MIDI_VIA_SERIAL
+  const int max_blocks = STORM_BENCH_SECONDS * SAMPLE_RATE / rosic::LatencyController::minBlockSize;
+  const int max_len = rosic::LatencyController::maxBlockSize;
+  void *synth_mem  = storm_bench_alloc(sizeof(rosic::Open303));
+  void *cold_mem   = storm_bench_alloc(sizeof(rosic::Open303ColdData));
+  void *cc_map_mem = storm_bench_alloc(sizeof(rosic::Open303CCMap)); // too big for the stack
+  uint32_t *cycles = (uint32_t*)heap_caps_malloc(max_blocks * sizeof(uint32_t), MALLOC_CAP_8BIT);
+  float *left  = (float*)heap_caps_malloc(max_len * sizeof(float), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+  float *right = (float*)heap_caps_malloc(max_len * sizeof(float), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+  i2s_sample_t *out = (i2s_sample_t*)heap_caps_malloc(2 * max_len * sizeof(i2s_sample_t),
+    MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+  if (synth_mem == NULL || cold_mem == NULL || cc_map_mem == NULL || cycles == NULL || left == NULL || right == NULL || out == NULL) {
+    USBSerial.printf("storm bench: not enough memory\n");
+  } else {
+    rosic::Open303ColdData *cold = new (cold_mem) rosic::Open303ColdData;
+    rosic::Open303 *synth = new (synth_mem) rosic::Open303(cold);
+    rosic::Open303CCMap *cc_map = new (cc_map_mem) rosic::Open303CCMap;
+    rosic::OutputConverter converter;
+    converter.setNumBits(I2S_BITS);
+    converter.setDitherMode(I2S_DITHER);
+    float mhz = getCpuFrequencyMhz();
+
+    USBSerial.printf("%-12s %5s %9s %9s %9s %9s %9s %5s (cycles, max also in us)\n", "storm", "block",
+      "deadline", "p50", "p99", "p99.9", "max", "late");
+    for (int kind = 0; kind < rosic::EventStorm::NUM_KINDS; kind++) {
+      for (int len = rosic::LatencyController::minBlockSize; len <= max_len; len *= 2) {
+        rosic::EventStorm storm;
+        storm.setKind(kind);
+        storm.start(*synth);
+        int num_blocks = STORM_BENCH_SECONDS * SAMPLE_RATE / len;
+        int warm_up = SAMPLE_RATE / len; // the first second is not measured
+        uint32_t deadline = (uint32_t)(len * mhz * 1e6f / SAMPLE_RATE);
+        int late = 0;
+        for (int b = -warm_up; b < num_blocks; b++) {
+          uint32_t start = ESP.getCycleCount();
+          storm.applyBlock(*synth, *cc_map);
+          for (int i = 0; i < len; i++) {
+            left[i] = synth->getSample();
+          }
+          synth->panner.process(left, left, right, len);
+          converter.process(left, right, out, len);
+          uint32_t c = ESP.getCycleCount() - start;
+          if (b < 0) continue;
+          cycles[b] = c;
+          if (c > deadline) late++;
+        }
+        rosic::EventStorm::Percentiles p;
+        rosic::EventStorm::getPercentiles(cycles, num_blocks, p);
+        USBSerial.printf("%-12s %5d %9u %9u %9u %9u %9u %5d (%.0f us)\n",
+          rosic::EventStorm::getKindName(kind), len, deadline, p.p50, p.p99, p.p999, p.max, late,
+          p.max / mhz);
+      }
+    }
+
+    cc_map->~Open303CCMap();
+    synth->~Open303();
+    cold->~Open303ColdData();
+  }
+  heap_caps_free(out);
+  heap_caps_free(right);
+  heap_caps_free(left);
+  heap_caps_free(cycles);
+  heap_caps_free(synth_mem);
+  heap_caps_free(cold_mem);
+  heap_caps_free(cc_map_mem);
+#endif
+}
+
+#endif
@@ -0,0 +1,149 @@
+// Bulk generator for acid lines - builds corpora of musical input for the synth on the host.
+//
+//   acid_corpus [--seed N] [--count N] [--lines-per-set N] [--out FILE] [--bench] [--check]
+//
+// Writes count lines of AcidLine::serializedSize bytes each (16 notes, accent and glide masks as
+// little endian 16 bit words) to FILE (or stdout). The output only depends on the arguments, so
+// the same seed (any 64 bit number) always gives the same corpus. With --bench, nothing is written
+// and the generation rate is reported instead.
+//
+// With --check, nothing is written either, and the corpus is checked for repetition instead: it
+// fails (exit code 1) when a whole note set block of lines-per-set lines occurs twice, which is
+// what a random generator with a short period produces, or when more than 0.1% of the lines are
+// duplicates. Some duplicates are expected: with the single note interval set, a line has few
+// enough variants that a long corpus draws some of them twice by chance.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include "rosic_host.h"
+
+static void usage()
+{
+  fprintf(stderr,
+    "usage: acid_corpus [--seed N] [--count N] [--lines-per-set N] [--out FILE] [--bench]\n"
+    "                   [--check]\n");
+}
+
+// FNV-1a, for finding the duplicates (a false match between 64 bit hashes is negligible here):
+static uint64_t hashBytes(const uint8_t *data, size_t size)
+{
+  uint64_t h = 0xcbf29ce484222325ULL;
+  for(size_t i=0; i<size; i++)
+    h = (h ^ data[i]) * 0x100000001b3ULL;
+  return h;
+}
+
+// the number of values which are equal to the one before them after sorting:
+static long countDuplicates(std::vector<uint64_t> &hashes)
+{
+  std::sort(hashes.begin(), hashes.end());
+  long n = 0;
+  for(size_t i=1; i<hashes.size(); i++)
+    n += hashes[i] == hashes[i-1];
+  return n;
+}
+
+int main(int argc, char **argv)
+{
+  unsigned long long seed   = 0x1234;
+  long          count       = 1000000;
+  int           linesPerSet = 16;
+  const char   *outPath     = NULL;
+  bool          bench       = false;
+  bool          check       = false;
+
+  for(int i=1; i<argc; i++)
+  {
+    bool hasValue = i+1 < argc;
+    if(      !strcmp(argv[i], "--seed")          && hasValue ) seed        = strtoull(argv[++i], NULL, 0);
+    else if( !strcmp(argv[i], "--count")         && hasValue ) count       = strtol(argv[++i], NULL, 0);
+    else if( !strcmp(argv[i], "--lines-per-set") && hasValue ) linesPerSet = atoi(argv[++i]);
+    else if( !strcmp(argv[i], "--out")           && hasValue ) outPath     = argv[++i];
+    else if( !strcmp(argv[i], "--bench") )                     bench       = true;
+    else if( !strcmp(argv[i], "--check") )                     check       = true;
+    else { usage(); return 1; }
+  }
+  if( count < 0 || linesPerSet < 1 )
+  {
+    usage();
+    return 1;
+  }
+
+  rosic::AcidGenerator generator;
+  generator.setBulkSeed(seed);
+
+  // generate in chunks, such that the memory use doesn't depend on the count:
+  const long chunkLines = 65536;
+  std::vector<uint8_t> buffer(chunkLines * rosic::AcidLine::serializedSize);
+
+  std::vector<uint64_t> lineHashes, blockHashes;
+  if( check )
+  {
+    lineHashes.reserve(count);
+    blockHashes.reserve(count / linesPerSet);
+  }
+
+  FILE *out = NULL;
+  if( !bench && !check )
+  {
+    out = outPath ? fopen(outPath, "wb") : stdout;
+    if( out == NULL )
+    {
+      perror(outPath);
+      return 1;
+    }
+  }
+
+  // the note set changes every linesPerSet lines across the chunk boundaries too, so the chunks
+  // are aligned to it:
+  long alignedChunk = chunkLines - chunkLines % linesPerSet;
+  if( alignedChunk <= 0 )
+    alignedChunk = chunkLines;
+
+  unsigned checksum = 0;
+  auto start = std::chrono::steady_clock::now();
+  for(long done = 0; done < count; )
+  {
+    int n = (int) (count-done < alignedChunk ? count-done : alignedChunk);
+    generator.generateBulk(buffer.data(), n, linesPerSet);
+    size_t bytes = (size_t) n * rosic::AcidLine::serializedSize;
+    if( out != NULL && fwrite(buffer.data(), 1, bytes, out) != bytes )
+    {
+      perror("write");
+      return 1;
+    }
+    checksum = checksum * 31 + buffer[0] + buffer[bytes-1]; // keeps the work from being optimized out
+    if( check )
+    {
+      const int lineSize = rosic::AcidLine::serializedSize;
+      for(int k=0; k<n; k++)
+        lineHashes.push_back(hashBytes(&buffer[k*lineSize], lineSize));
+      for(int k=0; k+linesPerSet<=n; k+=linesPerSet)
+        blockHashes.push_back(hashBytes(&buffer[k*lineSize], linesPerSet*lineSize));
+    }
+    done += n;
+  }
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  if( out != NULL && out != stdout )
+    fclose(out);
+  if( bench || outPath != NULL )
+    fprintf(stderr, "%ld lines in %.3f s: %.2f M lines/s (check %08x)\n", count, seconds,
+      seconds > 0.0 ? count / seconds * 1e-6 : 0.0, checksum);
+
+  if( check )
+  {
+    long duplicateLines  = countDuplicates(lineHashes);
+    long duplicateBlocks = countDuplicates(blockHashes);
+    bool ok = duplicateBlocks == 0 && duplicateLines * 1000 <= count;
+    printf("%s %ld lines: %ld duplicate lines, %ld repeated blocks of %d lines\n",
+      ok ? "PASS" : "FAIL", count, duplicateLines, duplicateBlocks, linesPerSet);
+    return ok ? 0 : 1;
+  }
+  return 0;
+}
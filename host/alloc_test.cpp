@@ -0,0 +1,310 @@
+// Test that the audio path never touches the heap.
+//
+//   alloc_test [--blocks N] [--block N]
+//
+// Renders N blocks (default 4000) of N frames (default 32) like the audio task of the sketch and
+// drives the synth through all of its public API from within the blocks, the way the MIDI events
+// reach it on the device: every parameter setter (directly and via all mapped controllers, also
+// with 14 bit values), notes with and without accent and slide, pitch bend, all notes off, the
+// note priority, and the sequencer - its modes, tempo, clock, the pattern editing, song mode and
+// transport. Each block also goes through the panner, the output conversion (with dither), the
+// AudioTelemetry and the LatencyController.
+//
+// malloc, calloc, realloc, free and the aligned allocations (with glibc) and the operators new and
+// delete are replaced by versions which count the calls while a block is rendered. Any count fails the test, with the
+// API call during which it happened. On a device that runs for days, every allocation from the
+// audio path is a chance to fragment the heap or to wait for its lock, so there must be none.
+// Exits with 1 on failure.
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <new>
+
+#include "rosic_host.h"
+
+using namespace rosic;
+
+//-------------------------------------------------------------------------------------------------
+// the trap:
+
+static volatile bool trapArmed    = false;
+static const char   *currentCall  = "";   // the API call that is driven at the moment
+static const char   *failedCall   = NULL; // the first call during which the heap was used
+static size_t        failedSize   = 0;
+static const char   *failedKind   = "";
+static long          numHeapCalls = 0;
+
+static void trap(const char *kind, size_t size)
+{
+  if( !trapArmed )
+    return;
+  if( failedCall == NULL )
+  {
+    failedCall = currentCall;
+    failedKind = kind;
+    failedSize = size;
+  }
+  numHeapCalls++;
+}
+
+#ifdef __GLIBC__
+extern "C"
+{
+  void* __libc_malloc(size_t size);
+  void* __libc_calloc(size_t count, size_t size);
+  void* __libc_realloc(void *pointer, size_t size);
+  void  __libc_free(void *pointer);
+  void* __libc_memalign(size_t alignment, size_t size);
+
+  void* malloc(size_t size)                 { trap("malloc", size); return __libc_malloc(size); }
+  void* calloc(size_t count, size_t size)   { trap("calloc", count*size); return __libc_calloc(count, size); }
+  void* realloc(void *pointer, size_t size) { trap("realloc", size); return __libc_realloc(pointer, size); }
+  void  free(void *pointer)                 { if( pointer != NULL ) trap("free", 0); __libc_free(pointer); }
+
+  // the aligned allocations don't go through malloc:
+  void* memalign(size_t alignment, size_t size)      { trap("memalign", size); return __libc_memalign(alignment, size); }
+  void* aligned_alloc(size_t alignment, size_t size) { trap("aligned_alloc", size); return __libc_memalign(alignment, size); }
+  int   posix_memalign(void **pointer, size_t alignment, size_t size)
+  {
+    trap("posix_memalign", size);
+    *pointer = __libc_memalign(alignment, size);
+    return *pointer != NULL ? 0 : ENOMEM;
+  }
+}
+#define TRAP_NEW(size)                      // new and delete go through malloc and free
+#define TRAP_DELETE(pointer)
+#else
+#define TRAP_NEW(size)       trap("new", size)
+#define TRAP_DELETE(pointer) if( pointer != NULL ) trap("delete", 0)
+#endif
+
+void* operator new(size_t size)
+{
+  TRAP_NEW(size);
+  void *p = malloc(size > 0 ? size : 1);
+  if( p == NULL )
+    throw std::bad_alloc();
+  return p;
+}
+void* operator new[](size_t size)                             { return operator new(size); }
+void* operator new(size_t size, const std::nothrow_t&) throw()   { TRAP_NEW(size); return malloc(size > 0 ? size : 1); }
+void* operator new[](size_t size, const std::nothrow_t&) throw() { TRAP_NEW(size); return malloc(size > 0 ? size : 1); }
+void  operator delete(void *pointer) throw()                  { TRAP_DELETE(pointer); free(pointer); }
+void  operator delete[](void *pointer) throw()                { TRAP_DELETE(pointer); free(pointer); }
+void  operator delete(void *pointer, const std::nothrow_t&) throw()   { TRAP_DELETE(pointer); free(pointer); }
+void  operator delete[](void *pointer, const std::nothrow_t&) throw() { TRAP_DELETE(pointer); free(pointer); }
+void  operator delete(void *pointer, size_t) throw()          { TRAP_DELETE(pointer); free(pointer); }
+void  operator delete[](void *pointer, size_t) throw()        { TRAP_DELETE(pointer); free(pointer); }
+
+//-------------------------------------------------------------------------------------------------
+// the API calls, each driven with the block number b:
+
+static void sequencerNoteOutput(int, int) {}
+
+struct ApiCall
+{
+  const char *name;
+  void (*call)(Open303 &synth, Open303CCMap &ccMap, int b);
+};
+
+// a value that sweeps from 0 to 1 over 16 blocks:
+static float sweep(int b) { return (1.0f/15.0f) * (float) (b % 16); }
+
+static const ApiCall apiCalls[] =
+{
+  // notes (the sequencer mode changes every 256 blocks, see below):
+  { "noteOn",            [](Open303 &s, Open303CCMap&, int b) { s.noteOn(36 + (b*7) % 24, b % 3 ? 127 : 64, 0.0f); } },
+  { "noteOn (slide)",    [](Open303 &s, Open303CCMap&, int b) { s.noteOn(40 + (b*5) % 24, 100, 0.0f); } },
+  { "noteOff",           [](Open303 &s, Open303CCMap&, int b) { s.noteOff(36 + ((b+5)*7) % 24, 0.0f); } },
+  { "allNotesOff",       [](Open303 &s, Open303CCMap&, int b) { if( b % 5 == 0 ) s.allNotesOff(); } },
+  { "setPitchBend",      [](Open303 &s, Open303CCMap&, int b) { s.setPitchBend(4.0f * sweep(b) - 2.0f); } },
+  { "setNotePriority",   [](Open303 &s, Open303CCMap&, int b) { s.setNotePriority((b/64) % NoteStack::NUM_PRIORITY_MODES); } },
+
+  // the parameters:
+  { "setWaveform",          [](Open303 &s, Open303CCMap&, int b) { s.setWaveform(sweep(b)); } },
+  { "setTuning",            [](Open303 &s, Open303CCMap&, int b) { s.setTuning(400.0f + 80.0f * sweep(b)); } },
+  { "setCutoff",            [](Open303 &s, Open303CCMap&, int b) { s.setCutoff(100.0f + 5000.0f * sweep(b)); } },
+  { "setResonance",         [](Open303 &s, Open303CCMap&, int b) { s.setResonance(100.0f * sweep(b)); } },
+  { "setEnvMod",            [](Open303 &s, Open303CCMap&, int b) { s.setEnvMod(100.0f * sweep(b)); } },
+  { "setDecay",             [](Open303 &s, Open303CCMap&, int b) { s.setDecay(200.0f + 1800.0f * sweep(b)); } },
+  { "setAccent",            [](Open303 &s, Open303CCMap&, int b) { s.setAccent(100.0f * sweep(b)); } },
+  { "setVolume",            [](Open303 &s, Open303CCMap&, int b) { s.setVolume(-30.0f * sweep(b)); } },
+  { "setAmpSustain",        [](Open303 &s, Open303CCMap&, int b) { s.setAmpSustain(-60.0f * sweep(b)); } },
+  { "setTanhShaperDrive",   [](Open303 &s, Open303CCMap&, int b) { s.setTanhShaperDrive(60.0f * sweep(b)); } },
+  { "setTanhShaperOffset",  [](Open303 &s, Open303CCMap&, int b) { s.setTanhShaperOffset(20.0f * sweep(b) - 10.0f); } },
+  { "setPreFilterHighpass", [](Open303 &s, Open303CCMap&, int b) { s.setPreFilterHighpass(10.0f + 490.0f * sweep(b)); } },
+  { "setFeedbackHighpass",  [](Open303 &s, Open303CCMap&, int b) { s.setFeedbackHighpass(10.0f + 490.0f * sweep(b)); } },
+  { "setPostFilterHighpass",[](Open303 &s, Open303CCMap&, int b) { s.setPostFilterHighpass(10.0f + 490.0f * sweep(b)); } },
+  { "setSquarePhaseShift",  [](Open303 &s, Open303CCMap&, int b) { s.setSquarePhaseShift(360.0f * sweep(b)); } },
+  { "setSlideTime",         [](Open303 &s, Open303CCMap&, int b) { s.setSlideTime(1.0f + 499.0f * sweep(b)); } },
+  { "setNormalAttack",      [](Open303 &s, Open303CCMap&, int b) { s.setNormalAttack(0.3f + 30.0f * sweep(b)); } },
+  { "setAccentAttack",      [](Open303 &s, Open303CCMap&, int b) { s.setAccentAttack(0.3f + 30.0f * sweep(b)); } },
+  { "setAccentDecay",       [](Open303 &s, Open303CCMap&, int b) { s.setAccentDecay(30.0f + 3000.0f * sweep(b)); } },
+  { "setAmpDecay",          [](Open303 &s, Open303CCMap&, int b) { s.setAmpDecay(16.0f + 3000.0f * sweep(b)); } },
+  { "setAmpRelease",        [](Open303 &s, Open303CCMap&, int b) { s.setAmpRelease(0.5f + 500.0f * sweep(b)); } },
+  { "setSmoothingTime",     [](Open303 &s, Open303CCMap&, int b) { s.setSmoothingTime(1.0f + 50.0f * sweep(b)); } },
+  { "setCutoffTarget",      [](Open303 &s, Open303CCMap&, int b) { s.setCutoffTarget(100.0f + 5000.0f * sweep(b+8)); } },
+  { "setResonanceTarget",   [](Open303 &s, Open303CCMap&, int b) { s.setResonanceTarget(100.0f * sweep(b+8)); } },
+  { "setEnvModTarget",      [](Open303 &s, Open303CCMap&, int b) { s.setEnvModTarget(100.0f * sweep(b+8)); } },
+  { "setPan",               [](Open303 &s, Open303CCMap&, int b) { s.setPan(2.0f * sweep(b) - 1.0f); } },
+  { "setSampleRate",        [](Open303 &s, Open303CCMap&, int b) { if( b % 256 == 0 ) s.setSampleRate(SAMPLE_RATE); } },
+  { "setSequencerNoteOutput", [](Open303 &s, Open303CCMap&, int b) { s.setSequencerNoteOutput(b % 2 ? sequencerNoteOutput : NULL); } },
+
+  // the controllers, 7 bit, 14 bit (MSB and LSB) and by NRPN:
+  { "handleCC", [](Open303 &s, Open303CCMap &m, int b)
+    {
+      for(int i=0; i<m.getNumDescriptors(); i++)
+        m.handleCC(s, m.getDescriptor(i).cc, (b*5 + i*11) & 0x7F);
+    } },
+  { "handleCC (14 bit)", [](Open303 &s, Open303CCMap &m, int b)
+    {
+      for(int i=0; i<m.getNumDescriptors(); i++)
+      {
+        int cc = m.getDescriptor(i).cc;
+        if( cc < 32 )
+        {
+          m.handleCC(s, cc, (b*3) & 0x7F);
+          m.handleCC(s, cc + 32, (b*13) & 0x7F);
+        }
+        else
+        {
+          m.handleCC(s, 99, 0);  // NRPN MSB
+          m.handleCC(s, 98, cc); // NRPN LSB
+          m.handleCC(s, 6,  (b*3) & 0x7F);
+          m.handleCC(s, 38, (b*13) & 0x7F);
+        }
+      }
+      m.handleCC(s, 101, 127); // RPN null
+      m.handleCC(s, 100, 127);
+    } },
+
+  // the sequencer:
+  { "sequencer.setMode",   [](Open303 &s, Open303CCMap&, int b) { if( b % 256 == 0 ) s.sequencer.setMode((b/256) % AcidSequencer::NUM_SEQUENCER_MODES); } },
+  { "sequencer.setTempo",  [](Open303 &s, Open303CCMap&, int b) { s.sequencer.setTempo(60.0f + 200.0f * sweep(b)); } },
+  { "sequencer.setClockRate", [](Open303 &s, Open303CCMap&, int b) { s.sequencer.setClockRate((24.0f * 2.0f / SAMPLE_RATE) * (0.5f + sweep(b))); } },
+  { "sequencer.setStepLength", [](Open303 &s, Open303CCMap&, int b) { s.sequencer.setStepLength(0.25f + 0.75f * sweep(b)); } },
+  { "AcidPattern::setKey",    [](Open303 &s, Open303CCMap&, int b) { s.sequencer.getPattern(b % s.sequencer.getNumPatterns())->setKey(b % 16, (b*7) % 12); } },
+  { "AcidPattern::setOctave", [](Open303 &s, Open303CCMap&, int b) { s.sequencer.getPattern(0)->setOctave(b % 16, (b % 5) - 2); } },
+  { "AcidPattern::setAccent", [](Open303 &s, Open303CCMap&, int b) { s.sequencer.getPattern(0)->setAccent(b % 16, b % 3 == 0); } },
+  { "AcidPattern::setSlide",  [](Open303 &s, Open303CCMap&, int b) { s.sequencer.getPattern(0)->setSlide(b % 16, b % 4 == 0); } },
+  { "AcidPattern::setGate",   [](Open303 &s, Open303CCMap&, int b) { s.sequencer.getPattern(0)->setGate(b % 16, b % 7 != 0); } },
+  { "AcidPattern::setTiming", [](Open303 &s, Open303CCMap&, int b) { s.sequencer.getPattern(0)->setTiming(b % 16, (float) (b % 7) - 3.0f); } },
+  { "AcidPattern::setSwing",  [](Open303 &s, Open303CCMap&, int b) { s.sequencer.getPattern(0)->setSwing(50.0f + 25.0f * sweep(b)); } },
+  { "AcidPattern::randomize", [](Open303 &s, Open303CCMap&, int b) { if( b % 300 == 0 ) s.sequencer.getPattern(1)->randomize(); } },
+  { "sequencer.circularShift", [](Open303 &s, Open303CCMap&, int b) { if( b % 32 == 0 ) s.sequencer.circularShift(b % 64 ? 1 : -3); } },
+  { "sequencer.setKeyPermissible", [](Open303 &s, Open303CCMap&, int b) { s.sequencer.setKeyPermissible(b % 12, b % 24 < 12); } },
+  { "sequencer.toggleKeyPermissibility", [](Open303 &s, Open303CCMap&, int b) { if( b % 100 == 0 ) s.sequencer.toggleKeyPermissibility(b % 12); } },
+  { "sequencer song",      [](Open303 &s, Open303CCMap&, int b)
+    {
+      if( b % 128 == 0 )
+      {
+        s.sequencer.clearSong();
+        s.sequencer.appendToSong(0, 2, 0);
+        s.sequencer.appendToSong(1, 1, 5);
+      }
+      s.sequencer.setSongMode(b % 512 >= 256);
+    } },
+  { "sequencer transport", [](Open303 &s, Open303CCMap&, int b)
+    {
+      switch( b % 97 )
+      {
+      case 0:  s.sequencer.stop();             break;
+      case 1:  s.sequencer.start();            break;
+      case 50: s.sequencer.locate(b % 16);     break;
+      case 60: s.sequencer.continuePlayback(); break;
+      }
+    } },
+};
+
+static const int numApiCalls = sizeof(apiCalls) / sizeof(apiCalls[0]);
+
+//-------------------------------------------------------------------------------------------------
+
+static void usage()
+{
+  fprintf(stderr, "usage: alloc_test [--blocks N] [--block N]\n");
+}
+
+int main(int argc, char **argv)
+{
+  int numBlocks = 4000;
+  int blockSize = 32;
+  for(int i=1; i<argc; i++)
+  {
+    bool hasValue = i+1 < argc;
+    if(      !strcmp(argv[i], "--blocks") && hasValue ) numBlocks = atoi(argv[++i]);
+    else if( !strcmp(argv[i], "--block")  && hasValue ) blockSize = atoi(argv[++i]);
+    else { usage(); return 1; }
+  }
+  if( numBlocks < 1 || blockSize < 1 || blockSize > LatencyController::maxBlockSize )
+  {
+    usage();
+    return 1;
+  }
+
+  // the trap must see the allocations, or the test would pass for nothing:
+  trapArmed = true;
+  currentCall = "self test";
+  void * volatile p = malloc(16);
+  free(p);
+  int * volatile q = new int;
+  delete q;
+  trapArmed = false;
+  if( numHeapCalls < 2 )
+  {
+    printf("FAIL the allocation trap does not work on this platform\n");
+    return 1;
+  }
+  numHeapCalls = 0;
+  failedCall   = NULL;
+
+  // everything is set up before the audio starts, like in the sketch:
+  Open303         *synth = newAlignedSynth();
+  Open303CCMap    *ccMap = new Open303CCMap;
+  OutputConverter  converter;
+  AudioTelemetry   telemetry;
+  LatencyController latency;
+  converter.setNumBits(16);
+  converter.setDitherMode(OutputConverter::TPDF);
+  float   left[LatencyController::maxBlockSize], right[LatencyController::maxBlockSize];
+  int16_t converted[2*LatencyController::maxBlockSize];
+  double  checksum = 0.0;
+
+  for(int b=0; b<numBlocks; b++)
+  {
+    trapArmed = true;
+    uint32_t start = StageProfiler::readTicks();
+    for(int c=0; c<numApiCalls; c++)
+    {
+      currentCall = apiCalls[c].name;
+      apiCalls[c].call(*synth, *ccMap, b);
+    }
+    currentCall = "Open303::getSample";
+    for(int n=0; n<blockSize; n++)
+      left[n] = synth->getSample();
+    currentCall = "StereoPanner::process";
+    synth->panner.process(left, left, right, blockSize);
+    currentCall = "OutputConverter::process";
+    converter.process(left, right, converted, blockSize);
+    currentCall = "AudioTelemetry/LatencyController";
+    uint32_t ticks = StageProfiler::readTicks() - start;
+    telemetry.blockRendered(ticks, 2*ticks);
+    latency.update(1e-4f, 1e-3f);
+    trapArmed = false;
+    checksum += (double) left[0];
+  }
+
+  delete ccMap;
+  deleteAlignedSynth(synth);
+  if( numHeapCalls > 0 )
+  {
+    printf("FAIL %ld heap calls while rendering, the first: %s of %lu bytes in %s\n",
+      numHeapCalls, failedKind, (unsigned long) failedSize, failedCall);
+    return 1;
+  }
+  printf("PASS no heap calls in %d blocks of %d frames with %d API calls each (check %g)\n",
+    numBlocks, blockSize, numApiCalls, checksum);
+  return 0;
+}
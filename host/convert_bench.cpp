@@ -0,0 +1,124 @@
+// Benchmark for the float to I2S sample conversion (rosic::OutputConverter) on the host.
+//
+//   convert_bench [--block N] [--blocks N]
+//
+// Converts blocks of N stereo frames (default 32, like DMA_BUF_LEN) for every output format and
+// dither mode, with the optimized code for this machine (SSE2 on x86) and with the portable scalar
+// code, and reports the time per frame in ns and in CPU cycles (counted by a CycleCounter, like
+// in dsp_bench - in ticks of the time stamp counter where the cycles aren't accessible). Before
+// that, it checks that both agree without dither (within 1 LSB, as SSE2 rounds halfway cases to
+// even).
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+
+#include "rosic_host.h"
+
+static void usage()
+{
+  fprintf(stderr, "usage: convert_bench [--block N] [--blocks N]\n");
+}
+
+static long long getSample(const std::vector<int32_t> &buffer, int bits, int i)
+{
+  if( bits == 16 )
+    return ((const int16_t*) buffer.data())[i];
+  return buffer[i];
+}
+
+int main(int argc, char **argv)
+{
+  int  blockSize = 32;
+  long numBlocks = 200000;
+
+  for(int i=1; i<argc; i++)
+  {
+    bool hasValue = i+1 < argc;
+    if(      !strcmp(argv[i], "--block")  && hasValue ) blockSize = atoi(argv[++i]);
+    else if( !strcmp(argv[i], "--blocks") && hasValue ) numBlocks = strtol(argv[++i], NULL, 0);
+    else { usage(); return 1; }
+  }
+  if( blockSize < 1 || numBlocks < 1 )
+  {
+    usage();
+    return 1;
+  }
+
+  // a test signal which goes beyond full scale now and then, so the saturation is exercised:
+  std::vector<float> left(blockSize), right(blockSize);
+  srand(1);
+  for(int n=0; n<blockSize; n++)
+  {
+    left[n]  = 2.4f * rand() / (float) RAND_MAX - 1.2f;
+    right[n] = -0.7f * left[n];
+  }
+  std::vector<int32_t> optimized(2*blockSize), scalar(2*blockSize);
+
+  static const int   formats[]    = { 16, 24, 32 };
+  static const char *ditherNames[] = { "none", "tpdf", "shaped" };
+
+  rosic::OutputConverter converter;
+  int mismatches = 0;
+  for(int bits : formats)
+  {
+    converter.setNumBits(bits);
+    converter.process(left.data(), right.data(), optimized.data(), blockSize);
+    converter.processScalar(left.data(), right.data(), scalar.data(), blockSize);
+    long long tolerance = bits == 24 ? 256 : 1; // 24 bit samples are shifted up by 8 bits
+    for(int i=0; i<2*blockSize; i++)
+    {
+      long long d = getSample(optimized, bits, i) - getSample(scalar, bits, i);
+      if( d > tolerance || d < -tolerance )
+        mismatches++;
+    }
+  }
+  if( mismatches > 0 )
+  {
+    fprintf(stderr, "optimized and scalar conversion differ in %d samples\n", mismatches);
+    return 1;
+  }
+
+  CycleCounter cycleCounter;
+  char cyclesHeader[32];
+  snprintf(cyclesHeader, sizeof(cyclesHeader), "%s/frame", cycleCounter.getUnit());
+  printf("%-6s %-8s %12s %12s %16s %16s\n", "bits", "dither", "ns/frame", "scalar", cyclesHeader,
+    "scalar");
+  for(int bits : formats)
+  {
+    for(int mode=0; mode<rosic::OutputConverter::NUM_DITHER_MODES; mode++)
+    {
+      if( bits == 32 && mode != rosic::OutputConverter::NO_DITHER )
+        continue; // no dither for 32 bits
+      converter.setNumBits(bits);
+      converter.setDitherMode(mode);
+
+      double nsPerFrame[2], cyclesPerFrame[2];
+      unsigned checksum = 0;
+      for(int impl=0; impl<2; impl++)
+      {
+        converter.reset();
+        auto     start       = std::chrono::steady_clock::now();
+        uint64_t startCycles = cycleCounter.read();
+        for(long b=0; b<numBlocks; b++)
+        {
+          if( impl == 0 )
+            converter.process(left.data(), right.data(), optimized.data(), blockSize);
+          else
+            converter.processScalar(left.data(), right.data(), optimized.data(), blockSize);
+          checksum = checksum * 31 + optimized[0]; // keeps the work from being optimized out
+        }
+        uint64_t endCycles = cycleCounter.read();
+        double   seconds   = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        double   numFrames = (double) numBlocks * blockSize;
+        nsPerFrame[impl]     = seconds * 1e9 / numFrames;
+        cyclesPerFrame[impl] = (double) (endCycles - startCycles) / numFrames;
+      }
+      printf("%-6d %-8s %12.3f %12.3f %16.2f %16.2f (check %08x)\n", bits, ditherNames[mode],
+        nsPerFrame[0], nsPerFrame[1], cyclesPerFrame[0], cyclesPerFrame[1], checksum);
+    }
+  }
+  return 0;
+}
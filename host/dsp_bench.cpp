@@ -0,0 +1,358 @@
+// Microbenchmarks for the DSP modules of the synth on the host.
+//
+//   dsp_bench [--blocks 1,16,32,64,256] [--samples N] [--repeat N] [--filter TEXT]
+//             [--format text|csv|json] [--list]
+//
+// Runs every module (the oscillator and its wavetables, each mode of the TeeBeeFilter, the other
+// filters and envelopes, the coefficient updates and the complete Open303::getSample) over N
+// samples (default 2^18, about 6 seconds of audio) in blocks of each of the given sizes, and
+// reports the time per sample in ns and in CPU cycles (counted by a CycleCounter - where the
+// system doesn't give access to the cycle counter, the column is in ticks of the time stamp
+// counter instead, and says so). Each measurement is repeated (default 5 times, after one run to
+// warm up) and the median is reported, plus the minimum of the ns.
+//
+// The block size shows the overhead per call - a block is one call of the benchmark function,
+// like the audio task calls the synth once per DMA buffer. With --filter, only the modules whose
+// names contain the text are run. --format csv or json gives machine readable results (json with
+// the compiler and the sample rate) to compare between releases, e.g.
+//   dsp_bench --format json > bench-1.2.json
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rosic_host.h"
+
+using namespace rosic;
+
+static void usage()
+{
+  fprintf(stderr,
+    "usage: dsp_bench [--blocks 1,16,32,64,256] [--samples N] [--repeat N] [--filter TEXT]\n"
+    "                 [--format text|csv|json] [--list]\n");
+}
+
+/** A module under test: process computes numSamples output samples from the input (some
+modules ignore it) and start puts the module into the state in which each measurement begins,
+e.g. retriggers an envelope, such that it doesn't decay into denormals over the runs. */
+struct Benchmark
+{
+  std::string name;
+  std::function<void(const float *in, float *out, int numSamples)> process;
+  std::function<void()> start;
+};
+
+struct Result
+{
+  std::string name;
+  int    blockSize;
+  double nsPerSample;     // median of the runs
+  double nsPerSampleMin;  // best run
+  double cyclesPerSample; // median of the runs (in the unit of the CycleCounter)
+};
+
+// the names of the TeeBeeFilter modes, in the order of TeeBeeFilter::modes:
+static const char *teeBeeModeNames[] =
+{
+  "FLAT", "LP_6", "LP_12", "LP_18", "LP_24", "HP_6", "HP_12", "HP_18", "HP_24", "BP_12_12",
+  "BP_6_18", "BP_18_6", "BP_6_12", "BP_12_6", "BP_6_6", "TB_303"
+};
+static_assert(sizeof(teeBeeModeNames) / sizeof(teeBeeModeNames[0]) == TeeBeeFilter::NUM_MODES,
+  "a name is missing for a TeeBeeFilter mode");
+
+/** The modules under test - big ones (wavetables, the synth) are allocated, so this can live on
+the stack of main. */
+struct Modules
+{
+  Modules()
+    : waveTable(new MipMappedWaveTable), waveTable2(new MipMappedWaveTable), synth(newAlignedSynth())
+  {}
+
+  std::unique_ptr<MipMappedWaveTable> waveTable, waveTable2;
+  BlendOscillator           oscillator;
+  TeeBeeFilter              teeBee[TeeBeeFilter::NUM_MODES];
+  TeeBeeFilter              teeBeeCoefficients;
+  BiquadFilter              biquad, biquadCoefficients;
+  OnePoleFilter             onePole;
+  EllipticQuarterBandFilter elliptic;
+  AnalogEnvelope            analogEnvelope;
+  DecayEnvelope             decayEnvelope;
+  LeakyIntegrator           leakyIntegrator;
+  AlignedSynthPointer       synth;
+  float                     phase;    // of the wavetable readout and the cutoff sweeps
+};
+
+static std::vector<Benchmark> makeBenchmarks(Modules &m)
+{
+  std::vector<Benchmark> b;
+  auto nothing = []() {};
+
+  // oscillator and wavetables, set up like in the Open303 (saw and square, 110 Hz):
+  m.waveTable->setWaveform(MipMappedWaveTable::SAW303);
+  m.waveTable2->setWaveform(MipMappedWaveTable::SQUARE303);
+  m.oscillator.setWaveTable1(m.waveTable.get());
+  m.oscillator.setWaveTable2(m.waveTable2.get());
+  m.oscillator.setBlendFactor(0.5f);
+  m.oscillator.setFrequency(110.0f);
+  m.oscillator.calculateIncrement();
+  b.push_back({ "BlendOscillator::getSample",
+    [&m](const float*, float *out, int n)
+    { for(int i=0; i<n; i++) out[i] = m.oscillator.getSample(); },
+    nothing });
+
+  b.push_back({ "MipMappedWaveTable::getValueLinear",
+    [&m](const float*, float *out, int n)
+    {
+      const float length = 512.0f; // MipMappedWaveTable::tableLength
+      for(int i=0; i<n; i++)
+      {
+        out[i]   = m.waveTable->getValueLinear(m.phase, 4);
+        m.phase += 2.56f;
+        if( m.phase >= length )
+          m.phase -= length;
+      }
+    },
+    [&m]() { m.phase = 0.0f; } });
+
+  // the TeeBeeFilter in each mode, at a cutoff and resonance in the usual range:
+  for(int mode=0; mode<TeeBeeFilter::NUM_MODES; mode++)
+  {
+    TeeBeeFilter &f = m.teeBee[mode];
+    f.setMode(mode);
+    f.setCutoff(1200.0f);
+    f.setResonance(60.0f);
+    b.push_back({ std::string("TeeBeeFilter::getSample ") + teeBeeModeNames[mode],
+      [&f](const float *in, float *out, int n)
+      { for(int i=0; i<n; i++) out[i] = f.getSample(in[i]); },
+      [&f]() { f.reset(); } });
+  }
+
+  m.biquad.setMode(BiquadFilter::LOWPASS12);
+  m.biquad.setFrequency(200.0f);
+  b.push_back({ "BiquadFilter::getSample",
+    [&m](const float *in, float *out, int n)
+    { for(int i=0; i<n; i++) out[i] = m.biquad.getSample(in[i]); },
+    [&m]() { m.biquad.reset(); } });
+
+  m.onePole.setMode(OnePoleFilter::HIGHPASS);
+  m.onePole.setCutoff(44.486f);
+  b.push_back({ "OnePoleFilter::getSample",
+    [&m](const float *in, float *out, int n)
+    { for(int i=0; i<n; i++) out[i] = m.onePole.getSample(in[i]); },
+    [&m]() { m.onePole.reset(); } });
+
+  // (the synth doesn't use this one - it was the anti-aliasing filter of the 4x oversampled
+  // original - and its 12th order direct form runs away in single precision after a few thousand
+  // samples, so it is restarted when that happens):
+  b.push_back({ "EllipticQuarterBandFilter::getSample",
+    [&m](const float *in, float *out, int n)
+    {
+      for(int i=0; i<n; i++)
+        out[i] = m.elliptic.getSample(in[i]);
+      if( !(fabsf(out[n-1]) < 1.e6f) )
+        m.elliptic.reset();
+    },
+    [&m]() { m.elliptic.reset(); } });
+
+  // the envelopes are retriggered for each run, such that they are in their active phase:
+  m.analogEnvelope.setAttack(3.0f);
+  m.analogEnvelope.setDecay(1230.0f);
+  b.push_back({ "AnalogEnvelope::getSample",
+    [&m](const float*, float *out, int n)
+    { for(int i=0; i<n; i++) out[i] = m.analogEnvelope.getSample(); },
+    [&m]() { m.analogEnvelope.noteOn(); } });
+
+  m.decayEnvelope.setDecayTimeConstant(1000.0f);
+  b.push_back({ "DecayEnvelope::getSample",
+    [&m](const float*, float *out, int n)
+    { for(int i=0; i<n; i++) out[i] = m.decayEnvelope.getSample(); },
+    [&m]() { m.decayEnvelope.trigger(); } });
+
+  m.leakyIntegrator.setTimeConstant(15.0f);
+  b.push_back({ "LeakyIntegrator::getSample",
+    [&m](const float *in, float *out, int n)
+    { for(int i=0; i<n; i++) out[i] = m.leakyIntegrator.getSample(in[i]); },
+    [&m]() { m.leakyIntegrator.reset(); } });
+
+  // coefficient updates with a new cutoff on every sample (the TeeBeeFilter gets one per sample
+  // from the filter envelope in Open303::getSample), the cutoff sweeps from 200 to 4200 Hz:
+  m.teeBeeCoefficients.setMode(TeeBeeFilter::TB_303);
+  m.teeBeeCoefficients.setResonance(60.0f);
+  b.push_back({ "TeeBeeFilter::calculateCoefficientsApprox4",
+    [&m](const float*, float *out, int n)
+    {
+      for(int i=0; i<n; i++)
+      {
+        m.teeBeeCoefficients.setCutoff(200.0f + m.phase);
+        out[i]   = m.teeBeeCoefficients.getCutoff();
+        m.phase += 7.3f;
+        if( m.phase >= 4000.0f )
+          m.phase -= 4000.0f;
+      }
+    },
+    [&m]() { m.phase = 0.0f; } });
+
+  m.biquadCoefficients.setMode(BiquadFilter::LOWPASS12);
+  b.push_back({ "BiquadFilter::calcCoeffs",
+    [&m](const float*, float *out, int n)
+    {
+      for(int i=0; i<n; i++)
+      {
+        m.biquadCoefficients.setFrequency(200.0f + m.phase);
+        out[i]   = m.biquadCoefficients.getFrequency();
+        m.phase += 7.3f;
+        if( m.phase >= 4000.0f )
+          m.phase -= 4000.0f;
+      }
+    },
+    [&m]() { m.phase = 0.0f; } });
+
+  // the whole synth, playing a sequencer pattern:
+  EventStorm::setBenchPattern(m.synth->sequencer.getPattern(0));
+  m.synth->sequencer.setMode(AcidSequencer::KEY_SYNC);
+  m.synth->setResonance(70.0f);
+  m.synth->noteOn(36, 100, 0.0f);
+  b.push_back({ "Open303::getSample",
+    [&m](const float*, float *out, int n)
+    { for(int i=0; i<n; i++) out[i] = m.synth->getSample(); },
+    nothing });
+
+  return b;
+}
+
+static std::vector<int> parseBlockSizes(const char *text)
+{
+  std::vector<int> sizes;
+  while( *text != '\0' )
+  {
+    char *end;
+    long size = strtol(text, &end, 10);
+    if( end == text || size < 1 || size > 65536 )
+      return std::vector<int>();
+    sizes.push_back((int) size);
+    text = *end == ',' ? end+1 : end;
+  }
+  return sizes;
+}
+
+static double median(std::vector<double> values)
+{
+  std::sort(values.begin(), values.end());
+  size_t n = values.size();
+  return n % 2 ? values[n/2] : 0.5 * (values[n/2-1] + values[n/2]);
+}
+
+int main(int argc, char **argv)
+{
+  std::vector<int> blockSizes = { 1, 16, 32, 64, 256 };
+  long        numSamples = 1L << 18;
+  int         numRepeats = 5;
+  const char *filter     = "";
+  const char *format     = "text";
+  bool        list       = false;
+
+  for(int i=1; i<argc; i++)
+  {
+    bool hasValue = i+1 < argc;
+    if(      !strcmp(argv[i], "--blocks")  && hasValue ) blockSizes = parseBlockSizes(argv[++i]);
+    else if( !strcmp(argv[i], "--samples") && hasValue ) numSamples = strtol(argv[++i], NULL, 0);
+    else if( !strcmp(argv[i], "--repeat")  && hasValue ) numRepeats = atoi(argv[++i]);
+    else if( !strcmp(argv[i], "--filter")  && hasValue ) filter     = argv[++i];
+    else if( !strcmp(argv[i], "--format")  && hasValue ) format     = argv[++i];
+    else if( !strcmp(argv[i], "--list") )                list       = true;
+    else { usage(); return 1; }
+  }
+  if( blockSizes.empty() || numSamples < 1 || numRepeats < 1 || (strcmp(format, "text")
+    && strcmp(format, "csv") && strcmp(format, "json")) )
+  {
+    usage();
+    return 1;
+  }
+
+  Modules modules;
+  std::vector<Benchmark> benchmarks = makeBenchmarks(modules);
+  if( list )
+  {
+    for(const Benchmark &b : benchmarks)
+      printf("%s\n", b.name.c_str());
+    return 0;
+  }
+
+  // the input is a noisy saw in -1...+1, long enough for the largest block:
+  int maxBlockSize = *std::max_element(blockSizes.begin(), blockSizes.end());
+  std::vector<float> input(maxBlockSize), output(maxBlockSize);
+  srand(1);
+  for(int n=0; n<maxBlockSize; n++)
+    input[n] = (float) (n % 100) / 50.0f - 1.0f + 0.1f * rand() / (float) RAND_MAX;
+
+  std::vector<Result> results;
+  CycleCounter cycleCounter;
+  float checksum = 0.0f;
+  for(const Benchmark &b : benchmarks)
+  {
+    if( b.name.find(filter) == std::string::npos )
+      continue;
+    for(int blockSize : blockSizes)
+    {
+      long numBlocks = std::max(numSamples / blockSize, 1L);
+      std::vector<double> ns, cycles;
+      for(int r=0; r<=numRepeats; r++) // the first run warms up the caches and is not counted
+      {
+        b.start();
+        auto     start      = std::chrono::steady_clock::now();
+        uint64_t startCycles = cycleCounter.read();
+        for(long k=0; k<numBlocks; k++)
+          b.process(input.data(), output.data(), blockSize);
+        uint64_t endCycles   = cycleCounter.read();
+        double   seconds    = std::chrono::duration<double>(
+          std::chrono::steady_clock::now() - start).count();
+        checksum += output[0]; // keeps the work from being optimized out
+        if( r > 0 )
+        {
+          double count = (double) numBlocks * blockSize;
+          ns.push_back(seconds * 1e9 / count);
+          cycles.push_back((double) (endCycles - startCycles) / count);
+        }
+      }
+      Result result = { b.name, blockSize, median(ns), *std::min_element(ns.begin(), ns.end()),
+        median(cycles) };
+      results.push_back(result);
+      if( !strcmp(format, "text") )
+        printf("%-50s %6d %10.2f ns %10.2f ns min %10.1f %s\n", result.name.c_str(),
+          blockSize, result.nsPerSample, result.nsPerSampleMin, result.cyclesPerSample,
+          cycleCounter.getUnit());
+    }
+  }
+
+  if( !strcmp(format, "csv") )
+  {
+    printf("module,block,ns_per_sample,ns_per_sample_min,%s_per_sample\n",
+      cycleCounter.getColumn());
+    for(const Result &r : results)
+      printf("\"%s\",%d,%.3f,%.3f,%.2f\n", r.name.c_str(), r.blockSize, r.nsPerSample,
+        r.nsPerSampleMin, r.cyclesPerSample);
+  }
+  else if( !strcmp(format, "json") )
+  {
+    printf("{\n  \"sample_rate\": %d,\n  \"compiler\": \"%s\",\n  \"samples\": %ld,\n"
+      "  \"repeat\": %d,\n  \"results\": [\n", SAMPLE_RATE, __VERSION__, numSamples, numRepeats);
+    for(size_t i=0; i<results.size(); i++)
+    {
+      const Result &r = results[i];
+      printf("    { \"module\": \"%s\", \"block\": %d, \"ns_per_sample\": %.3f, "
+        "\"ns_per_sample_min\": %.3f, \"%s_per_sample\": %.2f }%s\n", r.name.c_str(),
+        r.blockSize, r.nsPerSample, r.nsPerSampleMin, cycleCounter.getColumn(), r.cyclesPerSample,
+        i+1 < results.size() ? "," : "");
+    }
+    printf("  ]\n}\n");
+  }
+  fprintf(stderr, "(check %g)\n", (double) checksum);
+  return 0;
+}
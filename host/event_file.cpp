@@ -0,0 +1,241 @@
+// Event files of open303-render and golden_test - see event_file.h.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <algorithm>
+
+#include "event_file.h"
+
+using namespace rosic;
+
+//-------------------------------------------------------------------------------------------------
+// parameters:
+
+// the parameters of the synth by the names of their setters:
+const Parameter parameters[] =
+{
+  { "waveform",           &Open303::setWaveform,           &Open303::getWaveform },
+  { "tuning",             &Open303::setTuning,             &Open303::getTuning },
+  { "cutoff",             &Open303::setCutoff,             &Open303::getCutoff },
+  { "resonance",          &Open303::setResonance,          &Open303::getResonance },
+  { "envMod",             &Open303::setEnvMod,             &Open303::getEnvMod },
+  { "decay",              &Open303::setDecay,              &Open303::getDecay },
+  { "accent",             &Open303::setAccent,             &Open303::getAccent },
+  { "volume",             &Open303::setVolume,             &Open303::getVolume },
+  { "ampSustain",         &Open303::setAmpSustain,         &Open303::getAmpSustain },
+  { "tanhShaperDrive",    &Open303::setTanhShaperDrive,    &Open303::getTanhShaperDrive },
+  { "tanhShaperOffset",   &Open303::setTanhShaperOffset,   &Open303::getTanhShaperOffset },
+  { "preFilterHighpass",  &Open303::setPreFilterHighpass,  &Open303::getPreFilterHighpass },
+  { "feedbackHighpass",   &Open303::setFeedbackHighpass,   &Open303::getFeedbackHighpass },
+  { "postFilterHighpass", &Open303::setPostFilterHighpass, &Open303::getPostFilterHighpass },
+  { "squarePhaseShift",   &Open303::setSquarePhaseShift,   &Open303::getSquarePhaseShift },
+  { "slideTime",          &Open303::setSlideTime,          &Open303::getSlideTime },
+  { "normalAttack",       &Open303::setNormalAttack,       &Open303::getNormalAttack },
+  { "accentAttack",       &Open303::setAccentAttack,       &Open303::getAccentAttack },
+  { "accentDecay",        &Open303::setAccentDecay,        &Open303::getAccentDecay },
+  { "ampDecay",           &Open303::setAmpDecay,           &Open303::getAmpDecay },
+  { "ampRelease",         &Open303::setAmpRelease,         &Open303::getAmpRelease },
+  { "smoothingTime",      &Open303::setSmoothingTime,      &Open303::getSmoothingTime },
+  { "pan",                &Open303::setPan,                &Open303::getPan },
+};
+const int numParameters = sizeof(parameters) / sizeof(parameters[0]);
+
+const Parameter* findParameter(const char *name)
+{
+  for(int i=0; i<numParameters; i++)
+  {
+    if( !strcasecmp(parameters[i].name, name) )
+      return &parameters[i];
+  }
+  return NULL;
+}
+
+bool setParameter(Open303 &synth, const char *text)
+{
+  char name[64];
+  int  length = (int) strcspn(text, "= \t");
+  if( length == 0 || length >= (int) sizeof(name) || text[length] == '\0' )
+    return false;
+  memcpy(name, text, length);
+  name[length] = '\0';
+  const Parameter *p = findParameter(name);
+  char *end;
+  float value = strtof(text + length + 1, &end);
+  if( p == NULL || end == text + length + 1 )
+    return false;
+  (synth.*p->setter)(value);
+  return true;
+}
+
+bool readParameters(Open303 &synth, const char *path)
+{
+  FILE *f = fopen(path, "r");
+  if( f == NULL )
+  {
+    perror(path);
+    return false;
+  }
+  char line[256];
+  int  lineNumber = 0;
+  bool ok = true;
+  while( fgets(line, sizeof(line), f) != NULL )
+  {
+    lineNumber++;
+    line[strcspn(line, "#\r\n")] = '\0';
+    char *text = line + strspn(line, " \t");
+    if( *text != '\0' && !setParameter(synth, text) )
+    {
+      fprintf(stderr, "%s:%d: unknown parameter or missing value\n", path, lineNumber);
+      ok = false;
+    }
+  }
+  fclose(f);
+  return ok;
+}
+
+//-------------------------------------------------------------------------------------------------
+// events:
+
+bool readEvents(Open303 &synth, const char *path, std::vector<Event> &events)
+{
+  FILE *f = fopen(path, "r");
+  if( f == NULL )
+  {
+    perror(path);
+    return false;
+  }
+  char line[256];
+  int  lineNumber = 0;
+  bool ok = true;
+  while( fgets(line, sizeof(line), f) != NULL )
+  {
+    lineNumber++;
+    line[strcspn(line, "#\r\n")] = '\0';
+    char word[64], flags[8];
+    int  a, b, c, n;
+    float x;
+    if( sscanf(line, " %63s", word) != 1 )
+      continue; // empty line
+
+    if( !strcmp(word, "sequencer") && sscanf(line, " %*s %63s", word) == 1 )
+    {
+      if(      !strcmp(word, "off") )     synth.sequencer.setMode(AcidSequencer::OFF);
+      else if( !strcmp(word, "keysync") ) synth.sequencer.setMode(AcidSequencer::KEY_SYNC);
+      else { fprintf(stderr, "%s:%d: unknown sequencer mode\n", path, lineNumber); ok = false; }
+      continue;
+    }
+    if( !strcmp(word, "step") )
+    {
+      AcidPattern *pattern = synth.sequencer.getPattern(0);
+      if( sscanf(line, " %*s %d %d %d %7s", &a, &b, &c, flags) != 4 || a < 0
+        || a >= pattern->getNumSteps() || strspn(flags, "gas-") != strlen(flags) )
+      {
+        fprintf(stderr, "%s:%d: expected step <step> <key> <octave> <flags>\n", path, lineNumber);
+        ok = false;
+        continue;
+      }
+      pattern->setKey(   a, b);
+      pattern->setOctave(a, c);
+      pattern->setGate(  a, strchr(flags, 'g') != NULL);
+      pattern->setAccent(a, strchr(flags, 'a') != NULL);
+      pattern->setSlide( a, strchr(flags, 's') != NULL);
+      continue;
+    }
+
+    // timed events:
+    Event e;
+    memset(&e, 0, sizeof(e));
+    if( sscanf(line, " %f %63s %n", &x, word, &n) != 2 || x < 0.0f )
+    {
+      fprintf(stderr, "%s:%d: expected <seconds> <event>\n", path, lineNumber);
+      ok = false;
+      continue;
+    }
+    e.frame = (long) (x * SAMPLE_RATE + 0.5f);
+    const char *args = line + n;
+    bool valid;
+    if( !strcmp(word, "on") )
+    {
+      e.type = Event::NOTE_ON;
+      valid  = sscanf(args, "%d %d", &e.number, &e.value) == 2;
+    }
+    else if( !strcmp(word, "off") )
+    {
+      e.type = Event::NOTE_ON;
+      valid  = sscanf(args, "%d", &e.number) == 1;
+    }
+    else if( !strcmp(word, "cc") )
+    {
+      e.type = Event::CONTROLLER;
+      valid  = sscanf(args, "%d %d", &e.number, &e.value) == 2;
+    }
+    else if( !strcmp(word, "bend") )
+    {
+      e.type = Event::PITCH_BEND;
+      valid  = sscanf(args, "%f", &e.amount) == 1;
+    }
+    else if( !strcmp(word, "set") )
+    {
+      e.type      = Event::PARAMETER;
+      valid       = sscanf(args, "%63s %f", word, &e.amount) == 2;
+      e.parameter = findParameter(word);
+      valid       = valid && e.parameter != NULL;
+    }
+    else if( !strcmp(word, "tempo") )
+    {
+      e.type = Event::TEMPO;
+      valid  = sscanf(args, "%f", &e.amount) == 1 && e.amount > 0.0f;
+    }
+    else if( !strcmp(word, "end") )
+    {
+      e.type = Event::END;
+      valid  = true;
+    }
+    else
+      valid = false;
+
+    if( valid )
+      events.push_back(e);
+    else
+    {
+      fprintf(stderr, "%s:%d: unknown event or wrong arguments\n", path, lineNumber);
+      ok = false;
+    }
+  }
+  fclose(f);
+
+  // events at the same time stay in the order of the file:
+  std::stable_sort(events.begin(), events.end(),
+    [](const Event &x, const Event &y) { return x.frame < y.frame; });
+  return ok;
+}
+
+void applyEvent(Open303 &synth, Open303CCMap &ccMap, const Event &e)
+{
+  switch( e.type )
+  {
+  case Event::NOTE_ON:    synth.noteOn(e.number, e.value, 0.0f);       break;
+  case Event::CONTROLLER: ccMap.handleCC(synth, e.number, e.value);    break;
+  case Event::PITCH_BEND: synth.setPitchBend(e.amount);                break;
+  case Event::PARAMETER:  (synth.*e.parameter->setter)(e.amount);      break;
+  case Event::TEMPO:      synth.sequencer.setTempo(e.amount);          break;
+  }
+}
+
+long trimAtEnd(std::vector<Event> &events, float tail)
+{
+  if( events.empty() )
+    return 0;
+  for(size_t e=0; e<events.size(); e++)
+  {
+    if( events[e].type == Event::END )
+    {
+      long numFrames = events[e].frame;
+      events.resize(e);
+      return numFrames;
+    }
+  }
+  return events.back().frame + (long) (tail * SAMPLE_RATE + 0.5f);
+}
@@ -0,0 +1,78 @@
+// Event files - the input of open303-render and of the cases of golden_test.
+//
+// An event file has one event per line, # starts a comment:
+//
+//   <seconds> on <key> <velocity>       note on (velocity 0 is a note off)
+//   <seconds> off <key>                 note off
+//   <seconds> cc <controller> <value>   controller, mapped like MIDI input (rosic_Open303CCMap.ino)
+//   <seconds> bend <semitones>          pitch bend
+//   <seconds> set <name> <value>        parameter, see parameters below
+//   <seconds> tempo <bpm>               tempo of the sequencer
+//   <seconds> end                       end of the rendering
+//   sequencer off|keysync               sequencer mode, with keysync a note on plays the pattern
+//   step <step> <key> <octave> <flags>  a step of the sequencer pattern, flags: g (gate),
+//                                       a (accent), s (slide) or - for none
+
+#ifndef event_file_h
+#define event_file_h
+
+#include <vector>
+
+#include "rosic_host.h"
+
+/** A parameter of the synth, by the name of its setter (in the units of the setter). */
+struct Parameter
+{
+  const char *name;
+  void  (rosic::Open303::*setter)(float);
+  float (rosic::Open303::*getter)() const;
+};
+
+extern const Parameter parameters[];
+extern const int       numParameters;
+
+/** Returns the parameter with the given name (case insensitive) or NULL. */
+const Parameter* findParameter(const char *name);
+
+/** Parses "NAME=VALUE" (from the command line) or "NAME VALUE" (from a parameter file) and sets
+the parameter. Returns false, if the name is unknown or the value is missing. */
+bool setParameter(rosic::Open303 &synth, const char *text);
+
+/** Sets the parameters from a file with one "NAME VALUE" per line. Reports errors on stderr and
+returns false on any. */
+bool readParameters(rosic::Open303 &synth, const char *path);
+
+/** A timed event of an event file. */
+struct Event
+{
+  enum types
+  {
+    NOTE_ON = 0,
+    CONTROLLER,
+    PITCH_BEND,
+    PARAMETER,
+    TEMPO,
+    END
+  };
+
+  long  frame;   // the sample at which the event is applied
+  int   type;
+  int   number;  // key or controller number
+  int   value;   // velocity or controller value
+  float amount;  // bend in semitones, parameter value or tempo
+  const Parameter *parameter;
+};
+
+/** Reads an event file - the timed events go into events (sorted by time, events at the same time
+stay in the order of the file), the sequencer settings are applied to the synth right away.
+Reports errors on stderr and returns false on any. */
+bool readEvents(rosic::Open303 &synth, const char *path, std::vector<Event> &events);
+
+/** Returns the number of frames to render: up to the end event, which is removed with everything
+after it, or else up to the last event plus the tail (in seconds). */
+long trimAtEnd(std::vector<Event> &events, float tail);
+
+/** Applies a timed event (except END) to the synth. */
+void applyEvent(rosic::Open303 &synth, rosic::Open303CCMap &ccMap, const Event &e);
+
+#endif
@@ -0,0 +1,229 @@
+#!/usr/bin/env python3
+# Checks that the render path of the synth does no double precision math.
+#
+#   float_check.py [--cxx PROG] [--objdump PROG] [--flags FLAGS] [--verbose]
+#
+# The ESP32 has a single precision FPU only, every double operation becomes a call into the soft
+# float library there. This compiles host/render_path.cpp (the render path as one translation
+# unit) without inlining, such that each function has its own code, and then:
+#
+# - collects the -Wdouble-promotion warnings in the functions of the render path,
+# - scans the object code of the render path - starting from the functions that are marked with
+#   RENDER_CODE or RENDER_INLINE in the sources and from the render* functions of render_path.cpp,
+#   following their calls - for calls of the soft double helpers (__adddf3, __extendsfdf2, ...)
+#   and of the double versions of the math library (pow instead of powf, ...), and on x86 hosts
+#   for double precision instructions (mulsd, ...), which stand in for the soft double calls there,
+# - reports the functions on that path which are defined in the .ino files but not marked with
+#   RENDER_CODE, as they would stay in flash on the device (see memory_map.py).
+#
+# It exits with 1 when any is found. With the ESP32 toolchain (e.g. --cxx xtensa-esp32-elf-g++
+# --flags "-mlongcalls"), the scan sees the actual soft double calls of the device.
+
+import argparse
+import os
+import re
+import subprocess
+import sys
+import tempfile
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+SKETCH = os.path.join(ROOT, 'Open303')
+SOURCE = os.path.join(ROOT, 'host', 'render_path.cpp')
+
+# soft double helpers of libgcc, e.g. __adddf3, __muldf3, __extendsfdf2, __fixdfsi, __ltdf2:
+SOFT_DOUBLE = re.compile(r'^__\w*df\w*$')
+
+# double versions of the math functions:
+DOUBLE_MATH = set('''acos asin atan atan2 cbrt ceil cos cosh exp exp2 expm1 fabs floor fmod frexp
+  hypot ldexp log log10 log1p log2 lrint lround modf pow rint round sin sinh sqrt tan tanh
+  trunc'''.split())
+
+# double precision SSE instructions (x86 hosts), loads and stores are not counted:
+X86_DOUBLE = re.compile(r'\s(v?(add|sub|mul|div|min|max|sqrt)sd|v?u?comisd|v?cvt\w*sd\w*|'
+                        r'v?cvtsd2\w+|v?cvttsd2\w+|v?(add|sub|mul|div)pd|v?cvt\w*pd\w*)\b')
+
+
+def run(args, stdin=None):
+  env = dict(os.environ, LC_ALL='C') # plain quotes in the messages of the compiler
+  p = subprocess.run(args, input=stdin, stdout=subprocess.PIPE, stderr=subprocess.PIPE,
+                     universal_newlines=True, env=env)
+  return p.returncode, p.stdout, p.stderr
+
+
+def render_functions():
+  """Names of the functions which are marked as part of the render path in the sources, like
+  Open303::getSample or roundAndClip."""
+  names = set()
+  marker = re.compile(r'\bRENDER_(?:CODE|INLINE)\b(.*)')
+  for name in sorted(os.listdir(SKETCH)):
+    if not (name.endswith('.h') or name.endswith('.ino')):
+      continue
+    with open(os.path.join(SKETCH, name), encoding='latin-1') as f:
+      for line in f:
+        m = marker.search(line)
+        if m and not line.lstrip().startswith('#'):
+          f2 = re.search(r'([A-Za-z_][\w:]*)\s*\(', m.group(1))
+          if f2:
+            names.add(f2.group(1))
+  return names
+
+
+def out_of_line_functions():
+  """Names of the functions which are defined in the .ino files, like AnalogEnvelope::noteOn -
+  these are never inlined into the render path and end up in flash unless they are marked."""
+  names = set()
+  definition = re.compile(r'^[A-Za-z_][\w:<>*& ]*?\b((?:\w+::)*~?\w+)\s*\([^;]*$')
+  for name in sorted(os.listdir(SKETCH)):
+    if not name.endswith('.ino'):
+      continue
+    with open(os.path.join(SKETCH, name), encoding='latin-1') as f:
+      for line in f:
+        m = definition.match(line)
+        if m and not line.startswith(('#', 'return', 'else')):
+          names.add(m.group(1))
+  return names
+
+
+def base_name(demangled):
+  """rosic::Open303::getSample() -> Open303::getSample"""
+  name = demangled.split('(')[0]
+  if name.startswith('rosic::'):
+    name = name[len('rosic::'):]
+  return name
+
+
+def main():
+  parser = argparse.ArgumentParser(description='checks the render path for double precision math')
+  parser.add_argument('--cxx', default='g++', help='C++ compiler')
+  parser.add_argument('--objdump', help='objdump of the toolchain (derived from --cxx)')
+  parser.add_argument('--flags', default='', help='additional compiler flags')
+  parser.add_argument('--verbose', action='store_true', help='list the scanned functions')
+  args = parser.parse_args()
+  objdump = args.objdump or re.sub(r'(g\+\+|c\+\+|clang\+\+)$', 'objdump', args.cxx)
+  if objdump == args.cxx:
+    objdump = 'objdump'
+
+  with tempfile.TemporaryDirectory() as tmp:
+    obj = os.path.join(tmp, 'render_path.o')
+    cmd = [args.cxx, '-std=gnu++11', '-O2', '-fno-inline', '-ffunction-sections',
+           '-Wdouble-promotion', '-I', os.path.relpath(SKETCH), '-c', SOURCE, '-o', obj] + args.flags.split()
+    code, _, errors = run(cmd)
+    if code != 0:
+      sys.stderr.write(errors)
+      sys.exit('compilation failed')
+    _, relocations, _ = run([objdump, '-r', obj])
+    _, disassembly, _ = run([objdump, '-d', '--no-show-raw-insn', obj])
+    _, symbols, _ = run([objdump, '-t', obj])
+
+  # the functions defined in the object (by section) and what each of them references:
+  defined = set()
+  for line in symbols.splitlines():
+    fields = line.split()
+    if len(fields) >= 6 and 'F' in fields[-4:-2] and fields[-3].startswith('.text'):
+      defined.add(fields[-1])
+  calls = {}
+  section = None
+  for line in relocations.splitlines():
+    m = re.match(r'RELOCATION RECORDS FOR \[\.(?:text|literal)\.(\S+)\]', line)
+    if m:
+      section = m.group(1)
+      continue
+    if line.startswith('RELOCATION RECORDS'):
+      section = None
+      continue
+    fields = line.split()
+    if section and len(fields) >= 3 and re.match(r'^[0-9a-f]+$', fields[0]):
+      target = re.split(r'[+-]0x', fields[2])[0]
+      calls.setdefault(section, set()).add(target)
+
+  # the double precision instructions in each function:
+  instructions = {}
+  function = None
+  for line in disassembly.splitlines():
+    m = re.match(r'^[0-9a-f]+ <(\S+)>:', line)
+    if m:
+      function = m.group(1)
+      continue
+    if function and X86_DOUBLE.search(line):
+      instructions.setdefault(function, []).append(line.split('\t')[-1].strip())
+
+  # demangle everything at once:
+  mangled = sorted(defined | set(t for ts in calls.values() for t in ts))
+  _, out, _ = run(['c++filt'], '\n'.join(mangled))
+  demangled = dict(zip(mangled, out.splitlines())) if out else dict((m, m) for m in mangled)
+
+  # walk the calls from the marked functions:
+  wanted = render_functions()
+  # (functions defined within their class are marked without the class name):
+  def marked_as(symbol):
+    name = base_name(demangled[symbol])
+    return name if name in wanted else name.split('::')[-1]
+  # (and the functions of render_path.cpp itself, which stand in for the audio task):
+  roots = [s for s in defined if marked_as(s) in wanted or
+           base_name(demangled[s]).startswith('render')]
+  found = set(marked_as(s) for s in roots)
+  reached = {}
+  stack = [(s, None) for s in sorted(roots)]
+  while stack:
+    symbol, caller = stack.pop()
+    if symbol in reached:
+      continue
+    reached[symbol] = caller
+    for target in sorted(calls.get(symbol, ())):
+      if target in defined:
+        stack.append((target, symbol))
+
+  def path(symbol):
+    names = []
+    while symbol is not None:
+      names.append(base_name(demangled[symbol]))
+      symbol = reached[symbol]
+    return ' <- '.join(names)
+
+  problems = 0
+  for symbol in sorted(reached, key=lambda s: demangled[s]):
+    if args.verbose:
+      print('scanned: %s' % demangled[symbol])
+    bad = ['calls ' + t for t in sorted(calls.get(symbol, ())) if t not in defined and
+           (SOFT_DOUBLE.match(t) or t in DOUBLE_MATH)]
+    used = instructions.get(symbol, [])
+    if used:
+      mnemonics = sorted(set(i.split()[0] for i in used))
+      bad.append('%d double instructions (%s)' % (len(used), ' '.join(mnemonics)))
+    if bad:
+      print('%s: %s' % (path(symbol), ', '.join(bad)))
+      problems += 1
+
+  # functions of the .ino files which are called from the render path but not marked:
+  out_of_line = out_of_line_functions()
+  for symbol in sorted(reached, key=lambda s: demangled[s]):
+    name = base_name(demangled[symbol])
+    if name in out_of_line and name not in wanted:
+      print('%s: not marked with RENDER_CODE' % path(symbol))
+      problems += 1
+
+  # the promotion warnings, by the function in which they occur:
+  reached_names = set(demangled[s].split('(')[0] for s in reached)
+  context = None
+  reported = set()
+  for line in errors.splitlines():
+    m = re.search(r"In (?:static )?(?:member )?function '(?:[^']*?\s)?([\w:~]+)\(", line)
+    if m:
+      context = m.group(1)
+      continue
+    if '[-Wdouble-promotion]' in line and context in reached_names:
+      location = ':'.join(line.split(': warning: ')[0].split(':')[:2])
+      if location not in reported:
+        reported.add(location)
+        print('%s: promotion to double at %s' % (base_name(context), location))
+        problems += 1
+
+  missing = sorted(wanted - found)
+  if args.verbose and missing:
+    print('not in %s: %s' % (os.path.basename(SOURCE), ', '.join(missing)))
+  print('%d functions on the render path, %d problems' % (len(reached), problems))
+  return 1 if problems > 0 else 0
+
+
+if __name__ == '__main__':
+  sys.exit(main())
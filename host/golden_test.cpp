@@ -0,0 +1,304 @@
+// Regression test of the sound of the synth - renders a fixed corpus of event files and compares
+// the output against checked-in reference renders.
+//
+//   golden_test [options] [NAME...]
+//
+//   --dir DIR          folder of the corpus: DIR/NAME.txt are the cases (default golden)
+//   --refs DIR         folder of the references NAME.wav (default: the corpus folder)
+//   --update           writes the references from the current renders instead of comparing
+//   --bit-exact        the renders have to match the references bit for bit
+//   --max-error X      largest allowed absolute difference of a sample (default 0.05)
+//   --min-snr DB       smallest allowed ratio of the reference to the difference (default 30)
+//   --max-lsd DB       largest allowed log-spectral distance (default 0.5)
+//   --out DIR          writes the renders of the failing cases to DIR/NAME.wav, for listening
+//   --list             lists the cases and exits
+//
+// Without names, all cases of the corpus are run. Each case is an event file (the format is
+// described in event_file.h) which is rendered by a fresh rosic::Open303 at its exact samples,
+// straight from Open303::getSample (mono, float) - so the panner and the output conversion are
+// not covered. A case ends at its end event (or 0.5 seconds after its last event).
+//
+// The comparison is by three metrics, each with its own limit: the largest absolute difference
+// of a sample, the signal to noise ratio of the reference to the difference and the log-spectral
+// distance of the average power spectra (2048 point Hann windows, half overlapping) in dB. The
+// first two catch any change of the waveform, the last one a change of the timbre which is not a
+// mere phase shift. Optimizations which reorder the float math (or a compiler which contracts
+// into fused multiply-adds) change the rounding, which adds up in the phase of the oscillator
+// over a case - down to about 40 dB SNR for the acid line, while a 3% change of the cutoff gives
+// 5 to 25 dB and an LSD above 0.5 dB. The default limits are set in between. For refactors that
+// should not change anything, --bit-exact requires identical samples and reports the first one
+// that differs, e.g. against references of the code before:
+//
+//   golden_test --update --refs /tmp/refs    (before the refactor)
+//   golden_test --bit-exact --refs /tmp/refs (after)
+//
+// The references depend on SAMPLE_RATE, a mismatch fails. Exits with 1 when any case fails.
+
+#include <dirent.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "event_file.h"
+#include "wav_file.h"
+
+using namespace rosic;
+
+static void usage()
+{
+  fprintf(stderr,
+    "usage: golden_test [--dir DIR] [--refs DIR] [--update] [--bit-exact] [--max-error X]\n"
+    "                   [--min-snr DB] [--max-lsd DB] [--out DIR] [--list] [NAME...]\n");
+}
+
+/** Renders the event file of a case into output (mono). Returns false on errors in the file. */
+static bool render(const std::string &path, std::vector<float> &output)
+{
+  Open303      synth;
+  Open303CCMap ccMap;
+  std::vector<Event> events;
+  if( !readEvents(synth, path.c_str(), events) )
+    return false;
+  if( events.empty() )
+  {
+    fprintf(stderr, "%s: no events\n", path.c_str());
+    return false;
+  }
+
+  long numFrames = trimAtEnd(events, 0.5f);
+  output.resize(numFrames);
+  size_t nextEvent = 0;
+  for(long n=0; n<numFrames; n++)
+  {
+    while( nextEvent < events.size() && events[nextEvent].frame <= n )
+      applyEvent(synth, ccMap, events[nextEvent++]);
+    output[n] = synth.getSample();
+  }
+  return true;
+}
+
+/** The power spectrum of x averaged over half overlapping Hann windowed frames, fftSize/2 bins. */
+static std::vector<double> averagePowerSpectrum(const std::vector<float> &x, int fftSize)
+{
+  FourierTransformerRadix2 transformer;
+  transformer.setBlockSize(fftSize);
+  transformer.setRealSignalMode(true);
+
+  std::vector<float>  window(fftSize), frame(fftSize), magnitudes(fftSize/2);
+  std::vector<double> power(fftSize/2, 0.0);
+  for(int n=0; n<fftSize; n++)
+    window[n] = (float) (0.5 - 0.5*cos(2.0*PI*n/fftSize));
+
+  int  hop       = fftSize/2;
+  long numFrames = 0;
+  for(long start=0; start==0 || start+fftSize<=(long)x.size(); start+=hop)
+  {
+    // a render shorter than one frame is zero padded:
+    for(int n=0; n<fftSize; n++)
+      frame[n] = start+n < (long)x.size() ? window[n] * x[start+n] : 0.0f;
+    transformer.getRealSignalMagnitudes(frame.data(), magnitudes.data());
+    for(int k=0; k<fftSize/2; k++)
+      power[k] += (double) magnitudes[k] * (double) magnitudes[k];
+    numFrames++;
+  }
+  for(int k=0; k<fftSize/2; k++)
+    power[k] /= numFrames;
+  return power;
+}
+
+/** The result of the comparison of a render with its reference. */
+struct Comparison
+{
+  double maxError;       // largest absolute difference
+  long   maxErrorFrame;
+  double snr;            // in dB, HUGE_VAL for identical signals
+  double lsd;            // log-spectral distance in dB
+  long   firstDifference; // first sample with different bits, -1 for none
+};
+
+static Comparison compare(const std::vector<float> &output, const std::vector<float> &reference)
+{
+  Comparison c;
+  c.maxError        = 0.0;
+  c.maxErrorFrame   = 0;
+  c.firstDifference = -1;
+  double signal = 0.0, noise = 0.0;
+  for(size_t n=0; n<reference.size(); n++)
+  {
+    double d = (double) output[n] - (double) reference[n];
+    if( fabs(d) > c.maxError || d != d )
+    {
+      c.maxError      = d != d ? HUGE_VAL : fabs(d);
+      c.maxErrorFrame = (long) n;
+    }
+    if( c.firstDifference < 0 && memcmp(&output[n], &reference[n], sizeof(float)) != 0 )
+      c.firstDifference = (long) n;
+    signal += (double) reference[n] * (double) reference[n];
+    noise  += d*d;
+  }
+  if( noise == 0.0 )
+    c.snr = HUGE_VAL;
+  else if( noise != noise )
+    c.snr = -HUGE_VAL;
+  else
+    c.snr = 10.0 * log10(std::max(signal, 1e-30) / noise);
+
+  // the distance of the spectra in dB, bins below -120 dB of the loudest one count as -120 dB:
+  std::vector<double> p = averagePowerSpectrum(output,    2048);
+  std::vector<double> q = averagePowerSpectrum(reference, 2048);
+  double floor = 1e-12 * std::max(*std::max_element(q.begin(), q.end()), 1e-30);
+  double sum   = 0.0;
+  for(size_t k=0; k<q.size(); k++)
+  {
+    double d = 10.0 * log10((p[k] + floor) / (q[k] + floor));
+    sum += d*d;
+  }
+  c.lsd = sum == sum ? sqrt(sum / q.size()) : HUGE_VAL;
+  return c;
+}
+
+/** The names of the cases in the corpus folder (the event files without .txt), sorted. */
+static std::vector<std::string> listCases(const std::string &dir)
+{
+  std::vector<std::string> names;
+  DIR *d = opendir(dir.c_str());
+  if( d == NULL )
+  {
+    perror(dir.c_str());
+    return names;
+  }
+  while( struct dirent *entry = readdir(d) )
+  {
+    std::string name = entry->d_name;
+    if( name.size() > 4 && name.compare(name.size()-4, 4, ".txt") == 0 )
+      names.push_back(name.substr(0, name.size()-4));
+  }
+  closedir(d);
+  std::sort(names.begin(), names.end());
+  return names;
+}
+
+int main(int argc, char **argv)
+{
+  std::string dir = "golden", refDir, outDir;
+  bool   update   = false;
+  bool   bitExact = false;
+  bool   list     = false;
+  double maxError = 0.05;
+  double minSnr   = 30.0;
+  double maxLsd   = 0.5;
+  std::vector<std::string> names;
+
+  for(int i=1; i<argc; i++)
+  {
+    bool hasValue = i+1 < argc;
+    if(      !strcmp(argv[i], "--dir")       && hasValue ) dir      = argv[++i];
+    else if( !strcmp(argv[i], "--refs")      && hasValue ) refDir   = argv[++i];
+    else if( !strcmp(argv[i], "--out")       && hasValue ) outDir   = argv[++i];
+    else if( !strcmp(argv[i], "--max-error") && hasValue ) maxError = atof(argv[++i]);
+    else if( !strcmp(argv[i], "--min-snr")   && hasValue ) minSnr   = atof(argv[++i]);
+    else if( !strcmp(argv[i], "--max-lsd")   && hasValue ) maxLsd   = atof(argv[++i]);
+    else if( !strcmp(argv[i], "--update") )                update   = true;
+    else if( !strcmp(argv[i], "--bit-exact") )             bitExact = true;
+    else if( !strcmp(argv[i], "--list") )                  list     = true;
+    else if( argv[i][0] == '-' ) { usage(); return 1; }
+    else names.push_back(argv[i]);
+  }
+  if( refDir.empty() )
+    refDir = dir;
+  if( names.empty() )
+    names = listCases(dir);
+  if( names.empty() )
+  {
+    fprintf(stderr, "%s: no cases\n", dir.c_str());
+    return 1;
+  }
+  if( list )
+  {
+    for(size_t i=0; i<names.size(); i++)
+      printf("%s\n", names[i].c_str());
+    return 0;
+  }
+
+  int failed = 0;
+  for(size_t i=0; i<names.size(); i++)
+  {
+    const char *name = names[i].c_str();
+    std::string refPath = refDir + "/" + names[i] + ".wav";
+    std::vector<float> output, reference;
+    if( !render(dir + "/" + names[i] + ".txt", output) )
+    {
+      printf("FAIL %-24s event file\n", name);
+      failed++;
+      continue;
+    }
+
+    if( update )
+    {
+      if( !writeWavFloat(refPath.c_str(), output.data(), 1, SAMPLE_RATE, (long) output.size()) )
+        return 1;
+      printf("WROTE %-23s %ld frames\n", name, (long) output.size());
+      continue;
+    }
+
+    int numChannels, sampleRate;
+    if( !readWavFloat(refPath.c_str(), reference, numChannels, sampleRate) )
+    {
+      printf("FAIL %-24s no reference\n", name);
+      failed++;
+      continue;
+    }
+    const char *problem = NULL;
+    char text[200];
+    if( numChannels != 1 || sampleRate != SAMPLE_RATE )
+    {
+      snprintf(text, sizeof(text), "reference has %d channels at %d Hz, the render 1 at %d Hz",
+        numChannels, sampleRate, SAMPLE_RATE);
+      problem = text;
+    }
+    else if( reference.size() != output.size() )
+    {
+      snprintf(text, sizeof(text), "reference has %ld frames, the render %ld",
+        (long) reference.size(), (long) output.size());
+      problem = text;
+    }
+
+    bool pass = false;
+    if( problem == NULL )
+    {
+      Comparison c = compare(output, reference);
+      if( bitExact )
+      {
+        pass = c.firstDifference < 0;
+        if( pass )
+          snprintf(text, sizeof(text), "bit exact");
+        else
+          snprintf(text, sizeof(text), "first difference at frame %ld: %.9g instead of %.9g",
+            c.firstDifference, (double) output[c.firstDifference], (double) reference[c.firstDifference]);
+      }
+      else
+      {
+        pass = c.maxError <= maxError && c.snr >= minSnr && c.lsd <= maxLsd;
+        snprintf(text, sizeof(text), "max error %.3g (frame %ld), SNR %.1f dB, LSD %.3f dB",
+          c.maxError, c.maxErrorFrame, c.snr, c.lsd);
+      }
+    }
+    printf("%s %-24s %s\n", pass ? "PASS" : "FAIL", name, text);
+
+    if( !pass )
+    {
+      failed++;
+      if( !outDir.empty() )
+        writeWavFloat((outDir + "/" + names[i] + ".wav").c_str(), output.data(), 1, SAMPLE_RATE,
+          (long) output.size());
+    }
+  }
+
+  if( !update )
+    printf("%d of %d cases passed\n", (int) names.size() - failed, (int) names.size());
+  return failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,98 @@
+// Benchmark for the memory layout of the synth (rosic::Open303 and rosic::Open303ColdData) on the
+// host.
+//
+//   layout_bench [--voices N] [--seconds S] [--evict KB]
+//
+// Renders a sequencer pattern with N independent synths (default 16), block by block in
+// turn, like voices of a polyphonic instrument or like tasks which share a cache. With --evict,
+// a buffer of the given size is written between the blocks, to emulate other work that pushes
+// the synth out of the cache (only the rendering is timed). The sizes of the audio-rate state and
+// of the cold data are reported first, they show how much has to be in the cache per voice.
+//
+// For the cache behaviour itself, run it under a cache profiler, e.g.
+//   valgrind --tool=cachegrind ./layout_bench --voices 64 --seconds 1
+//   perf stat -e cache-references,cache-misses ./layout_bench --voices 64
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+
+#include "rosic_host.h"
+
+static void usage()
+{
+  fprintf(stderr, "usage: layout_bench [--voices N] [--seconds S] [--evict KB]\n");
+}
+
+int main(int argc, char **argv)
+{
+  int   numVoices = 16;
+  float seconds   = 5.0f;
+  long  evictSize = 0;
+  const int blockSize = 32;
+
+  for(int i=1; i<argc; i++)
+  {
+    bool hasValue = i+1 < argc;
+    if(      !strcmp(argv[i], "--voices")  && hasValue ) numVoices = atoi(argv[++i]);
+    else if( !strcmp(argv[i], "--seconds") && hasValue ) seconds   = (float) atof(argv[++i]);
+    else if( !strcmp(argv[i], "--evict")   && hasValue ) evictSize = 1024 * strtol(argv[++i], NULL, 0);
+    else { usage(); return 1; }
+  }
+  if( numVoices < 1 || seconds <= 0.0f || evictSize < 0 )
+  {
+    usage();
+    return 1;
+  }
+
+  std::vector<rosic::Open303ColdData*> coldData(numVoices);
+  std::vector<rosic::Open303*>         synths(numVoices);
+  for(int v=0; v<numVoices; v++)
+  {
+    coldData[v] = new rosic::Open303ColdData;
+    synths[v]   = newAlignedSynth(coldData[v]);
+    rosic::EventStorm::setBenchPattern(synths[v]->sequencer.getPattern(0));
+    synths[v]->sequencer.setMode(rosic::AcidSequencer::KEY_SYNC);
+    synths[v]->noteOn(36 + v % 12, 100, 0.0f);
+  }
+
+  const rosic::Open303 &first = *synths[0];
+  long stateBytes = (const char*) (&first.panner + 1) - (const char*) &first.sequencer;
+  printf("Open303:         %6u bytes (audio-rate state from the sequencer to the panner: %ld)\n",
+    (unsigned) sizeof(rosic::Open303), stateBytes);
+  printf("Open303ColdData: %6u bytes (wavetables %u, sequencer data %u)\n",
+    (unsigned) sizeof(rosic::Open303ColdData), (unsigned) (2*sizeof(rosic::MipMappedWaveTable)),
+    (unsigned) sizeof(rosic::AcidSequencerData));
+
+  std::vector<char> evictBuffer(evictSize > 0 ? evictSize : 1);
+  std::vector<float> block(blockSize);
+  long numBlocks = (long) (seconds * SAMPLE_RATE / blockSize);
+  double renderTime = 0.0;
+  float checksum = 0.0f;
+  for(long b=0; b<numBlocks; b++)
+  {
+    for(int v=0; v<numVoices; v++)
+    {
+      if( evictSize > 0 )
+        memset(evictBuffer.data(), (int) (b+v), evictSize);
+      auto start = std::chrono::steady_clock::now();
+      for(int n=0; n<blockSize; n++)
+        block[n] = synths[v]->getSample();
+      renderTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      checksum += block[0] + evictBuffer[0]; // keeps the work from being optimized out
+    }
+  }
+
+  double numSamples = (double) numBlocks * blockSize * numVoices;
+  printf("%d voices, %ld blocks of %d samples, evict %ld kB: %.2f ns/sample (check %g)\n",
+    numVoices, numBlocks, blockSize, evictSize / 1024, renderTime * 1e9 / numSamples, (double) checksum);
+
+  for(int v=0; v<numVoices; v++)
+  {
+    deleteAlignedSynth(synths[v]);
+    delete coldData[v];
+  }
+  return 0;
+}
@@ -0,0 +1,138 @@
+#!/usr/bin/env python3
+# Memory map report for the sketch - shows where the code and data of each module ended up.
+#
+#   memory_map.py [--readelf PROG] [--all] ELF
+#
+# Reads the symbol table of the linked sketch (the .elf in the Arduino build folder, e.g. from
+# "Sketch > Export compiled Binary" or arduino-cli compile --export-binaries) and sums the sizes
+# of the symbols per module (rosic class or free function) and placement: IRAM, DRAM, flash or
+# PSRAM. By default only the rosic modules and the render path are listed, --all lists everything.
+# The render path are the functions marked with RENDER_CODE or RENDER_INLINE in the sources (the
+# same ones that float_check.py starts from). Each of them that was placed anywhere else than in
+# IRAM is reported as an error, as it can stall the audio task on flash cache misses (see
+# RENDER_IN_IRAM in Open303.ino), and the script exits with 1 then.
+#
+# The readelf of the ESP32 toolchain is found on the PATH for the usual targets, otherwise give
+# it with --readelf (the host readelf works as well for the symbol table).
+
+import argparse
+import re
+import shutil
+import subprocess
+import sys
+
+from float_check import render_functions
+
+# section name prefixes and where they live:
+PLACEMENTS = [
+  ('.iram0.',      'iram'),
+  ('.iram1',       'iram'),
+  ('.dram0.',      'dram'),
+  ('.dram1',       'dram'),
+  ('.noinit',      'dram'),
+  ('.flash.text',  'flash'),
+  ('.flash.rodata', 'flash'),
+  ('.flash.',      'flash'),
+  ('.ext_ram',     'psram'),
+  ('.rtc.',        'rtc'),
+]
+COLUMNS = ['iram', 'dram', 'flash', 'psram', 'rtc']
+
+def find_readelf(name):
+  if name:
+    return name
+  for candidate in ['xtensa-esp32s3-elf-readelf', 'xtensa-esp32-elf-readelf',
+                    'xtensa-esp32s2-elf-readelf', 'riscv32-esp-elf-readelf', 'readelf']:
+    if shutil.which(candidate):
+      return candidate
+  sys.exit('no readelf found, use --readelf')
+
+
+def run(args, stdin=None):
+  return subprocess.run(args, input=stdin, stdout=subprocess.PIPE, check=True,
+                        universal_newlines=True).stdout
+
+
+def placement(section):
+  for prefix, where in PLACEMENTS:
+    if section.startswith(prefix):
+      return where
+  return None
+
+
+def module(name):
+  # rosic::Class::function -> rosic::Class, anything else -> the name without the arguments
+  name = name.split('(')[0]
+  m = re.match(r'(rosic::\w+)', name)
+  if m:
+    return m.group(1)
+  return name
+
+
+def on_render_path(name, marked):
+  # marked names are qualified (Open303::getSample) or not (roundAndClip, or a member function
+  # defined within its class, like getTriangularRandom):
+  if name.startswith('rosic::'):
+    name = name[len('rosic::'):]
+    return name in marked or name.split('::')[-1] in marked
+  return name in marked
+
+
+def main():
+  parser = argparse.ArgumentParser(description='memory map report for the sketch')
+  parser.add_argument('--readelf', help='readelf program of the toolchain')
+  parser.add_argument('--all', action='store_true', help='list all modules, not only rosic')
+  parser.add_argument('elf')
+  args = parser.parse_args()
+  readelf = find_readelf(args.readelf)
+
+  # section index -> placement:
+  sections = {}
+  for line in run([readelf, '-SW', args.elf]).splitlines():
+    m = re.match(r'\s*\[\s*(\d+)\]\s+(\S+)', line)
+    if m:
+      sections[m.group(1)] = placement(m.group(2))
+
+  # symbols with a size in one of the known sections:
+  symbols = []
+  for line in run([readelf, '-sW', args.elf]).splitlines():
+    fields = line.split()
+    if len(fields) < 8 or fields[3] not in ('FUNC', 'OBJECT'):
+      continue
+    where = sections.get(fields[6])
+    size = int(fields[2], 0)
+    if where is None or size == 0:
+      continue
+    symbols.append((fields[7], fields[3], size, where))
+
+  names = run(['c++filt'], '\n'.join(s[0] for s in symbols)).splitlines() \
+    if shutil.which('c++filt') else [s[0] for s in symbols]
+
+  marked = render_functions()
+  table = {}
+  errors = set()
+  for (raw, kind, size, where), name in zip(symbols, names):
+    render = kind == 'FUNC' and on_render_path(name.split('(')[0], marked)
+    if render and where != 'iram':
+      errors.add((name, where))
+    mod = module(name)
+    if not args.all and not (mod.startswith('rosic::') or render):
+      continue
+    row = table.setdefault((mod, 'code' if kind == 'FUNC' else 'data'), dict.fromkeys(COLUMNS, 0))
+    row[where] += size
+
+  print('%-40s %-5s' % ('module', 'kind') + ''.join('%9s' % c for c in COLUMNS))
+  totals = dict.fromkeys(COLUMNS, 0)
+  for (mod, kind), row in sorted(table.items()):
+    print('%-40s %-5s' % (mod, kind) + ''.join('%9d' % row[c] for c in COLUMNS))
+    for c in COLUMNS:
+      totals[c] += row[c]
+  print('%-40s %-5s' % ('total', '') + ''.join('%9d' % totals[c] for c in COLUMNS))
+
+  for name, where in sorted(errors):
+    print('error: %s is in %s' % (name, where), file=sys.stderr)
+  return 1 if errors else 0
+
+
+if __name__ == '__main__':
+  sys.exit(main())
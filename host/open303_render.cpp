@@ -0,0 +1,207 @@
+// Offline renderer for the synth - renders a file of timed events into a WAV file on the host, as
+// fast as the machine can. This is the measurement bed for the performance of the synth and the
+// base of regression tests of its output.
+//
+//   open303-render [options] EVENTS OUT.wav
+//
+//   --set NAME=VALUE   sets a parameter before the rendering starts (can be repeated)
+//   --params FILE      sets the parameters from a file with one "NAME VALUE" per line
+//   --bits 16|24|32    output format, 32 is float (default 16)
+//   --dither MODE      none, tpdf or shaped for 16 and 24 bits (default none)
+//   --tail SECONDS     rendering goes on for this long after the last event (default 1)
+//   --block N          the synth renders blocks of N frames (default 32, like DMA_BUF_LEN)
+//   --list             lists the parameters with their default values and exits
+//   --quiet            no report
+//
+// OUT.wav can be - for stdout. The format of the event file is described in event_file.h, the
+// parameter names are the ones listed by --list.
+//
+// The events are applied at their exact sample. The synth, the panner and the conversion run
+// block by block like in the audio task of the sketch, the report (on stderr) gives the time they
+// took and the speed in multiples of real time. With make PROFILE=1, it also gives the breakdown
+// of Open303::getSample by stage.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include "event_file.h"
+#include "wav_file.h"
+
+using namespace rosic;
+
+static void usage()
+{
+  fprintf(stderr,
+    "usage: open303-render [--set NAME=VALUE] [--params FILE] [--bits 16|24|32] [--dither MODE]\n"
+    "                      [--tail SECONDS] [--block N] [--quiet] EVENTS OUT.wav\n"
+    "       open303-render --list\n");
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// WAV output:
+
+/** Packs a block into the little endian samples of the WAV file, from the output of the
+OutputConverter (16 or 24 bits) or from the float channels (32 bits). */
+static int packBlock(unsigned char *out, int bits, const void *converted, const float *left,
+  const float *right, int numFrames)
+{
+  unsigned char *p = out;
+  for(int n=0; n<2*numFrames; n++)
+  {
+    if( bits == 16 )
+    {
+      putWav16(p, (uint16_t) ((const int16_t*) converted)[n]);
+      p += 2;
+    }
+    else if( bits == 24 )
+    {
+      uint32_t x = (uint32_t) ((const int32_t*) converted)[n] >> 8; // left-justified
+      p[0] = x; p[1] = x >> 8; p[2] = x >> 16;
+      p += 3;
+    }
+    else
+    {
+      float    s = (n & 1) ? right[n/2] : left[n/2];
+      uint32_t x;
+      memcpy(&x, &s, 4);
+      putWav32(p, x);
+      p += 4;
+    }
+  }
+  return (int) (p - out);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+int main(int argc, char **argv)
+{
+  Open303      synth;
+  Open303CCMap ccMap;
+  int   numBits   = 16;
+  int   dither    = OutputConverter::NO_DITHER;
+  float tail      = 1.0f;
+  int   blockSize = 32;
+  bool  quiet     = false;
+  const char *eventPath = NULL, *outPath = NULL;
+
+  for(int i=1; i<argc; i++)
+  {
+    bool hasValue = i+1 < argc;
+    if( !strcmp(argv[i], "--set") && hasValue )
+    {
+      if( !setParameter(synth, argv[++i]) )
+      {
+        fprintf(stderr, "unknown parameter or missing value: %s\n", argv[i]);
+        return 1;
+      }
+    }
+    else if( !strcmp(argv[i], "--params") && hasValue )
+    {
+      if( !readParameters(synth, argv[++i]) )
+        return 1;
+    }
+    else if( !strcmp(argv[i], "--dither") && hasValue )
+    {
+      const char *mode = argv[++i];
+      if(      !strcmp(mode, "none") )   dither = OutputConverter::NO_DITHER;
+      else if( !strcmp(mode, "tpdf") )   dither = OutputConverter::TPDF;
+      else if( !strcmp(mode, "shaped") ) dither = OutputConverter::TPDF_SHAPED;
+      else { usage(); return 1; }
+    }
+    else if( !strcmp(argv[i], "--list") )
+    {
+      for(int p=0; p<numParameters; p++)
+        printf("%-20s %g\n", parameters[p].name, (double) (synth.*parameters[p].getter)());
+      return 0;
+    }
+    else if( !strcmp(argv[i], "--bits")  && hasValue ) numBits   = atoi(argv[++i]);
+    else if( !strcmp(argv[i], "--tail")  && hasValue ) tail      = (float) atof(argv[++i]);
+    else if( !strcmp(argv[i], "--block") && hasValue ) blockSize = atoi(argv[++i]);
+    else if( !strcmp(argv[i], "--quiet") )             quiet     = true;
+    else if( argv[i][0] == '-' && argv[i][1] != '\0' ) { usage(); return 1; }
+    else if( eventPath == NULL )                       eventPath = argv[i];
+    else if( outPath == NULL )                         outPath   = argv[i];
+    else { usage(); return 1; }
+  }
+  if( eventPath == NULL || outPath == NULL || blockSize < 1 || tail < 0.0f
+    || (numBits != 16 && numBits != 24 && numBits != 32) )
+  {
+    usage();
+    return 1;
+  }
+
+  std::vector<Event> events;
+  if( !readEvents(synth, eventPath, events) )
+    return 1;
+  if( events.empty() )
+  {
+    fprintf(stderr, "%s: no events\n", eventPath);
+    return 1;
+  }
+
+  // the length is known before the rendering, so the header is written first (also to stdout):
+  long numFrames = trimAtEnd(events, tail);
+  FILE *out = !strcmp(outPath, "-") ? stdout : fopen(outPath, "wb");
+  if( out == NULL || !writeWavHeader(out, 2, numBits, SAMPLE_RATE, numFrames) )
+  {
+    perror(outPath);
+    return 1;
+  }
+
+  OutputConverter converter;
+  converter.setNumBits(numBits);
+  converter.setDitherMode(dither);
+  std::vector<float>         left(blockSize), right(blockSize);
+  std::vector<int32_t>       converted(2*blockSize);
+  std::vector<unsigned char> bytes(2*4*blockSize);
+
+  double renderTime = 0.0;
+  size_t nextEvent  = 0;
+  for(long frame=0; frame<numFrames; frame+=blockSize)
+  {
+    int length = (int) std::min((long) blockSize, numFrames-frame);
+    auto start = std::chrono::steady_clock::now();
+    for(int n=0; n<length; n++)
+    {
+      while( nextEvent < events.size() && events[nextEvent].frame <= frame+n )
+        applyEvent(synth, ccMap, events[nextEvent++]);
+      left[n] = synth.getSample();
+    }
+    synth.panner.process(left.data(), left.data(), right.data(), length);
+    if( numBits != 32 )
+      converter.process(left.data(), right.data(), converted.data(), length);
+    renderTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    int numBytes = packBlock(bytes.data(), numBits, converted.data(), left.data(), right.data(),
+      length);
+    if( fwrite(bytes.data(), 1, numBytes, out) != (size_t) numBytes )
+    {
+      perror(outPath);
+      return 1;
+    }
+  }
+  if( out != stdout ? fclose(out) != 0 : fflush(out) != 0 )
+  {
+    perror(outPath);
+    return 1;
+  }
+
+  if( !quiet )
+  {
+    double seconds = (double) numFrames / SAMPLE_RATE;
+    fprintf(stderr, "%ld frames (%.2f s) and %d events in %.3f s: %.1f x real time, "
+      "%.1f ns/frame\n", numFrames, seconds, (int) events.size(), renderTime,
+      renderTime > 0.0 ? seconds / renderTime : 0.0, renderTime * 1e9 / std::max(numFrames, 1L));
+#ifdef PROFILE_SYNTH
+    char text[1024];
+    stageProfiler.format(text, sizeof(text));
+    fputs(text, stderr);
+#endif
+  }
+  return 0;
+}
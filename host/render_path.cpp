@@ -0,0 +1,52 @@
+// The render path of the sketch as one translation unit, for float_check.py - it is only
+// compiled to an object file and not linked.
+//
+// The functions below call the inlined entry points of the render path (the ones which the audio
+// task calls), such that their code is emitted and can be inspected. float_check.py compiles this
+// without inlining, so every function of the render path shows up with its own symbol. Functions
+// which are marked for the render path but not (or not always) called from there, like the
+// waveshaper of the TeeBeeFilter, are called here directly.
+
+#include "rosic_host.cpp" // all of librosic.a
+
+float renderSample(rosic::Open303 &synth)
+{
+  return synth.getSample();
+}
+
+float renderUnusedStages(rosic::TeeBeeFilter &filter, rosic::EllipticQuarterBandFilter &antiAlias,
+  float in)
+{
+  return filter.shape(in) + antiAlias.getSample(in);
+}
+
+// the per block math of audio_task1 in Open303.ino (which needs FreeRTOS and the I2S driver), with
+// the same expressions and types - keep the two in sync:
+void renderAudioTask(rosic::Open303 &synth, rosic::OutputConverter &converter,
+  rosic::AudioTelemetry &telemetry, rosic::LatencyController &latency, float *left, float *right,
+  void *out, int len, uint32_t render_cycles, float cpu_hz)
+{
+  synth.panner.process(left, left, right, len);
+  converter.process(left, right, out, len);
+  telemetry.blockRendered(render_cycles, (uint32_t)(len * cpu_hz / SAMPLE_RATE));
+  latency.update(render_cycles / cpu_hz, (float)len / SAMPLE_RATE);
+}
+
+void renderTelemetry(rosic::AudioTelemetry &telemetry, uint32_t cycles, uint32_t underruns)
+{
+  telemetry.blockRendered(cycles, 2*cycles);
+  telemetry.addUnderruns(underruns);
+}
+
+bool renderLog(rosic::LogRing &log, int value)
+{
+  return log.printf("%d", value);
+}
+
+#ifdef OUTPUT_CONVERTER_XTENSA
+// the rounding of OutputConverter::processScalar on the ESP32 (only with its toolchain):
+int32_t renderRounding(float x)
+{
+  return xtensaRound16(x) + xtensaRound24(x) + xtensaRound32(x);
+}
+#endif
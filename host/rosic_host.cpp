@@ -0,0 +1,120 @@
+// The rosic classes of the sketch as one translation unit - this is librosic.a of the host build.
+// The Arduino IDE compiles the .ino files of the sketch as C++, so they are included as they are.
+
+#include "rosic_host.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <new>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "GlobalFunctions.ino"
+#include "rosic_AcidGenerator.ino"
+#include "rosic_AcidPattern.ino"
+#include "rosic_AcidSequencer.ino"
+#include "rosic_AnalogEnvelope.ino"
+#include "rosic_AudioTelemetry.ino"
+#include "rosic_BiquadFilter.ino"
+#include "rosic_BlendOscillator.ino"
+#include "rosic_Complex.ino"
+#include "rosic_DecayEnvelope.ino"
+#include "rosic_EllipticQuarterBandFilter.ino"
+#include "rosic_EventStorm.ino"
+#include "rosic_FourierTransformerRadix2.ino"
+#include "rosic_FunctionTemplates.ino"
+#include "rosic_LatencyController.ino"
+#include "rosic_LeakyIntegrator.ino"
+#include "rosic_LogRing.ino"
+#include "rosic_MidiClockSync.ino"
+#include "rosic_MidiNoteEvent.ino"
+#include "rosic_MipMappedWaveTable.ino"
+#include "rosic_NoteStack.ino"
+#include "rosic_NumberManipulations.ino"
+#include "rosic_OnePoleFilter.ino"
+#include "rosic_Open303.ino"
+#include "rosic_Open303CCMap.ino"
+#include "rosic_OutputConverter.ino"
+#include "rosic_RealFunctions.ino"
+#include "rosic_StageProfiler.ino"
+#include "rosic_StereoPanner.ino"
+#include "rosic_TeeBeeFilter.ino"
+
+rosic::Open303* newAlignedSynth(rosic::Open303ColdData *externalColdData)
+{
+  void *memory = NULL;
+  if( posix_memalign(&memory, CACHE_LINE_SIZE, sizeof(rosic::Open303)) != 0 )
+    throw std::bad_alloc();
+  return new (memory) rosic::Open303(externalColdData);
+}
+
+void deleteAlignedSynth(rosic::Open303 *synth)
+{
+  if( synth == NULL )
+    return;
+  synth->~Open303();
+  free(synth);
+}
+
+CycleCounter::CycleCounter()
+{
+  fd        = -1;
+  lastTicks = rosic::StageProfiler::readTicks();
+  ticks     = 0;
+#ifdef __linux__
+  perf_event_attr attributes;
+  memset(&attributes, 0, sizeof(attributes));
+  attributes.type           = PERF_TYPE_HARDWARE;
+  attributes.size           = sizeof(attributes);
+  attributes.config         = PERF_COUNT_HW_CPU_CYCLES;
+  attributes.exclude_kernel = 1;
+  attributes.exclude_hv     = 1;
+  fd = (int) syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0); // this thread, any CPU
+#endif
+}
+
+CycleCounter::~CycleCounter()
+{
+#ifdef __linux__
+  if( fd >= 0 )
+    close(fd);
+#endif
+}
+
+uint64_t CycleCounter::read() const
+{
+#ifdef __linux__
+  uint64_t count;
+  if( fd >= 0 && ::read(fd, &count, sizeof(count)) == (ssize_t) sizeof(count) )
+    return count;
+#endif
+  uint32_t now = rosic::StageProfiler::readTicks();
+  ticks    += (uint32_t) (now - lastTicks);
+  lastTicks = now;
+  return ticks;
+}
+
+const char* CycleCounter::getUnit() const
+{
+  if( countsCycles() )
+    return "cycles";
+#if defined(__x86_64__) || defined(__i386__)
+  return "TSC ticks";
+#else
+  return "clock ns";
+#endif
+}
+
+const char* CycleCounter::getColumn() const
+{
+  if( countsCycles() )
+    return "cycles";
+#if defined(__x86_64__) || defined(__i386__)
+  return "tsc_ticks";
+#else
+  return "clock_ns";
+#endif
+}
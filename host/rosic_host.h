@@ -0,0 +1,98 @@
+// Shims for building the rosic classes of the sketch on a desktop machine - the tools in this
+// folder include this instead of the headers of the sketch and link librosic.a (see Makefile).
+//
+// The sketch gets SAMPLE_RATE from Open303.ino and PI from Arduino.h, here they are defined unless
+// the build passes them (make SAMPLE_RATE=48000). GlobalDefinitions.h takes care of INLINE and of
+// the ESP32 specific macros (RENDER_CODE and friends are empty without ESP_PLATFORM).
+
+#ifndef rosic_host_h
+#define rosic_host_h
+
+#include <stdint.h>
+#include <memory>
+
+#ifndef SAMPLE_RATE
+#define SAMPLE_RATE 44100 // the synth is built for one fixed sample rate, as on the device
+#endif
+#ifndef PI
+#define PI 3.1415926535897932384626433832795
+#endif
+
+#include "GlobalFunctions.h"
+#include "rosic_AcidGenerator.h"
+#include "rosic_AcidPattern.h"
+#include "rosic_AcidSequencer.h"
+#include "rosic_AnalogEnvelope.h"
+#include "rosic_AudioTelemetry.h"
+#include "rosic_BiquadFilter.h"
+#include "rosic_BlendOscillator.h"
+#include "rosic_Complex.h"
+#include "rosic_DecayEnvelope.h"
+#include "rosic_EllipticQuarterBandFilter.h"
+#include "rosic_EventStorm.h"
+#include "rosic_FourierTransformerRadix2.h"
+#include "rosic_FunctionTemplates.h"
+#include "rosic_LatencyController.h"
+#include "rosic_LeakyIntegrator.h"
+#include "rosic_LogRing.h"
+#include "rosic_MidiClockSync.h"
+#include "rosic_MidiNoteEvent.h"
+#include "rosic_MidiOutBuffer.h"
+#include "rosic_MidiParser.h"
+#include "rosic_MipMappedWaveTable.h"
+#include "rosic_NoteStack.h"
+#include "rosic_NumberManipulations.h"
+#include "rosic_OnePoleFilter.h"
+#include "rosic_Open303.h"
+#include "rosic_Open303CCMap.h"
+#include "rosic_OutputConverter.h"
+#include "rosic_RealFunctions.h"
+#include "rosic_StageProfiler.h"
+#include "rosic_StereoPanner.h"
+#include "rosic_TeeBeeFilter.h"
+
+// Open303 is aligned to the cache lines, which plain new only respects from C++17 on - so the
+// tools construct it in aligned raw memory with newAlignedSynth (which throws std::bad_alloc like
+// new) and destroy it with deleteAlignedSynth, or hold it in an AlignedSynthPointer.
+rosic::Open303* newAlignedSynth(rosic::Open303ColdData *externalColdData = NULL);
+void deleteAlignedSynth(rosic::Open303 *synth);
+
+struct AlignedSynthDeleter
+{
+  void operator()(rosic::Open303 *synth) const { deleteAlignedSynth(synth); }
+};
+typedef std::unique_ptr<rosic::Open303, AlignedSynthDeleter> AlignedSynthPointer;
+
+// Counts the CPU cycles of the calling thread for the benchmarks, like the cycle counter of the
+// ESP32 does on the device - with perf_event_open on Linux. Where that is not available (other
+// systems, perf_event_paranoid, containers), it falls back to StageProfiler::readTicks, which is
+// the time stamp counter on x86: that runs at a fixed reference rate, not at the clock of the
+// core, so getUnit tells the reports what they count.
+class CycleCounter
+{
+public:
+  CycleCounter();
+  ~CycleCounter();
+
+  /** Returns the current count. */
+  uint64_t read() const;
+
+  /** Returns true when read counts CPU cycles, false when it falls back to readTicks. */
+  bool countsCycles() const { return fd >= 0; }
+
+  /** Returns the unit of the counts for the text reports ("cycles", "TSC ticks" or "clock ns"). */
+  const char* getUnit() const;
+
+  /** Returns the unit as a column name for csv and json ("cycles", "tsc_ticks" or "clock_ns"). */
+  const char* getColumn() const;
+
+private:
+  CycleCounter(const CycleCounter&);            // not copyable (owns the file descriptor)
+  CycleCounter& operator=(const CycleCounter&);
+
+  int fd; // of the perf event, -1 for the fallback
+  mutable uint32_t lastTicks; // the fallback extends the 32 bit ticks to 64 bit
+  mutable uint64_t ticks;
+};
+
+#endif
@@ -0,0 +1,188 @@
+// Tail latency of the synth under event storms on the host.
+//
+//   storm_bench [--blocks 32,64,128,256,512] [--seconds S] [--storm NAME[,NAME...]]
+//               [--format text|csv] [--list]
+//
+// Renders S seconds (default 10) of audio block by block for each block size and each kind of
+// rosic::EventStorm (default all of them) - like the audio task of the sketch: the events of the
+// block, Open303::getSample for each frame, the panner and the conversion to 16 bit. The events
+// are worst cases: an accented note every block (retriggered or slid to), all mapped controllers
+// every block, waveform and shaper changes (which regenerate the wavetables) every block, or all
+// of them at once. The render time of each block is measured and reported as the median, the
+// 99th and 99.9th percentile and the maximum, next to the deadline (the duration of the block)
+// and the number of blocks that missed it. The mean hides exactly the blocks which cause the
+// underruns on the device, these numbers don't.
+//
+// The first second of each run is not measured (the caches and the branch predictors warm up).
+// The times are in microseconds, --format csv gives them also in CPU cycles (counted by a
+// CycleCounter - where the system doesn't give access to the cycle counter, the columns are in
+// ticks of the time stamp counter instead and are named so). On the device, STORM_BENCH in
+// Open303.ino runs the same storms at startup and prints the times in CPU cycles.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include "rosic_host.h"
+
+using namespace rosic;
+
+static void usage()
+{
+  fprintf(stderr,
+    "usage: storm_bench [--blocks 32,64,128,256,512] [--seconds S] [--storm NAME[,NAME...]]\n"
+    "                   [--format text|csv] [--list]\n");
+}
+
+struct Result
+{
+  int    kind;
+  int    blockSize;
+  int    numBlocks;
+  int    numLate;                  // blocks with a render time above the deadline
+  double deadline;                 // duration of a block in ns
+  EventStorm::Percentiles ns;      // render times in ns
+  EventStorm::Percentiles cycles;  // render times in the unit of the CycleCounter
+};
+
+static Result run(int kind, int blockSize, double seconds, const CycleCounter &cycleCounter,
+  double &checksum)
+{
+  AlignedSynthPointer synth(newAlignedSynth());
+  Open303CCMap    ccMap;
+  OutputConverter converter;
+  EventStorm      storm;
+  converter.setNumBits(16);
+  storm.setKind(kind);
+  storm.start(*synth);
+
+  std::vector<float>    left(blockSize), right(blockSize);
+  std::vector<int16_t>  converted(2*blockSize);
+  int numWarmUp = SAMPLE_RATE / blockSize;
+  int numBlocks = std::max((int) (seconds * SAMPLE_RATE / blockSize), 1);
+  std::vector<uint32_t> ns(numBlocks), cycles(numBlocks);
+
+  Result r;
+  r.kind      = kind;
+  r.blockSize = blockSize;
+  r.numBlocks = numBlocks;
+  r.numLate   = 0;
+  r.deadline  = 1e9 * blockSize / SAMPLE_RATE;
+  for(int b=-numWarmUp; b<numBlocks; b++)
+  {
+    auto     start       = std::chrono::steady_clock::now();
+    uint64_t startCycles = cycleCounter.read();
+    storm.applyBlock(*synth, ccMap);
+    for(int n=0; n<blockSize; n++)
+      left[n] = synth->getSample();
+    synth->panner.process(left.data(), left.data(), right.data(), blockSize);
+    converter.process(left.data(), right.data(), converted.data(), blockSize);
+    uint64_t endCycles   = cycleCounter.read();
+    auto     end         = std::chrono::steady_clock::now();
+    checksum += (double) left[0];
+    if( b < 0 )
+      continue;
+    ns[b]     = (uint32_t) std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    cycles[b] = (uint32_t) (endCycles - startCycles);
+    if( ns[b] > r.deadline )
+      r.numLate++;
+  }
+  EventStorm::getPercentiles(ns.data(),    numBlocks, r.ns);
+  EventStorm::getPercentiles(cycles.data(), numBlocks, r.cycles);
+  return r;
+}
+
+int main(int argc, char **argv)
+{
+  std::vector<int> blockSizes, kinds;
+  double      seconds = 10.0;
+  const char *format  = "text";
+  const char *blocks  = "32,64,128,256,512";
+  const char *storms  = NULL;
+
+  for(int i=1; i<argc; i++)
+  {
+    bool hasValue = i+1 < argc;
+    if(      !strcmp(argv[i], "--blocks")  && hasValue ) blocks  = argv[++i];
+    else if( !strcmp(argv[i], "--seconds") && hasValue ) seconds = atof(argv[++i]);
+    else if( !strcmp(argv[i], "--storm")   && hasValue ) storms  = argv[++i];
+    else if( !strcmp(argv[i], "--format")  && hasValue ) format  = argv[++i];
+    else if( !strcmp(argv[i], "--list") )
+    {
+      for(int k=0; k<EventStorm::NUM_KINDS; k++)
+        printf("%s\n", EventStorm::getKindName(k));
+      return 0;
+    }
+    else { usage(); return 1; }
+  }
+  for(const char *p=blocks; *p; )
+  {
+    blockSizes.push_back(atoi(p));
+    p += strcspn(p, ",");
+    p += *p == ',';
+  }
+  if( storms == NULL )
+  {
+    for(int k=0; k<EventStorm::NUM_KINDS; k++)
+      kinds.push_back(k);
+  }
+  else
+  {
+    for(const char *p=storms; *p; )
+    {
+      char name[32];
+      size_t length = strcspn(p, ",");
+      snprintf(name, sizeof(name), "%.*s", (int) length, p);
+      int kind = EventStorm::findKind(name);
+      if( kind < 0 )
+      {
+        fprintf(stderr, "unknown storm: %s (see --list)\n", name);
+        return 1;
+      }
+      kinds.push_back(kind);
+      p += length;
+      p += *p == ',';
+    }
+  }
+  bool badSize = false;
+  for(size_t i=0; i<blockSizes.size(); i++)
+    badSize |= blockSizes[i] < 1;
+  if( blockSizes.empty() || badSize || seconds <= 0.0 || kinds.empty()
+    || (strcmp(format, "text") && strcmp(format, "csv")) )
+  {
+    usage();
+    return 1;
+  }
+
+  CycleCounter cycleCounter;
+  const char  *column = cycleCounter.getColumn();
+  if( !strcmp(format, "text") )
+    printf("%-12s %6s %10s %10s %10s %10s %10s %6s\n", "storm", "block", "deadline", "p50",
+      "p99", "p99.9", "max", "late");
+  else
+    printf("storm,block,blocks,deadline_us,p50_us,p99_us,p999_us,max_us,p50_%s,p99_%s,"
+      "p999_%s,max_%s,late\n", column, column, column, column);
+  double checksum = 0.0;
+  for(size_t k=0; k<kinds.size(); k++)
+  {
+    for(size_t i=0; i<blockSizes.size(); i++)
+    {
+      Result r = run(kinds[k], blockSizes[i], seconds, cycleCounter, checksum);
+      const char *name = EventStorm::getKindName(r.kind);
+      if( !strcmp(format, "text") )
+        printf("%-12s %6d %7.1f us %7.1f us %7.1f us %7.1f us %7.1f us %6d\n", name,
+          r.blockSize, r.deadline * 1e-3, r.ns.p50 * 1e-3, r.ns.p99 * 1e-3, r.ns.p999 * 1e-3,
+          r.ns.max * 1e-3, r.numLate);
+      else
+        printf("%s,%d,%d,%.3f,%.3f,%.3f,%.3f,%.3f,%u,%u,%u,%u,%d\n", name, r.blockSize,
+          r.numBlocks, r.deadline * 1e-3, r.ns.p50 * 1e-3, r.ns.p99 * 1e-3, r.ns.p999 * 1e-3,
+          r.ns.max * 1e-3, r.cycles.p50, r.cycles.p99, r.cycles.p999, r.cycles.max, r.numLate);
+      fflush(stdout);
+    }
+  }
+  fprintf(stderr, "(check %g)\n", checksum);
+  return 0;
+}
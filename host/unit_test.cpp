@@ -0,0 +1,670 @@
+// Behaviour tests of the MIDI and timing classes of the sketch (and of the controller map).
+//
+//   unit_test [SUITE...]
+//
+// Feeds each class the input of situations from the device (e.g. byte streams with running
+// status, real-time bytes and SysEx for the MIDI parser, clock ticks with jitter and tempo
+// changes for the clock sync) and checks what comes out. Without names, all suites are run,
+// --list lists them. Each suite prints its failed checks (line and expression) followed by PASS
+// or FAIL. Exits with 1 on failure.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "rosic_host.h"
+
+using namespace rosic;
+
+//-------------------------------------------------------------------------------------------------
+// the checks:
+
+static int numChecks = 0; // of the current suite
+static int numFailed = 0;
+
+static void check(bool condition, const char *expression, int line)
+{
+  numChecks++;
+  if( condition )
+    return;
+  numFailed++;
+  printf("  line %d: %s\n", line, expression);
+}
+
+#define CHECK(condition) check(condition, #condition, __LINE__)
+
+static bool near(double x, double target, double tolerance)
+{
+  return fabs(x - target) <= tolerance;
+}
+
+//-------------------------------------------------------------------------------------------------
+// MidiParser:
+
+/** Parses the bytes and returns the completed messages. */
+static std::vector<MidiMessage> parse(MidiParser &parser, const std::vector<uint8_t> &bytes)
+{
+  std::vector<MidiMessage> messages;
+  MidiMessage message;
+  for(uint8_t byte : bytes)
+  {
+    if( parser.parseByte(byte, message) )
+      messages.push_back(message);
+  }
+  return messages;
+}
+
+static bool isMessage(const MidiMessage &m, int status, int data1, int data2)
+{
+  return m.status == status && m.data1 == data1 && m.data2 == data2;
+}
+
+static void testMidiParser()
+{
+  MidiParser parser;
+  std::vector<MidiMessage> m;
+
+  // running status, also for the messages with one data byte:
+  m = parse(parser, { 0x90, 60, 100, 62, 101, 64, 0 });
+  CHECK( m.size() == 3 );
+  CHECK( isMessage(m[0], 0x90, 60, 100) && isMessage(m[1], 0x90, 62, 101) );
+  CHECK( isMessage(m[2], 0x90, 64, 0) );
+  m = parse(parser, { 0xC1, 5, 6, 0xB0, 74, 10, 75, 20 });
+  CHECK( m.size() == 4 );
+  CHECK( isMessage(m[0], 0xC1, 5, 0) && isMessage(m[1], 0xC1, 6, 0) );
+  CHECK( isMessage(m[2], 0xB0, 74, 10) && isMessage(m[3], 0xB0, 75, 20) );
+
+  // real-time bytes come out at once and leave the message in progress and the running status
+  // alone:
+  parser.reset();
+  m = parse(parser, { 0x90, 0xF8, 60, 0xFA, 100, 62, 0xFC, 0xFE, 101 });
+  CHECK( m.size() == 6 );
+  CHECK( m[0].status == 0xF8 && m[1].status == 0xFA );
+  CHECK( isMessage(m[2], 0x90, 60, 100) );
+  CHECK( m[3].status == 0xFC && m[4].status == 0xFE );
+  CHECK( isMessage(m[5], 0x90, 62, 101) );
+
+  // system exclusive data is skipped (also bytes that look like notes), real-time bytes within it
+  // still come out, and it cancels the running status:
+  parser.reset();
+  m = parse(parser, { 0x90, 60, 100, 0xF0, 0x7E, 60, 0xF8, 100, 0xF7, 62, 100 });
+  CHECK( m.size() == 2 );
+  CHECK( isMessage(m[0], 0x90, 60, 100) );
+  CHECK( m[1].status == 0xF8 );
+  m = parse(parser, { 0x80, 60, 0 });
+  CHECK( m.size() == 1 && isMessage(m[0], 0x80, 60, 0) );
+
+  // a status byte aborts a message in progress:
+  m = parse(parser, { 0x90, 60, 0xB0, 7, 90 });
+  CHECK( m.size() == 1 && isMessage(m[0], 0xB0, 7, 90) );
+
+  // system common messages, which have no running status:
+  parser.reset();
+  m = parse(parser, { 0xF2, 0x10, 0x20, 0x30, 0x40, 0xF6, 0xF3, 5 });
+  CHECK( m.size() == 3 );
+  CHECK( isMessage(m[0], 0xF2, 0x10, 0x20) );
+  CHECK( isMessage(m[1], 0xF6, 0, 0) && isMessage(m[2], 0xF3, 5, 0) );
+
+  // data bytes without a status (e.g. when the cable was plugged in mid-stream) are ignored:
+  parser.reset();
+  m = parse(parser, { 60, 100, 0x90, 60, 100 });
+  CHECK( m.size() == 1 && isMessage(m[0], 0x90, 60, 100) );
+}
+
+//-------------------------------------------------------------------------------------------------
+// MidiClockSync:
+
+/** Sends numTicks clock ticks at the given tempo, starting at the time t (in samples, which is
+advanced), with a jitter of up to +-jitter samples on each arrival. Returns the largest deviation
+of the filtered period from the true one over the last half of the ticks. */
+static double sendClock(MidiClockSync &sync, double &t, double bpm, int numTicks, int jitter)
+{
+  double period = SAMPLE_RATE * 60.0 / (bpm * MidiClockSync::ticksPerQuarter);
+  double maxDeviation = 0.0;
+  uint32_t noise = 12345;
+  for(int k=0; k<numTicks; k++)
+  {
+    noise = noise * 1664525u + 1013904223u;
+    int offset = jitter > 0 ? (int) (noise >> 16) % (2*jitter+1) - jitter : 0;
+    sync.clockTick((uint32_t) (int64_t) floor(t + 0.5) + offset);
+    t += period;
+    if( 2*k >= numTicks )
+      maxDeviation = std::max(maxDeviation, fabs((double) sync.getSamplesPerTick() - period));
+  }
+  return maxDeviation;
+}
+
+static void testMidiClockSync()
+{
+  // a steady clock at 120 bpm (918.75 samples per tick, which arrive at whole samples):
+  MidiClockSync sync;
+  double t = 1000.0;
+  CHECK( !sync.isLocked() );
+  sendClock(sync, t, 120.0, 3, 0);
+  CHECK( !sync.isLocked() );
+  double deviation = sendClock(sync, t, 120.0, 200, 0);
+  CHECK( sync.isLocked() );
+  CHECK( near(sync.getTempo(), 120.0, 0.01) );
+  CHECK( deviation < 0.05 );
+
+  // the jitter of USB MIDI and the polling (+-1.5 ms, a third of the tick period) is filtered out
+  // of the period, and the clock stays locked:
+  MidiClockSync jittered;
+  t = 0.0;
+  deviation = sendClock(jittered, t, 120.0, 24*32, 66);
+  CHECK( jittered.isLocked() );
+  CHECK( near(jittered.getTempo(), 120.0, 0.5) );
+  CHECK( deviation < 0.005 * 918.75 );
+
+  // a tempo change within the capture range is followed smoothly, a jump beyond it (to half the
+  // tempo) re-initializes the loop with the measured interval and locks again after a few ticks:
+  sendClock(jittered, t, 140.0, 24*8, 66);
+  CHECK( jittered.isLocked() );
+  CHECK( near(jittered.getTempo(), 140.0, 1.0) );
+  sendClock(sync, t, 60.0, 2, 0);
+  CHECK( !sync.isLocked() );
+  CHECK( near(sync.getTempo(), 60.0, 0.05) );
+  sendClock(sync, t, 60.0, 4, 0);
+  CHECK( sync.isLocked() );
+
+  // the rate of the sequencer is pulled towards the clock, by at most 5% for a large error (like
+  // after a dropout), so it doesn't race or stall:
+  float rate = 1.0f / sync.getSamplesPerTick();
+  float position = (float) sync.getTickCount();
+  CHECK( near(sync.getTickRate(position), rate, 1e-3f * rate) );
+  CHECK( sync.getTickRate(position - 0.5f) > 1.005f * rate );
+  CHECK( sync.getTickRate(position + 0.5f) < 0.995f * rate );
+  CHECK( near(sync.getTickRate(position - 100.0f), 1.05f * rate, 1e-6) );
+  CHECK( near(sync.getTickRate(position + 100.0f), 0.95f * rate, 1e-6) );
+
+  // start and continue take effect on the next tick, which is counted from the start or from the
+  // song position:
+  sync.start();
+  CHECK( sync.clockTick((uint32_t) t) == MidiClockSync::START );
+  CHECK( sync.isRunning() && sync.getTickCount() == 0 );
+  CHECK( sync.clockTick((uint32_t) t + 1837) == MidiClockSync::NO_ACTION );
+  CHECK( sync.getTickCount() == 1 );
+  sync.stop();
+  sync.setSongPosition(4);
+  CHECK( !sync.isRunning() && sync.getTickCount() == 24 );
+  sync.continuePlayback();
+  CHECK( sync.clockTick((uint32_t) t + 2*1837) == MidiClockSync::CONTINUE );
+  sync.clockTick((uint32_t) t + 3*1837);
+  CHECK( sync.getTickCount() == 25 );
+}
+
+//-------------------------------------------------------------------------------------------------
+// MidiOutBuffer:
+
+static MidiMessage makeMessage(int status, int data1, int data2)
+{
+  MidiMessage m;
+  m.status = (uint8_t) status;
+  m.data1  = (uint8_t) data1;
+  m.data2  = (uint8_t) data2;
+  return m;
+}
+
+/** Reads all bytes out of the buffer, in chunks of up to chunkSize bytes. */
+static std::vector<uint8_t> readAll(MidiOutBuffer &buffer, int chunkSize)
+{
+  std::vector<uint8_t> bytes;
+  uint8_t chunk[MidiOutBuffer::capacity];
+  int n;
+  while( (n = buffer.read(chunk, chunkSize)) > 0 )
+    bytes.insert(bytes.end(), chunk, chunk + n);
+  return bytes;
+}
+
+static void testMidiOutBuffer()
+{
+  MidiOutBuffer buffer;
+
+  // running status: the status byte is sent once per run of channel messages, real-time messages
+  // don't break a run, another status or a system common message does:
+  buffer.writeMessage(makeMessage(0x90, 60, 100));
+  buffer.writeMessage(makeMessage(0x90, 62, 100));
+  buffer.writeMessage(makeMessage(0xF8, 0, 0));
+  buffer.writeMessage(makeMessage(0x90, 64, 0));
+  buffer.writeMessage(makeMessage(0xC0, 5, 0));
+  buffer.writeMessage(makeMessage(0xC0, 6, 0));
+  buffer.writeMessage(makeMessage(0xF2, 1, 2));
+  buffer.writeMessage(makeMessage(0xC0, 7, 0));
+  CHECK( buffer.getNumBytes() == 16 );
+  CHECK( readAll(buffer, 4) == std::vector<uint8_t>({ 0x90, 60, 100, 62, 100, 0xF8, 64, 0,
+    0xC0, 5, 6, 0xF2, 1, 2, 0xC0, 7 }) );
+  CHECK( buffer.getNumBytes() == 0 );
+
+  // what the receiver parses is what was written (data bytes masked to 7 bits):
+  MidiParser parser;
+  std::vector<MidiMessage> written;
+  for(int k=0; k<40; k++)
+    written.push_back(makeMessage(k % 3 == 0 ? 0xB0 : 0x90, k, 127 - k));
+  for(const MidiMessage &m : written)
+    buffer.writeMessage(m);
+  std::vector<MidiMessage> parsed = parse(parser, readAll(buffer, 7));
+  CHECK( parsed.size() == written.size() );
+  bool same = parsed.size() == written.size();
+  for(size_t i=0; same && i<parsed.size(); i++)
+    same = isMessage(parsed[i], written[i].status, written[i].data1, written[i].data2);
+  CHECK( same );
+  buffer.writeMessage(makeMessage(0x80, 200, 0x80 + 5));
+  parsed = parse(parser, readAll(buffer, 16));
+  CHECK( parsed.size() == 1 && isMessage(parsed[0], 0x80, 200 & 0x7F, 5) );
+
+  // when full, a message is dropped as a whole and counted, and it doesn't change the running
+  // status; it gets going again when the reader has made room:
+  MidiOutBuffer full;
+  int numWritten = 0;
+  while( full.writeMessage(makeMessage(0x90, 60, 100)) )
+    numWritten++;
+  CHECK( numWritten == 127 ); // 3 bytes, then 2 each: 255 bytes
+  CHECK( full.getNumBytes() == 255 && full.getNumDropped() == 1 );
+  CHECK( !full.writeMessage(makeMessage(0xB0, 7, 100)) );
+  CHECK( full.getNumDropped() == 2 );
+  CHECK( full.writeMessage(makeMessage(0xF8, 0, 0)) ); // the last byte
+  CHECK( full.getNumBytes() == 256 );
+  uint8_t chunk[64];
+  CHECK( full.read(chunk, 64) == 64 );
+  CHECK( full.writeMessage(makeMessage(0x90, 62, 100)) );
+  std::vector<uint8_t> rest = readAll(full, 64);
+  CHECK( rest.size() == 194 && rest[191] == 0xF8 && rest[192] == 62 && rest[193] == 100 );
+}
+
+//-------------------------------------------------------------------------------------------------
+// LatencyController:
+
+/** Feeds blocks with the given load (render time over block time) until the block size changes
+or maxSeconds have passed. Returns the time that passed. */
+static double runLoad(LatencyController &latency, float load, double maxSeconds)
+{
+  double t = 0.0;
+  while( t < maxSeconds )
+  {
+    float blockTime = (float) latency.getBlockSize() / SAMPLE_RATE;
+    t += (double) blockTime;
+    if( latency.update(load * blockTime, blockTime) )
+      break;
+  }
+  return t;
+}
+
+static void testLatencyController()
+{
+  // the fixed modes, with the block sizes rounded down to powers of two within 32...512:
+  LatencyController latency;
+  CHECK( latency.getMode() == LatencyController::TIGHT && latency.getBlockSize() == 32 );
+  CHECK( !latency.update(0.99f, 32.0f / SAMPLE_RATE) ); // no adaption outside the automatic mode
+  latency.setMode(LatencyController::SAFE);
+  CHECK( latency.getBlockSize() == 256 );
+  latency.setBlockSizes(100, 1000);
+  CHECK( latency.getBlockSize() == 512 );
+  latency.setMode(LatencyController::TIGHT);
+  CHECK( latency.getBlockSize() == 64 );
+  latency.setBlockSizes(1, 256);
+  CHECK( latency.getBlockSize() == 32 );
+
+  // the automatic mode starts tight and grows with a block above the grow load (0.7) - at once,
+  // up to the largest block size:
+  latency.setMode(LatencyController::AUTO);
+  CHECK( latency.getBlockSize() == 32 );
+  CHECK( runLoad(latency, 0.65f, 5.0) >= 5.0 && latency.getBlockSize() == 32 );
+  CHECK( latency.update(0.75f * 32 / SAMPLE_RATE, 32.0f / SAMPLE_RATE) );
+  CHECK( latency.getBlockSize() == 64 );
+  for(int k=0; k<10; k++)
+    runLoad(latency, 0.9f, 1.0);
+  CHECK( latency.getBlockSize() == 512 );
+
+  // it shrinks when the peak load stays below the shrink load (0.25) for the hold time (2 s) -
+  // here after the peak of 0.9 has decayed below 0.25 (in about 1.27 s) - never below the tight
+  // size, and a load in between keeps the block size:
+  double t = runLoad(latency, 0.2f, 10.0);
+  CHECK( latency.getBlockSize() == 256 && near(t, 3.27, 0.03) );
+  CHECK( runLoad(latency, 0.4f, 10.0) >= 10.0 && latency.getBlockSize() == 256 );
+  for(int k=0; k<10; k++)
+    runLoad(latency, 0.1f, 3.0);
+  CHECK( latency.getBlockSize() == 32 );
+
+  // a single spike above the shrink load restarts the hold time, once its peak has decayed (a
+  // peak of 0.5 takes about 0.7 s to decay below 0.25):
+  runLoad(latency, 0.9f, 1.0);
+  CHECK( latency.getBlockSize() == 64 );
+  runLoad(latency, 0.2f, 1.0);
+  float blockTime = 64.0f / SAMPLE_RATE;
+  CHECK( !latency.update(0.5f * blockTime, blockTime) );
+  t = runLoad(latency, 0.2f, 10.0);
+  CHECK( latency.getBlockSize() == 32 && t > 2.5 && t < 2.9 );
+
+  // the shrink load must stay below half of the grow load (shrinking halves the blocks, which
+  // may double the overhead per block), otherwise the thresholds are ignored:
+  latency.setLoadThresholds(0.6f, 0.35f);
+  CHECK( runLoad(latency, 0.65f, 1.0) >= 1.0 && latency.getBlockSize() == 32 );
+  latency.setLoadThresholds(0.6f, 0.25f);
+  runLoad(latency, 0.65f, 1.0);
+  CHECK( latency.getBlockSize() == 64 );
+  latency.setShrinkHoldTime(0.5f);
+  t = runLoad(latency, 0.1f, 10.0);
+  CHECK( latency.getBlockSize() == 32 && near(t, 0.5, 0.01) );
+}
+
+//-------------------------------------------------------------------------------------------------
+// Open303CCMap:
+
+static void testOpen303CCMap()
+{
+  AlignedSynthPointer synth(newAlignedSynth());
+  std::unique_ptr<Open303CCMap> ccMap(new Open303CCMap);
+  Open303CCMap &map = *ccMap;
+
+  // a 7 bit controller - the volume goes linearly from -60 to 0 dB (and 0 is silence), the decay
+  // exponentially from 200 to 2000 ms:
+  const double step = 60.0 / 127.0;
+  CHECK( map.handleCC(*synth, CC_303_VOLUME, 1) && near(synth->getVolume(), -60.0 + step, 1e-4) );
+  CHECK( map.handleCC(*synth, CC_303_VOLUME, 0) && synth->getVolume() < -300.0f );
+  synth->noteOn(48, 100, 0.0f);
+  float peak = 0.0f;
+  for(int n=0; n<4410; n++)
+    peak = std::max(peak, fabsf(synth->getSample()));
+  CHECK( peak * 32768.0f < 0.5f ); // rounds to 0 in 16 bit
+  synth->noteOn(48, 0, 0.0f);
+  CHECK( map.handleCC(*synth, CC_303_VOLUME, 64) );
+  CHECK( near(synth->getVolume(), -60.0 + 64 * step, 1e-4) );
+  CHECK( map.handleCC(*synth, CC_303_VOLUME, 127) && near(synth->getVolume(), 0.0, 1e-4) );
+  CHECK( map.handleCC(*synth, CC_303_DECAY, 127) && near(synth->getDecay(), 2000.0, 0.01) );
+  CHECK( map.handleCC(*synth, CC_303_DECAY, 64) );
+  CHECK( near(synth->getDecay(), 200.0 * pow(10.0, 64.0 / 127.0), 0.01) );
+  CHECK( !map.handleCC(*synth, 3, 64) ); // not mapped
+
+  // controllers 0...31 pair with an LSB on their number + 32, which refines between two MSB
+  // values, and a new MSB clears the LSB:
+  CHECK( map.handleCC(*synth, CC_303_VOLUME, 64) );
+  CHECK( map.handleCC(*synth, CC_303_VOLUME + 32, 64) );
+  CHECK( near(synth->getVolume(), -60.0 + 64.5 * step, 1e-4) );
+  CHECK( map.handleCC(*synth, CC_303_VOLUME + 32, 127) );
+  CHECK( near(synth->getVolume(), -60.0 + (64.0 + 127.0/128.0) * step, 1e-4) );
+  CHECK( map.handleCC(*synth, CC_303_VOLUME, 65) );
+  CHECK( near(synth->getVolume(), -60.0 + 65 * step, 1e-4) );
+  CHECK( map.handleCC(*synth, CC_303_VOLUME, 127) && map.handleCC(*synth, CC_303_VOLUME + 32, 64) );
+  CHECK( near(synth->getVolume(), 0.0, 1e-4) ); // nothing above the top
+  CHECK( !map.handleCC(*synth, 3 + 32, 64) );   // LSB of a controller that is not mapped
+
+  // the others have 14 bits via NRPN 0/controller number, with data entry MSB (6) and LSB (38):
+  synth->setTuning(440.0f);
+  CHECK( !map.handleCC(*synth, 99, 0) ); // the LSB of the number is still the null function
+  CHECK( map.handleCC(*synth, 98, CC_303_TUNING) );
+  CHECK( map.handleCC(*synth, 6, 127) && near(synth->getTuning(), 480.0, 1e-3) );
+  CHECK( map.handleCC(*synth, 6, 64) && map.handleCC(*synth, 38, 64) );
+  CHECK( near(synth->getTuning(), 400.0 + 80.0 * 64.5 / 127.0, 1e-3) );
+  CHECK( map.handleCC(*synth, 98, CC_303_VOLUME) && map.handleCC(*synth, 6, 127) );
+  CHECK( near(synth->getVolume(), 0.0, 1e-4) );
+  CHECK( near(synth->getTuning(), 400.0 + 80.0 * 64.5 / 127.0, 1e-3) ); // the old NRPN is left
+
+  // NRPNs of others (MSB != 0), unmapped numbers and RPNs turn data entry off:
+  float tuning = synth->getTuning();
+  CHECK( !map.handleCC(*synth, 99, 1) && !map.handleCC(*synth, 98, CC_303_TUNING) );
+  CHECK( !map.handleCC(*synth, 6, 0) && synth->getTuning() == tuning );
+  CHECK( map.handleCC(*synth, 99, 0) ); // ours again, with the LSB from before
+  CHECK( !map.handleCC(*synth, 98, 3) && !map.handleCC(*synth, 6, 0) );
+  CHECK( map.handleCC(*synth, 98, CC_303_TUNING) && !map.handleCC(*synth, 101, 0) );
+  CHECK( !map.handleCC(*synth, 6, 0) && synth->getTuning() == tuning );
+}
+
+//-------------------------------------------------------------------------------------------------
+// AcidSequencer:
+
+/** Runs the sequencer for numSamples samples and returns the samples at which it played a note
+(and the notes, if wanted). */
+static std::vector<int> playSequencer(AcidSequencer &sequencer, int numSamples,
+  std::vector<AcidNote> *notes = NULL)
+{
+  std::vector<int> times;
+  for(int n=0; n<numSamples; n++)
+  {
+    AcidNote *note = sequencer.getNote();
+    if( note == NULL )
+      continue;
+    times.push_back(n);
+    if( notes != NULL )
+      notes->push_back(*note);
+  }
+  return times;
+}
+
+/** Returns true when the times are the expected ones, within the tolerance (in samples). */
+static bool sameTimes(const std::vector<int> &times, const std::vector<int> &expected,
+  int tolerance = 0)
+{
+  if( times.size() < expected.size() )
+    return false;
+  for(size_t i=0; i<expected.size(); i++)
+  {
+    if( abs(times[i] - expected[i]) > tolerance )
+      return false;
+  }
+  return true;
+}
+
+static void testSequencerTiming()
+{
+  // at 125 bpm, a step (a 16th) is 5292 samples and a MIDI clock tick 882:
+  std::unique_ptr<AcidSequencerData> data(new AcidSequencerData);
+  AcidSequencer sequencer(data.get());
+  AcidPattern *pattern = sequencer.getPattern(0);
+  pattern->clear();
+  sequencer.setMode(AcidSequencer::KEY_SYNC);
+  sequencer.setTempo(125.0f);
+  const int s = 5292, t = 882;
+
+  // swing delays the off-beat 16ths, by up to 3 ticks at 75% (the default 50% is straight):
+  sequencer.start();
+  CHECK( sameTimes(playSequencer(sequencer, 6*s), { 0, s, 2*s, 3*s, 4*s, 5*s }) );
+  pattern->setSwing(62.5f);
+  CHECK( pattern->getTimingOffset(0) == 0.0f && pattern->getTimingOffset(1) == 1.5f );
+  sequencer.start();
+  CHECK( sameTimes(playSequencer(sequencer, 6*s), { 0, s + 3*t/2, 2*s, 3*s + 3*t/2, 4*s }) );
+  pattern->setSwing(75.0f);
+  CHECK( pattern->getTimingOffset(1) == 3.0f );
+  sequencer.start();
+  CHECK( sameTimes(playSequencer(sequencer, 6*s), { 0, s + 3*t, 2*s, 3*s + 3*t, 4*s }) );
+  pattern->setSwing(90.0f);
+  CHECK( pattern->getSwing() == 75.0f );
+
+  // micro-timing moves single steps, the sum with the swing is clipped to +-3 ticks (half a
+  // step), so the steps keep their order:
+  pattern->setSwing(50.0f);
+  pattern->setTiming(2, 5.0f);
+  pattern->setTiming(5, -10.0f);
+  CHECK( pattern->getTimingOffset(2) == 3.0f && pattern->getTimingOffset(5) == -3.0f );
+  sequencer.start();
+  CHECK( sameTimes(playSequencer(sequencer, 7*s),
+    { 0, s, 2*s + 3*t, 3*s, 4*s, 5*s - 3*t, 6*s }) );
+  pattern->setSwing(75.0f);
+  pattern->setTiming(1, -1.0f);
+  pattern->setTiming(3, 2.0f);
+  CHECK( pattern->getTimingOffset(1) == 2.0f && pattern->getTimingOffset(3) == 3.0f );
+  CHECK( pattern->getTimingOffset(5) == 0.0f ); // swing +3, micro-timing -3
+  sequencer.start();
+  CHECK( sameTimes(playSequencer(sequencer, 7*s),
+    { 0, s + 2*t, 2*s + 3*t, 3*s + 3*t, 4*s, 5*s, 6*s }) );
+
+  // an early first step can't be played before the start, so it comes right away:
+  pattern->clear();
+  pattern->setTiming(0, -2.0f);
+  sequencer.start();
+  CHECK( sameTimes(playSequencer(sequencer, 2*s), { 0, s }) );
+
+  // at a tempo with a fractional number of samples per step, the rounding doesn't accumulate:
+  pattern->clear();
+  pattern->setSwing(75.0f);
+  sequencer.setTempo(130.0f);
+  sequencer.start();
+  double step = 0.25 * 60.0 / 130.0 * SAMPLE_RATE;
+  std::vector<int> times = playSequencer(sequencer, (int) (1001 * step)), expected;
+  for(int k=0; k<1000; k++)
+    expected.push_back((int) floor((k + ((k & 1) ? 0.5 : 0.0)) * step + 0.5));
+  CHECK( sameTimes(times, expected, 1) );
+
+  // the same timing when the sequencer follows a MIDI clock (at 125 bpm):
+  sequencer.setMode(AcidSequencer::HOST_SYNC);
+  sequencer.setClockRate(1.0f / t);
+  pattern->setTiming(2, -1.0f);
+  sequencer.start();
+  CHECK( sameTimes(playSequencer(sequencer, 5*s), { 0, s + 3*t, 2*s - t, 3*s + 3*t, 4*s }, 1) );
+}
+
+/** Returns true when the note is the given step of the pattern (which has the key step % 12 and
+the octave pattern on each step), transposed by transpose semitones. */
+static bool isStep(const AcidNote &note, int pattern, int step, int transpose = 0)
+{
+  return note.octave == pattern && note.key == step % 12 + transpose;
+}
+
+static void testSequencerSong()
+{
+  std::unique_ptr<AcidSequencerData> data(new AcidSequencerData);
+  AcidSequencer sequencer(data.get());
+  for(int p=0; p<sequencer.getNumPatterns(); p++)
+  {
+    AcidPattern *pattern = sequencer.getPattern(p);
+    pattern->clear();
+    for(int k=0; k<16; k++)
+    {
+      pattern->setKey(k, k % 12);
+      pattern->setOctave(k, p);
+    }
+  }
+  sequencer.setMode(AcidSequencer::KEY_SYNC);
+  sequencer.setTempo(125.0f);
+  const int s = 5292; // samples per step
+
+  // a song of 64 steps: pattern 1 twice, pattern 2 transposed up by 3, pattern 3:
+  CHECK( sequencer.appendToSong(1, 2) && sequencer.appendToSong(2, 1, 3) );
+  CHECK( sequencer.appendToSong(3) && sequencer.getSongLength() == 3 );
+  CHECK( !sequencer.appendToSong(16) && !sequencer.appendToSong(0, 0) );
+  sequencer.setSongMode(true);
+  sequencer.start();
+  std::vector<AcidNote> notes;
+  std::vector<int> positions; // the song position after each note
+  for(int k=0; k<66; k++)
+  {
+    playSequencer(sequencer, s, &notes);
+    positions.push_back(sequencer.getSongPosition());
+  }
+  bool ok = notes.size() == 66;
+  for(int k=0; ok && k<66; k++)
+  {
+    int i = k % 64;
+    if( i < 32 )
+      ok = isStep(notes[k], 1, i % 16) && positions[k] == 0;
+    else if( i < 48 )
+      ok = isStep(notes[k], 2, i % 16, 3) && positions[k] == 1;
+    else
+      ok = isStep(notes[k], 3, i % 16) && positions[k] == 2;
+  }
+  CHECK( ok ); // the entries change exactly at the pattern boundaries, and the song loops
+
+  // locate sets the step from which continue plays, counted through the song (and wrapped):
+  sequencer.stop();
+  sequencer.locate(40);
+  sequencer.continuePlayback();
+  notes.clear();
+  playSequencer(sequencer, 2*s, &notes);
+  CHECK( notes.size() == 2 && isStep(notes[0], 2, 8, 3) && isStep(notes[1], 2, 9, 3) );
+  CHECK( sequencer.getSongPosition() == 1 );
+  sequencer.locate(64 + 17);
+  sequencer.continuePlayback();
+  notes.clear();
+  playSequencer(sequencer, s, &notes);
+  CHECK( notes.size() == 1 && isStep(notes[0], 1, 1) && sequencer.getSongPosition() == 0 );
+  sequencer.locate(63);
+  sequencer.continuePlayback();
+  notes.clear();
+  playSequencer(sequencer, 2*s, &notes);
+  CHECK( notes.size() == 2 && isStep(notes[0], 3, 15) && isStep(notes[1], 1, 0) );
+  CHECK( sequencer.getSongPosition() == 0 );
+
+  // stop and continue go on with the step after the last one played:
+  sequencer.stop();
+  CHECK( !sequencer.isRunning() && sequencer.getNote() == NULL );
+  sequencer.continuePlayback();
+  notes.clear();
+  playSequencer(sequencer, s, &notes);
+  CHECK( notes.size() == 1 && isStep(notes[0], 1, 1) );
+
+  // without song mode, the sequencer stays on the pattern that is playing (from the next
+  // pattern boundary on, untransposed), and locate counts within that pattern:
+  sequencer.locate(44);
+  sequencer.continuePlayback();
+  playSequencer(sequencer, s);
+  CHECK( sequencer.getSongPosition() == 1 );
+  sequencer.setSongMode(false);
+  notes.clear();
+  playSequencer(sequencer, 6*s, &notes);
+  CHECK( notes.size() == 6 && isStep(notes[2], 2, 15, 3) && isStep(notes[3], 2, 0) );
+  CHECK( isStep(notes[5], 2, 2) );
+  sequencer.stop();
+  sequencer.locate(16 + 5);
+  sequencer.continuePlayback();
+  notes.clear();
+  playSequencer(sequencer, s, &notes);
+  CHECK( notes.size() == 1 && isStep(notes[0], 2, 5) );
+}
+
+//-------------------------------------------------------------------------------------------------
+// the suites:
+
+struct Suite
+{
+  const char *name;
+  void (*run)();
+};
+
+static const Suite suites[] =
+{
+  { "MidiParser",    testMidiParser },
+  { "MidiClockSync", testMidiClockSync },
+  { "MidiOutBuffer", testMidiOutBuffer },
+  { "LatencyController", testLatencyController },
+  { "Open303CCMap",  testOpen303CCMap },
+  { "SequencerTiming", testSequencerTiming },
+  { "SequencerSong", testSequencerSong },
+};
+static const int numSuites = sizeof(suites) / sizeof(suites[0]);
+
+int main(int argc, char **argv)
+{
+  if( argc == 2 && !strcmp(argv[1], "--list") )
+  {
+    for(int s=0; s<numSuites; s++)
+      printf("%s\n", suites[s].name);
+    return 0;
+  }
+
+  int numSuitesRun = 0, numSuitesFailed = 0;
+  for(int s=0; s<numSuites; s++)
+  {
+    bool selected = argc < 2;
+    for(int i=1; i<argc; i++)
+      selected |= !strcmp(argv[i], suites[s].name);
+    if( !selected )
+      continue;
+    numChecks = 0;
+    numFailed = 0;
+    suites[s].run();
+    printf("%s %-20s %d of %d checks passed\n", numFailed == 0 ? "PASS" : "FAIL", suites[s].name,
+      numChecks - numFailed, numChecks);
+    numSuitesRun++;
+    numSuitesFailed += numFailed > 0;
+  }
+  if( numSuitesRun == 0 )
+  {
+    fprintf(stderr, "usage: unit_test [--list] [SUITE...]\n");
+    return 1;
+  }
+  printf("%d of %d suites passed\n", numSuitesRun - numSuitesFailed, numSuitesRun);
+  return numSuitesFailed > 0 ? 1 : 0;
+}
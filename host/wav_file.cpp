@@ -0,0 +1,104 @@
+// Minimal WAV file support for the host tools - see wav_file.h.
+
+#include <string.h>
+
+#include "wav_file.h"
+
+static uint32_t getWav16(const unsigned char *p) { return p[0] | p[1] << 8; }
+static uint32_t getWav32(const unsigned char *p) { return getWav16(p) | getWav16(p+2) << 16; }
+
+bool writeWavHeader(FILE *f, int numChannels, int bits, int sampleRate, long numFrames)
+{
+  int bytesPerFrame = numChannels * bits/8;
+  uint32_t dataSize = (uint32_t) (numFrames * bytesPerFrame);
+  unsigned char h[44];
+  memcpy(h, "RIFF", 4);  putWav32(h+4, 36 + dataSize);  memcpy(h+8, "WAVE", 4);
+  memcpy(h+12, "fmt ", 4);
+  putWav32(h+16, 16);
+  putWav16(h+20, bits == 32 ? 3 : 1);   // IEEE float or PCM
+  putWav16(h+22, numChannels);
+  putWav32(h+24, sampleRate);
+  putWav32(h+28, sampleRate * bytesPerFrame);
+  putWav16(h+32, bytesPerFrame);
+  putWav16(h+34, bits);
+  memcpy(h+36, "data", 4);  putWav32(h+40, dataSize);
+  return fwrite(h, sizeof(h), 1, f) == 1;
+}
+
+bool writeWavFloat(const char *path, const float *samples, int numChannels, int sampleRate,
+  long numFrames)
+{
+  FILE *f = fopen(path, "wb");
+  bool ok = f != NULL && writeWavHeader(f, numChannels, 32, sampleRate, numFrames);
+  unsigned char bytes[4];
+  for(long n=0; ok && n<numFrames*numChannels; n++)
+  {
+    uint32_t x;
+    memcpy(&x, &samples[n], 4);
+    putWav32(bytes, x);
+    ok = fwrite(bytes, 4, 1, f) == 1;
+  }
+  if( f != NULL && fclose(f) != 0 )
+    ok = false;
+  if( !ok )
+    perror(path);
+  return ok;
+}
+
+bool readWavFloat(const char *path, std::vector<float> &samples, int &numChannels,
+  int &sampleRate)
+{
+  FILE *f = fopen(path, "rb");
+  if( f == NULL )
+  {
+    perror(path);
+    return false;
+  }
+  std::vector<unsigned char> file;
+  unsigned char buffer[65536];
+  size_t n;
+  while( (n = fread(buffer, 1, sizeof(buffer), f)) > 0 )
+    file.insert(file.end(), buffer, buffer+n);
+  fclose(f);
+
+  // walk the chunks for the format and the data:
+  bool isFloat = false;
+  numChannels  = 0;
+  const unsigned char *data = NULL;
+  uint32_t dataSize = 0;
+  if( file.size() >= 12 && !memcmp(&file[0], "RIFF", 4) && !memcmp(&file[8], "WAVE", 4) )
+  {
+    size_t pos = 12;
+    while( pos + 8 <= file.size() )
+    {
+      uint32_t size = getWav32(&file[pos+4]);
+      if( size > file.size() - pos - 8 )
+        break;
+      if( !memcmp(&file[pos], "fmt ", 4) && size >= 16 )
+      {
+        isFloat     = getWav16(&file[pos+8]) == 3 && getWav16(&file[pos+22]) == 32;
+        numChannels = getWav16(&file[pos+10]);
+        sampleRate  = getWav32(&file[pos+12]);
+      }
+      else if( !memcmp(&file[pos], "data", 4) )
+      {
+        data     = &file[pos+8];
+        dataSize = size;
+      }
+      pos += 8 + size + (size & 1);
+    }
+  }
+  if( !isFloat || numChannels < 1 || data == NULL )
+  {
+    fprintf(stderr, "%s: not a 32 bit float WAV file\n", path);
+    return false;
+  }
+
+  samples.resize(dataSize / 4);
+  for(size_t i=0; i<samples.size(); i++)
+  {
+    uint32_t x = getWav32(data + 4*i);
+    memcpy(&samples[i], &x, 4);
+  }
+  return true;
+}
@@ -0,0 +1,27 @@
+// Minimal WAV file support for the host tools: 16 and 24 bit PCM and 32 bit float, little endian.
+
+#ifndef wav_file_h
+#define wav_file_h
+
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+
+inline void putWav16(unsigned char *p, uint32_t x) { p[0] = x; p[1] = x >> 8; }
+inline void putWav32(unsigned char *p, uint32_t x) { putWav16(p, x); putWav16(p+2, x >> 16); }
+
+/** Writes the header of a WAV file with the given format (bits 32 is float) and length, the
+samples follow interleaved. Returns false on a write error. */
+bool writeWavHeader(FILE *f, int numChannels, int bits, int sampleRate, long numFrames);
+
+/** Writes a float WAV file from interleaved samples. Returns false (and reports on stderr) on
+errors. */
+bool writeWavFloat(const char *path, const float *samples, int numChannels, int sampleRate,
+  long numFrames);
+
+/** Reads a float WAV file into interleaved samples. Returns false (and reports on stderr), if the
+file can't be read or is not a float WAV file. */
+bool readWavFloat(const char *path, std::vector<float> &samples, int &numChannels,
+  int &sampleRate);
+
+#endif